@@ -41,6 +41,8 @@
 #include "stdr_gui/stdr_map_metainformation/stdr_gui_rfid_tag.h"
 
 #include <stdr_robot/handle_robot.h>
+#include <stdr_msgs/source_delta.h>
+#include <stdr_robot/sensors/source_sequence.h>
 
 /**
 @namespace stdr_gui
@@ -111,6 +113,13 @@ namespace stdr_gui
       stdr_msgs::SoundSourceVector sound_source_pure_;
       //!< Sound sources in the environment
       std::map<QString,CGuiSoundSource> sound_sources_;
+      //!< The source changes applied so far
+      stdr_robot::SourceSequence rfid_tags_sequence_;
+      stdr_robot::SourceSequence co2_sources_sequence_;
+      stdr_robot::SourceSequence thermal_sources_sequence_;
+      stdr_robot::SourceSequence sound_sources_sequence_;
+      //!< True when the sources must be passed to the robots again
+      bool sources_changed_;
       
       //!< ROS subscriber for occupancy grid map
       ros::Subscriber map_subscriber_;
@@ -239,32 +248,32 @@ namespace stdr_gui
       void receiveMap(const nav_msgs::OccupancyGrid& msg);
       
       /**
-      @brief Receives the existent rfid tags
-      @param msg [const stdr_msgs::RfidTagVector&] The rfid tags message
+      @brief Applies a change of the existent rfid tags
+      @param msg [const stdr_msgs::RfidTagDelta&] The rfid tags change
       @return void
       **/
-      void receiveRfids(const stdr_msgs::RfidTagVector& msg);
+      void receiveRfids(const stdr_msgs::RfidTagDelta& msg);
       
       /**
-      @brief Receives the existent co2 sources
-      @param msg [const stdr_msgs::CO2SourceVector&] The CO2 source message
+      @brief Applies a change of the existent co2 sources
+      @param msg [const stdr_msgs::CO2SourceDelta&] The CO2 sources change
       @return void
       **/
-      void receiveCO2Sources(const stdr_msgs::CO2SourceVector& msg);
+      void receiveCO2Sources(const stdr_msgs::CO2SourceDelta& msg);
       
       /**
-      @brief Receives the existent thermal sources
-      @param msg [const stdr_msgs::ThermalSourceVector&] The thermal source message
+      @brief Applies a change of the existent thermal sources
+      @param msg [const stdr_msgs::ThermalSourceDelta&] The thermal sources change
       @return void
       **/
-      void receiveThermalSources(const stdr_msgs::ThermalSourceVector& msg);
+      void receiveThermalSources(const stdr_msgs::ThermalSourceDelta& msg);
       
       /**
-      @brief Receives the existent sound sources
-      @param msg [const stdr_msgs::SoundSourceVector&] The sound source message
+      @brief Applies a change of the existent sound sources
+      @param msg [const stdr_msgs::SoundSourceDelta&] The sound sources change
       @return void
       **/
-      void receiveSoundSources(const stdr_msgs::SoundSourceVector& msg);
+      void receiveSoundSources(const stdr_msgs::SoundSourceDelta& msg);
       
       /**
       @brief Receives the robots from stdr_server. Connects to "stdr_server/active_robots" ROS topic
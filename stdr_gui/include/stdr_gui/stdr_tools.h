@@ -71,18 +71,22 @@
 #include <stdr_msgs/Noise.h>
 
 #include <stdr_msgs/RfidTagVector.h>
+#include <stdr_msgs/RfidTagDelta.h>
 #include <stdr_msgs/AddRfidTag.h>
 #include <stdr_msgs/DeleteRfidTag.h>
 
 #include <stdr_msgs/CO2SourceVector.h>
+#include <stdr_msgs/CO2SourceDelta.h>
 #include <stdr_msgs/AddCO2Source.h>
 #include <stdr_msgs/DeleteCO2Source.h>
 
 #include <stdr_msgs/ThermalSourceVector.h>
+#include <stdr_msgs/ThermalSourceDelta.h>
 #include <stdr_msgs/AddThermalSource.h>
 #include <stdr_msgs/DeleteThermalSource.h>
 
 #include <stdr_msgs/SoundSourceVector.h>
+#include <stdr_msgs/SoundSourceDelta.h>
 #include <stdr_msgs/AddSoundSource.h>
 #include <stdr_msgs/DeleteSoundSource.h>
 
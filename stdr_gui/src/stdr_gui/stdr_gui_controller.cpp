@@ -53,6 +53,8 @@ namespace stdr_gui
     map_lock_ = false;
     map_initialized_ = false;
     
+    sources_changed_ = false;
+    
     icon_move_.addFile(QString::fromUtf8((
       stdr_gui_tools::getRosPackagePath("stdr_gui") + 
       std::string("/resources/images/arrow_move.png")).c_str()), 
@@ -88,8 +90,8 @@ namespace stdr_gui
       
     //!< Rfid related
     rfids_subscriber_ = n_.subscribe(
-      "stdr_server/rfid_list", 
-      1, 
+      "stdr_server/rfid_delta", 
+      SOURCE_DELTA_QUEUE, 
       &CGuiController::receiveRfids,
       this);
     new_rfid_tag_client_ = 
@@ -99,8 +101,8 @@ namespace stdr_gui
     
     //!< CO2 related  
     co2_sources_subscriber_ = n_.subscribe(
-      "stdr_server/co2_sources_list", 
-      1, 
+      "stdr_server/co2_sources_delta", 
+      SOURCE_DELTA_QUEUE, 
       &CGuiController::receiveCO2Sources,
       this);
     new_co2_source_client_ = 
@@ -111,8 +113,8 @@ namespace stdr_gui
     
     //!< Thermal related  
     thermal_sources_subscriber_ = n_.subscribe(
-      "stdr_server/thermal_sources_list", 
-      1, 
+      "stdr_server/thermal_sources_delta", 
+      SOURCE_DELTA_QUEUE, 
       &CGuiController::receiveThermalSources,
       this);
     new_thermal_source_client_ = 
@@ -124,8 +126,8 @@ namespace stdr_gui
     
     //!< Sound related  
     sound_sources_subscriber_ = n_.subscribe(
-      "stdr_server/sound_sources_list", 
-      1, 
+      "stdr_server/sound_sources_delta", 
+      SOURCE_DELTA_QUEUE, 
       &CGuiController::receiveSoundSources,
       this);
     new_sound_source_client_ = 
@@ -360,112 +362,275 @@ namespace stdr_gui
   }
 
   /**
-  @brief Receives the existent rfid tags
+  @brief Applies a change of the existent rfid tags
   **/
-  void CGuiController::receiveRfids(const stdr_msgs::RfidTagVector& msg)
+  void CGuiController::receiveRfids(const stdr_msgs::RfidTagDelta& msg)
   {
-    rfid_tag_pure_ = msg;
-    rfid_tags_.clear();
-    for(unsigned int i = 0 ; i < msg.rfid_tags.size() ; i++)
+    const stdr_robot::SourceSequence::Action action = 
+      rfid_tags_sequence_.receive(msg);
+    if(action == stdr_robot::SourceSequence::SKIP)
+    {
+      return; //!< Already applied or waiting for a snapshot
+    }
+    if(action == stdr_robot::SourceSequence::RESYNC)
+    { //!< Changes were dropped, connect again to get a snapshot
+      rfids_subscriber_.shutdown();
+      rfids_subscriber_ = n_.subscribe(
+        "stdr_server/rfid_delta", 
+        SOURCE_DELTA_QUEUE, 
+        &CGuiController::receiveRfids,
+        this);
+      return;
+    }
+    
+    while(map_lock_)
+    {
+      usleep(100);
+    }
+    map_lock_ = true;
+    
+    std::vector<stdr_msgs::RfidTag>& pure = rfid_tag_pure_.rfid_tags;
+    if(msg.snapshot)
+    {
+      pure.clear();
+      rfid_tags_.clear();
+    }
+    for(unsigned int i = 0 ; i < msg.removed.size() ; i++)
     {
-      QPoint p(msg.rfid_tags[i].pose.x / map_msg_.info.resolution,
-        msg.rfid_tags[i].pose.y / map_msg_.info.resolution);
+      rfid_tags_.erase(QString(msg.removed[i].c_str()));
+      for(unsigned int j = 0 ; j < pure.size() ; j++)
+      {
+        if(pure[j].tag_id == msg.removed[i])
+        {
+          pure[j] = pure.back();
+          pure.pop_back();
+          break;
+        }
+      }
+    }
+    for(unsigned int i = 0 ; i < msg.added.size() ; i++)
+    {
+      QPoint p(msg.added[i].pose.x / map_msg_.info.resolution,
+        msg.added[i].pose.y / map_msg_.info.resolution);
       
-      CGuiRfidTag temp_tag(p, msg.rfid_tags[i].tag_id, 
+      CGuiRfidTag temp_tag(p, msg.added[i].tag_id, 
         map_msg_.info.resolution);
       
-      temp_tag.setMessage(QString(msg.rfid_tags[i].message.c_str()));
+      temp_tag.setMessage(QString(msg.added[i].message.c_str()));
       
       rfid_tags_.insert(std::pair<QString, CGuiRfidTag>(
         QString(temp_tag.getName().c_str()), temp_tag));
+      pure.push_back(msg.added[i]);
     }
-    for(unsigned int i = 0 ; i < registered_robots_.size() ; i++)
-    {
-      registered_robots_[i].setEnvironmentalTags(rfid_tag_pure_);
-    }
+    
+    //!< The robots get the new list on the next map update
+    sources_changed_ = true;
+    map_lock_ = false;
   }
   
   /**
-  @brief Receives the existent co2 sources
+  @brief Applies a change of the existent co2 sources
   **/
-  void CGuiController::receiveCO2Sources(const stdr_msgs::CO2SourceVector& msg)
+  void CGuiController::receiveCO2Sources(const stdr_msgs::CO2SourceDelta& msg)
   {
-    co2_source_pure_ = msg;
-    co2_sources_.clear();
-    for(unsigned int i = 0 ; i < msg.co2_sources.size() ; i++)
+    const stdr_robot::SourceSequence::Action action = 
+      co2_sources_sequence_.receive(msg);
+    if(action == stdr_robot::SourceSequence::SKIP)
+    {
+      return; //!< Already applied or waiting for a snapshot
+    }
+    if(action == stdr_robot::SourceSequence::RESYNC)
+    { //!< Changes were dropped, connect again to get a snapshot
+      co2_sources_subscriber_.shutdown();
+      co2_sources_subscriber_ = n_.subscribe(
+        "stdr_server/co2_sources_delta", 
+        SOURCE_DELTA_QUEUE, 
+        &CGuiController::receiveCO2Sources,
+        this);
+      return;
+    }
+    
+    while(map_lock_)
+    {
+      usleep(100);
+    }
+    map_lock_ = true;
+    
+    std::vector<stdr_msgs::CO2Source>& pure = co2_source_pure_.co2_sources;
+    if(msg.snapshot)
+    {
+      pure.clear();
+      co2_sources_.clear();
+    }
+    for(unsigned int i = 0 ; i < msg.removed.size() ; i++)
     {
-      QPoint p(msg.co2_sources[i].pose.x / map_msg_.info.resolution,
-        msg.co2_sources[i].pose.y / map_msg_.info.resolution);
+      co2_sources_.erase(QString(msg.removed[i].c_str()));
+      for(unsigned int j = 0 ; j < pure.size() ; j++)
+      {
+        if(pure[j].id == msg.removed[i])
+        {
+          pure[j] = pure.back();
+          pure.pop_back();
+          break;
+        }
+      }
+    }
+    for(unsigned int i = 0 ; i < msg.added.size() ; i++)
+    {
+      QPoint p(msg.added[i].pose.x / map_msg_.info.resolution,
+        msg.added[i].pose.y / map_msg_.info.resolution);
       
-      CGuiCo2Source temp_source(p, msg.co2_sources[i].id, 
+      CGuiCo2Source temp_source(p, msg.added[i].id, 
         map_msg_.info.resolution);
       
-      temp_source.setPpm(msg.co2_sources[i].ppm);
+      temp_source.setPpm(msg.added[i].ppm);
       
       co2_sources_.insert(std::pair<QString, CGuiCo2Source>(
         QString(temp_source.getName().c_str()), temp_source));
+      pure.push_back(msg.added[i]);
     }
-    for(unsigned int i = 0 ; i < registered_robots_.size() ; i++)
-    {
-      registered_robots_[i].setEnvironmentalCO2Sources(co2_source_pure_);
-    }
+    
+    //!< The robots get the new list on the next map update
+    sources_changed_ = true;
+    map_lock_ = false;
   }
   
   /**
-  @brief Receives the existent thermal sources
+  @brief Applies a change of the existent thermal sources
   **/
   void CGuiController::receiveThermalSources
-    (const stdr_msgs::ThermalSourceVector& msg)
+    (const stdr_msgs::ThermalSourceDelta& msg)
   {
-    thermal_source_pure_ = msg;
-    thermal_sources_.clear();
-    for(unsigned int i = 0 ; i < msg.thermal_sources.size() ; i++)
+    const stdr_robot::SourceSequence::Action action = 
+      thermal_sources_sequence_.receive(msg);
+    if(action == stdr_robot::SourceSequence::SKIP)
+    {
+      return; //!< Already applied or waiting for a snapshot
+    }
+    if(action == stdr_robot::SourceSequence::RESYNC)
+    { //!< Changes were dropped, connect again to get a snapshot
+      thermal_sources_subscriber_.shutdown();
+      thermal_sources_subscriber_ = n_.subscribe(
+        "stdr_server/thermal_sources_delta", 
+        SOURCE_DELTA_QUEUE, 
+        &CGuiController::receiveThermalSources,
+        this);
+      return;
+    }
+    
+    while(map_lock_)
+    {
+      usleep(100);
+    }
+    map_lock_ = true;
+    
+    std::vector<stdr_msgs::ThermalSource>& pure = 
+      thermal_source_pure_.thermal_sources;
+    if(msg.snapshot)
+    {
+      pure.clear();
+      thermal_sources_.clear();
+    }
+    for(unsigned int i = 0 ; i < msg.removed.size() ; i++)
+    {
+      thermal_sources_.erase(QString(msg.removed[i].c_str()));
+      for(unsigned int j = 0 ; j < pure.size() ; j++)
+      {
+        if(pure[j].id == msg.removed[i])
+        {
+          pure[j] = pure.back();
+          pure.pop_back();
+          break;
+        }
+      }
+    }
+    for(unsigned int i = 0 ; i < msg.added.size() ; i++)
     {
-      QPoint p(msg.thermal_sources[i].pose.x / map_msg_.info.resolution,
-        msg.thermal_sources[i].pose.y / map_msg_.info.resolution);
+      QPoint p(msg.added[i].pose.x / map_msg_.info.resolution,
+        msg.added[i].pose.y / map_msg_.info.resolution);
       
-      CGuiThermalSource temp_source(p, msg.thermal_sources[i].id, 
+      CGuiThermalSource temp_source(p, msg.added[i].id, 
         map_msg_.info.resolution);
       
-      temp_source.setDegrees(msg.thermal_sources[i].degrees);
+      temp_source.setDegrees(msg.added[i].degrees);
       
       thermal_sources_.insert(std::pair<QString, CGuiThermalSource>(
         QString(temp_source.getName().c_str()), temp_source));
+      pure.push_back(msg.added[i]);
     }
-    for(unsigned int i = 0 ; i < registered_robots_.size() ; i++)
-    {
-      registered_robots_[i].setEnvironmentalThermalSources(
-        thermal_source_pure_);
-    }
+    
+    //!< The robots get the new list on the next map update
+    sources_changed_ = true;
+    map_lock_ = false;
   }
   
   /**
-  @brief Receives the existent sound sources
+  @brief Applies a change of the existent sound sources
   **/
   void CGuiController::receiveSoundSources
-    (const stdr_msgs::SoundSourceVector& msg)
+    (const stdr_msgs::SoundSourceDelta& msg)
   {
-    sound_source_pure_ = msg;
-    sound_sources_.clear();
-    for(unsigned int i = 0 ; i < msg.sound_sources.size() ; i++)
+    const stdr_robot::SourceSequence::Action action = 
+      sound_sources_sequence_.receive(msg);
+    if(action == stdr_robot::SourceSequence::SKIP)
+    {
+      return; //!< Already applied or waiting for a snapshot
+    }
+    if(action == stdr_robot::SourceSequence::RESYNC)
+    { //!< Changes were dropped, connect again to get a snapshot
+      sound_sources_subscriber_.shutdown();
+      sound_sources_subscriber_ = n_.subscribe(
+        "stdr_server/sound_sources_delta", 
+        SOURCE_DELTA_QUEUE, 
+        &CGuiController::receiveSoundSources,
+        this);
+      return;
+    }
+    
+    while(map_lock_)
+    {
+      usleep(100);
+    }
+    map_lock_ = true;
+    
+    std::vector<stdr_msgs::SoundSource>& pure = 
+      sound_source_pure_.sound_sources;
+    if(msg.snapshot)
     {
-      QPoint p(msg.sound_sources[i].pose.x / map_msg_.info.resolution,
-        msg.sound_sources[i].pose.y / map_msg_.info.resolution);
+      pure.clear();
+      sound_sources_.clear();
+    }
+    for(unsigned int i = 0 ; i < msg.removed.size() ; i++)
+    {
+      sound_sources_.erase(QString(msg.removed[i].c_str()));
+      for(unsigned int j = 0 ; j < pure.size() ; j++)
+      {
+        if(pure[j].id == msg.removed[i])
+        {
+          pure[j] = pure.back();
+          pure.pop_back();
+          break;
+        }
+      }
+    }
+    for(unsigned int i = 0 ; i < msg.added.size() ; i++)
+    {
+      QPoint p(msg.added[i].pose.x / map_msg_.info.resolution,
+        msg.added[i].pose.y / map_msg_.info.resolution);
       
-      CGuiSoundSource temp_source(p, msg.sound_sources[i].id, 
+      CGuiSoundSource temp_source(p, msg.added[i].id, 
         map_msg_.info.resolution);
       
-      //~ temp_source.setMessage(QString(msg.rfid_tags[i].message.c_str()));
-      
       sound_sources_.insert(std::pair<QString, CGuiSoundSource>(
         QString(temp_source.getName().c_str()), temp_source));
+      pure.push_back(msg.added[i]);
     }
-    for(unsigned int i = 0 ; i < registered_robots_.size() ; i++)
-    {
-      registered_robots_[i].setEnvironmentalSoundSources(sound_source_pure_);
-    }
+    
+    //!< The robots get the new list on the next map update
+    sources_changed_ = true;
+    map_lock_ = false;
   }
-
+  
   /**
   @brief Receives the occupancy grid map from stdr_server. Connects to "map" \
   ROS topic
@@ -1012,6 +1177,20 @@ namespace stdr_gui
     map_lock_ = true;
     running_map_ = initial_map_;
     
+    if(sources_changed_)
+    {
+      for(unsigned int i = 0 ; i < registered_robots_.size() ; i++)
+      {
+        registered_robots_[i].setEnvironmentalTags(rfid_tag_pure_);
+        registered_robots_[i].setEnvironmentalCO2Sources(co2_source_pure_);
+        registered_robots_[i].setEnvironmentalThermalSources(
+          thermal_source_pure_);
+        registered_robots_[i].setEnvironmentalSoundSources(
+          sound_source_pure_);
+      }
+      sources_changed_ = false;
+    }
+    
     if(gui_connector_.isGridEnabled())
       map_connector_.drawGrid(&running_map_, map_msg_.info.resolution);
     
@@ -0,0 +1,302 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef BATCH_SIMULATOR_H
+#define BATCH_SIMULATOR_H
+
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <stdr_msgs/RobotMsg.h>
+#include <stdr_robot/map_store.h>
+#include <stdr_robot/collision_checker.h>
+#include <stdr_robot/sensors/beam_table.h>
+#include <stdr_robot/sensors/range_noise.h>
+#include <stdr_robot/sensors/work_stealing_pool.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @struct BatchSimulatorConfig
+  @brief The settings of a BatchSimulator. The batch simulator reads no \
+  ROS parameters, its users set these instead.
+  **/
+  struct BatchSimulatorConfig {
+
+    /**
+    @brief Default constructor. Same defaults as the ROS parameters of \
+    the nodelets.
+    @return void
+    **/
+    BatchSimulatorConfig(void)
+      :
+        threads(0),
+        occupancyThreshold(70),
+        maxDistanceTransformCells(4096 * 4096),
+        noiseSeed(0),
+        rangeDropoutProbability(0),
+        rangeMaxReturnProbability(0)
+    {
+    }
+
+    //!< Worker threads stepping the robots, zero for the calling thread
+    unsigned int threads;
+    //!< Map cells with larger values are occupied
+    int occupancyThreshold;
+    //!< Larger maps are traced on the occupancy pyramid only
+    int maxDistanceTransformCells;
+    //!< Seed of the laser noise of all robots
+    uint64_t noiseSeed;
+    //!< Probability of a dropped laser return
+    double rangeDropoutProbability;
+    //!< Probability of a max range laser return
+    double rangeMaxReturnProbability;
+  };
+
+  /**
+  @class BatchSimulator
+  @brief Headless simulation of many independent robots, without ROS \
+  topics, actions or timers. Every robot is an environment of its own: it \
+  has its own map and does not see the other robots. Robot states are \
+  kept in struct of arrays form. Each step() takes one velocity command \
+  per robot and integrates the kinematic models of all robots in one \
+  vectorized pass, then resolves the map collisions and traces the lasers \
+  of every robot, in parallel chunks of robots. Runs without a ROS \
+  master.
+  **/
+  class BatchSimulator {
+
+    public:
+
+      /**
+      @brief Default constructor
+      @param config [const BatchSimulatorConfig&] The simulator settings
+      @return void
+      **/
+      explicit BatchSimulator(const BatchSimulatorConfig& config);
+
+      /**
+      @brief Builds the shared map of a map message with the map settings \
+      of the simulator, for addRobot()
+      @param grid [const nav_msgs::OccupancyGridConstPtr&] The map message
+      @return SharedMapConstPtr
+      **/
+      SharedMapConstPtr loadMap(
+        const nav_msgs::OccupancyGridConstPtr& grid) const;
+
+      /**
+      @brief Adds a robot at its initial pose. Motion noise and the \
+      sensors other than lasers of the description are not simulated.
+      @param map [const SharedMapConstPtr&] The map of the robot
+      @param description [const stdr_msgs::RobotMsg&] The robot description
+      @return unsigned int : The robot index
+      **/
+      unsigned int addRobot(const SharedMapConstPtr& map,
+        const stdr_msgs::RobotMsg& description);
+
+      /**
+      @brief Returns the number of robots
+      @return unsigned int
+      **/
+      inline unsigned int getRobotCount(void) const
+      {
+        return _x.size();
+      }
+
+      /**
+      @brief Moves a robot, e.g. to reset an episode. Does not check for \
+      collisions.
+      @param robot [unsigned int] The robot index
+      @param pose [const geometry_msgs::Pose2D&] The new pose
+      @return void
+      **/
+      void setPose(unsigned int robot, const geometry_msgs::Pose2D& pose);
+
+      /**
+      @brief Advances all robots by one time step and traces their lasers
+      @param linear [const float*] Forward velocity command of every robot
+      @param lateral [const float*] Lateral velocity command of every \
+      robot, used by omni robots only
+      @param angular [const float*] Angular velocity command of every robot
+      @param dt [float] The time step in seconds
+      @return void
+      **/
+      void step(const float* linear, const float* lateral,
+        const float* angular, float dt);
+
+      /**
+      @brief Returns the x coordinates of the robots
+      @return const std::vector<float>&
+      **/
+      inline const std::vector<float>& getX(void) const
+      {
+        return _x;
+      }
+
+      /**
+      @brief Returns the y coordinates of the robots
+      @return const std::vector<float>&
+      **/
+      inline const std::vector<float>& getY(void) const
+      {
+        return _y;
+      }
+
+      /**
+      @brief Returns the orientations of the robots
+      @return const std::vector<float>&
+      **/
+      inline const std::vector<float>& getTheta(void) const
+      {
+        return _theta;
+      }
+
+      /**
+      @brief Returns 1 for the robots whose last step was stopped by a \
+      collision, 0 for the others
+      @return const std::vector<uint8_t>&
+      **/
+      inline const std::vector<uint8_t>& getCollisions(void) const
+      {
+        return _collisions;
+      }
+
+      /**
+      @brief Returns the laser ranges of all robots, in robot order and \
+      laser order within a robot. Ranges follow sensor_msgs::LaserScan.
+      @return const std::vector<float>&
+      **/
+      inline const std::vector<float>& getRanges(void) const
+      {
+        return _ranges;
+      }
+
+      /**
+      @brief Returns the index of the first range of a robot in getRanges()
+      @param robot [unsigned int] The robot index
+      @return unsigned int
+      **/
+      inline unsigned int getRangesOffset(unsigned int robot) const
+      {
+        return _rangesOffsets[robot];
+      }
+
+      /**
+      @brief Returns the number of ranges of a robot, of all its lasers
+      @param robot [unsigned int] The robot index
+      @return unsigned int
+      **/
+      inline unsigned int getRangesCount(unsigned int robot) const
+      {
+        return _rangesOffsets[robot + 1] - _rangesOffsets[robot];
+      }
+
+    private:
+
+      /**
+      @struct BatchLaser
+      @brief A laser of a robot
+      **/
+      struct BatchLaser {
+        //!< Laser pose relative to the robot
+        geometry_msgs::Pose2D pose;
+        //!< Beam directions of the laser
+        BeamTable beams;
+        //!< Minimum range in meters
+        float minRange;
+        //!< Maximum range in meters
+        float maxRange;
+        //!< Noise of the laser ranges
+        boost::shared_ptr<RangeNoise> noise;
+        //!< Random numbers of the noise, seeded by the noise seed, the robot
+        //!< index and the laser frame id
+        boost::shared_ptr<NoiseEngine> engine;
+      };
+
+      /**
+      @brief Resolves the collisions of the motion of a chunk of robots \
+      and traces their lasers
+      @param begin [unsigned int] The first robot
+      @param end [unsigned int] One past the last robot
+      @return void
+      **/
+      void stepRobots(unsigned int begin, unsigned int end);
+
+      /**
+      @brief Traces the lasers of a robot at its current pose
+      @param robot [unsigned int] The robot index
+      @return void
+      **/
+      void traceLasers(unsigned int robot);
+
+    private:
+
+      //!< Robots stepped by one task
+      static const unsigned int CHUNK_SIZE;
+
+      //!< The simulator settings
+      BatchSimulatorConfig _config;
+
+      //!< Robot x coordinates
+      std::vector<float> _x;
+      //!< Robot y coordinates
+      std::vector<float> _y;
+      //!< Robot orientations
+      std::vector<float> _theta;
+      //!< Collision flags of the last step
+      std::vector<uint8_t> _collisions;
+      //!< Robot poses before the step in progress
+      std::vector<float> _previousX;
+      std::vector<float> _previousY;
+      std::vector<float> _previousTheta;
+      //!< 1 for omni robots, 0 for ideal ones
+      std::vector<float> _omni;
+      //!< The lateral commands of the step in progress, zero for ideal
+      //!< robots
+      std::vector<float> _lateralCommands;
+      //!< Robot maps
+      std::vector<SharedMapConstPtr> _maps;
+      //!< Robot footprint checkers
+      std::vector<CollisionChecker> _collisionCheckers;
+
+      //!< The lasers of all robots, in robot order
+      std::vector<BatchLaser> _lasers;
+      //!< Index of the first laser of every robot, plus the laser count
+      std::vector<unsigned int> _laserOffsets;
+      //!< The ranges of all lasers
+      std::vector<float> _ranges;
+      //!< Index of the first range of every robot, plus the range count
+      std::vector<unsigned int> _rangesOffsets;
+
+      //!< One task per chunk of robots
+      std::vector<WorkStealingPool::Task> _tasks;
+      //!< The pool stepping the chunks
+      boost::scoped_ptr<WorkStealingPool> _pool;
+  };
+
+}
+
+#endif
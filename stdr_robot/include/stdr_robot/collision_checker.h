@@ -0,0 +1,239 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef COLLISION_CHECKER_H
+#define COLLISION_CHECKER_H
+
+#include <vector>
+#include <geometry_msgs/Pose2D.h>
+#include <stdr_msgs/FootprintMsg.h>
+#include <stdr_robot/map_store.h>
+#include <stdr_robot/footprint_raster.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @struct Contact
+  @brief The first contact of a swept motion
+  **/
+  struct Contact {
+    //!< Fraction of the motion done before the contact, 1 without contact
+    double time;
+    //!< Unit normal of the contact, pointing away from the obstacle
+    double normalX;
+    double normalY;
+  };
+
+  /**
+  @class CollisionChecker
+  @brief Checks a robot footprint against the occupied cells of a map. \
+  Motion is swept as a whole and reports the time of impact and the \
+  contact normal. Polygonal footprints are swept with the FootprintRaster \
+  of the interpolated heading. Circular footprints are checked against \
+  the distance transform of the map instead, when the map has one. A \
+  robot already touching an obstacle may move away from it or along it, \
+  and is still swept against the obstacles it does not touch yet.
+  **/
+  class CollisionChecker {
+
+    public:
+
+      /**
+      @brief Default constructor
+      @param footprint [const stdr_msgs::FootprintMsg&] The robot footprint. \
+      Without points, a circle of the footprint radius is used.
+      @return void
+      **/
+      explicit CollisionChecker(const stdr_msgs::FootprintMsg& footprint);
+
+      /**
+      @brief Sweeps the robot from the previous pose to the new pose
+      @param map [const SharedMap&] The map
+      @param newPose [const geometry_msgs::Pose2D&] The new robot pose
+      @param previousPose [const geometry_msgs::Pose2D&] The previous pose
+      @return Contact : The first contact along the motion
+      **/
+      Contact sweep(
+        const SharedMap& map,
+        const geometry_msgs::Pose2D& newPose,
+        const geometry_msgs::Pose2D& previousPose);
+
+      /**
+      @brief Checks the robot collision along the motion from the previous \
+      pose to the new pose
+      @param map [const SharedMap&] The map
+      @param newPose [const geometry_msgs::Pose2D&] The new robot pose
+      @param previousPose [const geometry_msgs::Pose2D&] The previous pose
+      @return True on collision
+      **/
+      inline bool collisionExists(
+        const SharedMap& map,
+        const geometry_msgs::Pose2D& newPose,
+        const geometry_msgs::Pose2D& previousPose)
+      {
+        return sweep(map, newPose, previousPose).time < 1;
+      }
+
+      /**
+      @brief Checks the robot collision at a pose
+      @param map [const SharedMap&] The map
+      @param newPose [const geometry_msgs::Pose2D&] The robot pose
+      @return True on collision
+      **/
+      bool collisionExistsNoPath(
+        const SharedMap& map,
+        const geometry_msgs::Pose2D& newPose) const;
+
+      /**
+      @brief Returns a pose part of the way between two poses
+      @param from [const geometry_msgs::Pose2D&] The pose at time 0
+      @param to [const geometry_msgs::Pose2D&] The pose at time 1
+      @param time [double] The fraction of the way
+      @return geometry_msgs::Pose2D
+      **/
+      static geometry_msgs::Pose2D interpolate(
+        const geometry_msgs::Pose2D& from,
+        const geometry_msgs::Pose2D& to,
+        double time);
+
+    private:
+
+      /**
+      @brief Sweeps a polygonal robot with its footprint raster
+      @param map [const SharedMap&] The map
+      @param newPose [const geometry_msgs::Pose2D&] The new robot pose
+      @param previousPose [const geometry_msgs::Pose2D&] The previous pose
+      @return Contact : The first contact along the motion
+      **/
+      Contact sweepRaster(
+        const SharedMap& map,
+        const geometry_msgs::Pose2D& newPose,
+        const geometry_msgs::Pose2D& previousPose) const;
+
+      /**
+      @brief Sweeps a circular robot by conservative advancement on the \
+      distance transform
+      @param map [const SharedMap&] The map, with a distance transform
+      @param newPose [const geometry_msgs::Pose2D&] The new robot pose
+      @param previousPose [const geometry_msgs::Pose2D&] The previous pose
+      @return Contact : The first contact along the motion
+      **/
+      Contact sweepCircle(
+        const SharedMap& map,
+        const geometry_msgs::Pose2D& newPose,
+        const geometry_msgs::Pose2D& previousPose) const;
+
+      /**
+      @brief Returns the footprint cell hit at a pose of the sweep
+      @param occupancy [const OccupancyBitmap&] The map occupancy
+      @param pose [const geometry_msgs::Pose2D&] The pose in cells
+      @param hitX [int&] The x of the cell hit
+      @param hitY [int&] The y of the cell hit
+      @return bool : True on collision
+      **/
+      bool rasterHit(const OccupancyBitmap& occupancy,
+        const geometry_msgs::Pose2D& pose, int& hitX, int& hitY) const;
+
+      /**
+      @brief Returns the footprint cell stopping the sweep at a pose. \
+      Without start cells every cell hit stops it. A robot starting in \
+      contact ignores the cells it touched at the start, and is stopped \
+      only by the new cells it moves into.
+      @param occupancy [const OccupancyBitmap&] The map occupancy
+      @param pose [const geometry_msgs::Pose2D&] The pose in cells
+      @param startCells [const FootprintRaster::Cells&] The sorted cells \
+      hit at the start of the sweep
+      @param dx [double] The motion x in cells
+      @param dy [double] The motion y in cells
+      @param hitX [int&] The x of the cell hit
+      @param hitY [int&] The y of the cell hit
+      @return bool : True on collision
+      **/
+      bool sweepHit(const OccupancyBitmap& occupancy,
+        const geometry_msgs::Pose2D& pose,
+        const FootprintRaster::Cells& startCells, double dx, double dy,
+        int& hitX, int& hitY) const;
+
+      /**
+      @brief Returns the distance of a point to the nearest occupied cell \
+      or to the outside of the map, from the cell holding the point
+      @param map [const SharedMap&] The map, with a distance transform
+      @param x [double] The point x in cells
+      @param y [double] The point y in cells
+      @return double : The distance in cells, 0 outside the map
+      **/
+      static double getClearance(const SharedMap& map, double x, double y);
+
+      /**
+      @brief Sets the normal of a contact from the free cells around the \
+      cell hit. Thin obstacles, free on both sides, take the side of the \
+      robot center.
+      @param contact [Contact&] The contact
+      @param occupancy [const OccupancyBitmap&] The map occupancy
+      @param pose [const geometry_msgs::Pose2D&] The pose in cells
+      @param hitX [int] The x of the cell hit
+      @param hitY [int] The y of the cell hit
+      @return void
+      **/
+      static void setRasterNormal(Contact& contact,
+        const OccupancyBitmap& occupancy, const geometry_msgs::Pose2D& pose,
+        int hitX, int hitY);
+
+      /**
+      @brief Normalizes a contact normal, or falls back to the reverse of \
+      the motion when it is degenerate
+      @param contact [Contact&] The contact
+      @param dx [double] The motion x
+      @param dy [double] The motion y
+      @return void
+      **/
+      static void normalize(Contact& contact, double dx, double dy);
+
+    private:
+
+      //!< Cells added to the radius, like the outline cell neighbours
+      static const double CIRCLE_MARGIN;
+      //!< Shortest advancement of a sweep in cells
+      static const double MIN_ADVANCE;
+      //!< Bisections locating the contact between two sweep samples
+      static const int CONTACT_BISECTIONS;
+
+      //!< True if the footprint is a circle of _radius
+      bool _circular;
+      //!< The radius of a circular footprint in meters
+      float _radius;
+
+      //!< The robot footprint points, relative to the robot center
+      FootprintRaster::Footprint _footprint;
+
+      //!< The footprint rasters for the resolution of the last map
+      FootprintRasterConstPtr _raster;
+  };
+
+  typedef boost::shared_ptr<CollisionChecker> CollisionCheckerPtr;
+
+}
+
+#endif
@@ -0,0 +1,169 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef FLEET_STATE_H
+#define FLEET_STATE_H
+
+#include <vector>
+#include <geometry_msgs/Pose2D.h>
+#include <geometry_msgs/Twist.h>
+#include <boost/thread/mutex.hpp>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/ 
+namespace stdr_robot {
+
+  /**
+  @class FleetState
+  @brief The poses and velocities of a fleet of robots in \
+  struct of arrays form. The motion of all robots is integrated in one \
+  loop without branches, which the compiler vectorizes. Slots of removed \
+  robots stand still until they are reused. Thread safe.
+  **/
+  class FleetState {
+
+    public:
+
+      /**
+      @enum MotionModel
+      @brief The kinematic models of the robots
+      **/
+      enum MotionModel {
+        IDEAL,
+        OMNI
+      };
+
+      /**
+      @brief Default constructor
+      @return void
+      **/
+      FleetState(void);
+
+      /**
+      @brief Adds a robot standing at a pose
+      @param pose [const geometry_msgs::Pose2D&] The robot pose
+      @param model [MotionModel] The kinematic model of the robot
+      @return unsigned int : The slot of the robot
+      **/
+      unsigned int addRobot(const geometry_msgs::Pose2D& pose,
+        MotionModel model);
+
+      /**
+      @brief Removes a robot, its slot may be reused
+      @param slot [unsigned int] The slot of the robot
+      @return void
+      **/
+      void removeRobot(unsigned int slot);
+
+      /**
+      @brief Returns the pose of a robot
+      @param slot [unsigned int] The slot of the robot
+      @return geometry_msgs::Pose2D
+      **/
+      geometry_msgs::Pose2D getPose(unsigned int slot);
+
+      /**
+      @brief Moves a robot
+      @param slot [unsigned int] The slot of the robot
+      @param pose [const geometry_msgs::Pose2D&] The new pose
+      @return void
+      **/
+      void setPose(unsigned int slot, const geometry_msgs::Pose2D& pose);
+
+      /**
+      @brief Sets the velocity of a robot. Ideal robots ignore the \
+      lateral velocity.
+      @param slot [unsigned int] The slot of the robot
+      @param twist [const geometry_msgs::Twist&] The velocity in the \
+      robot frame
+      @return void
+      **/
+      void setVelocity(unsigned int slot, const geometry_msgs::Twist& twist);
+
+      /**
+      @brief Returns the velocity of a robot, zero laterally for ideal \
+      robots
+      @param slot [unsigned int] The slot of the robot
+      @return geometry_msgs::Twist : The velocity in the robot frame
+      **/
+      geometry_msgs::Twist getVelocity(unsigned int slot);
+
+      /**
+      @brief Integrates the motion of all robots over a time step
+      @param dt [float] The time step in seconds
+      @return void
+      **/
+      void integrate(float dt);
+
+      /**
+      @brief Integrates the motion of one robot over a time step
+      @param slot [unsigned int] The slot of the robot
+      @param dt [float] The time step in seconds
+      @return void
+      **/
+      void integrate(unsigned int slot, float dt);
+
+      /**
+      @brief Integrates constant velocities in the robot frame over a \
+      time step. The robots move along the exact arc of their turn, which \
+      for omni robots is the limit of integrating in ever smaller steps. \
+      The arrays must not overlap.
+      @param x [float*] The x coordinates to update
+      @param y [float*] The y coordinates to update
+      @param theta [float*] The orientations to update
+      @param linear [const float*] The forward velocities
+      @param lateral [const float*] The lateral velocities
+      @param angular [const float*] The angular velocities
+      @param count [unsigned int] The number of robots
+      @param dt [float] The time step in seconds
+      @return void
+      **/
+      static void integrateMotion(float* x, float* y, float* theta,
+        const float* linear, const float* lateral, const float* angular,
+        unsigned int count, float dt);
+
+    private:
+
+      //!< Robot x coordinates
+      std::vector<float> _x;
+      //!< Robot y coordinates
+      std::vector<float> _y;
+      //!< Robot orientations
+      std::vector<float> _theta;
+      //!< Forward velocities
+      std::vector<float> _linear;
+      //!< Lateral velocities, zero for ideal robots
+      std::vector<float> _lateral;
+      //!< Angular velocities
+      std::vector<float> _angular;
+      //!< Robot kinematic models
+      std::vector<MotionModel> _models;
+      //!< Slots of removed robots
+      std::vector<unsigned int> _freeSlots;
+      //!< Held while the arrays are read or written
+      boost::mutex _mutex;
+  };
+
+}
+
+#endif
@@ -0,0 +1,191 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef FOOTPRINT_RASTER_H
+#define FOOTPRINT_RASTER_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdr_robot/occupancy_bitmap.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  class FootprintRaster;
+  typedef boost::shared_ptr<const FootprintRaster> FootprintRasterConstPtr;
+
+  /**
+  @class FootprintRaster
+  @brief The cells a footprint outline covers, with their 8 neighbours, \
+  rasterized once per heading bin. Each mask row is a few 64 bit words \
+  that are tested against OccupancyBitmap::getRowBits() with a single \
+  AND. Heading bins are narrow enough that the outline moves a quarter \
+  of a cell at most within a bin, and each bin mask is the union of several \
+  headings across the bin, dilated by one cell. A bin mask is conservative: \
+  it holds every cell probed at any heading of the bin, so the raster may \
+  report a collision a cell early but never misses one. Rasters are shared \
+  by the robots with the same footprint and map resolution, and released \
+  when no robot holds them.
+  **/
+  class FootprintRaster {
+
+    public:
+
+      typedef std::vector<std::pair<float,float> > Footprint;
+      typedef std::vector<std::pair<int,int> > Cells;
+
+      /**
+      @brief Returns the raster of a footprint, building it if no robot \
+      holds it yet
+      @param footprint [const Footprint&] The footprint points in meters
+      @param resolution [float] The map resolution
+      @return FootprintRasterConstPtr
+      **/
+      static FootprintRasterConstPtr get(const Footprint& footprint,
+        float resolution);
+
+      /**
+      @brief Default constructor. Rasterizes all heading bins.
+      @param footprint [const Footprint&] The footprint points in meters
+      @param resolution [float] The map resolution
+      @return void
+      **/
+      FootprintRaster(const Footprint& footprint, float resolution);
+
+      /**
+      @brief Returns the map resolution of the raster
+      @return float
+      **/
+      inline float getResolution(void) const
+      {
+        return _resolution;
+      }
+
+      /**
+      @brief Returns the number of heading bins
+      @return unsigned int
+      **/
+      inline unsigned int getHeadings(void) const
+      {
+        return _headingRows.size() - 1;
+      }
+
+      /**
+      @brief Returns true if the footprint touches an occupied cell or \
+      leaves the map
+      @param occupancy [const OccupancyBitmap&] The map occupancy
+      @param x [int] The cell of the robot center
+      @param y [int] The cell of the robot center
+      @param theta [float] The robot orientation
+      @return bool
+      **/
+      bool collides(const OccupancyBitmap& occupancy,
+        int x, int y, float theta) const;
+
+      /**
+      @brief Like collides(), also returning the first cell hit
+      @param occupancy [const OccupancyBitmap&] The map occupancy
+      @param x [int] The cell of the robot center
+      @param y [int] The cell of the robot center
+      @param theta [float] The robot orientation
+      @param hitX [int&] The x of the cell hit
+      @param hitY [int&] The y of the cell hit
+      @return bool
+      **/
+      bool findCollision(const OccupancyBitmap& occupancy,
+        int x, int y, float theta, int& hitX, int& hitY) const;
+
+      /**
+      @brief Like collides(), also returning every cell hit
+      @param occupancy [const OccupancyBitmap&] The map occupancy
+      @param x [int] The cell of the robot center
+      @param y [int] The cell of the robot center
+      @param theta [float] The robot orientation
+      @param cells [Cells&] The cells hit
+      @return bool
+      **/
+      bool findCollisions(const OccupancyBitmap& occupancy,
+        int x, int y, float theta, Cells& cells) const;
+
+    private:
+
+      /**
+      @brief Returns the heading bin of an orientation
+      @param theta [float] The orientation
+      @return unsigned int
+      **/
+      unsigned int getHeading(float theta) const;
+
+      /**
+      @struct MaskRow
+      @brief A row of a heading mask
+      **/
+      struct MaskRow {
+        //!< Row offset from the robot center
+        int dy;
+        //!< Column offset of the first bit from the robot center
+        int dx;
+        //!< Index of the first word in _words
+        unsigned int firstWord;
+        //!< Number of words of the row
+        unsigned int words;
+      };
+
+      /**
+      @brief Rasterizes the footprint outline over a heading bin
+      @param footprint [const Footprint&] The footprint points in meters
+      @param theta [float] The heading at the bin center
+      @param binWidth [float] The bin width
+      @return void
+      **/
+      void rasterize(const Footprint& footprint, float theta,
+        float binWidth);
+
+    private:
+
+      //!< Most heading bins of a raster
+      static const unsigned int MAX_HEADINGS;
+      //!< Headings rasterized across a bin, so the bin mask covers it
+      static const unsigned int BIN_SAMPLES;
+      //!< Cells added around every outline point: the 8 neighbours, plus
+      //!< one ring for the headings between the samples
+      static const int DILATION;
+
+      //!< The map resolution
+      float _resolution;
+      //!< The mask rows of all headings
+      std::vector<MaskRow> _rows;
+      //!< Index of the first row of every heading, plus the row count
+      std::vector<unsigned int> _headingRows;
+      //!< The mask words of all rows
+      std::vector<uint64_t> _words;
+  };
+
+}
+
+#endif
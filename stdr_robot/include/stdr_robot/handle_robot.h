@@ -24,6 +24,7 @@
 #include <actionlib/client/terminal_state.h>
 #include <stdr_msgs/RobotIndexedMsg.h>
 #include <stdr_msgs/SpawnRobotAction.h>
+#include <stdr_msgs/SpawnRobotsAction.h>
 #include <stdr_msgs/DeleteRobotAction.h>
 #include <stdr_msgs/MoveRobot.h>
 #include <stdr_robot/exceptions.h>
@@ -40,6 +41,8 @@ namespace stdr_robot {
 
   typedef actionlib::SimpleActionClient<stdr_msgs::SpawnRobotAction> 
     SpawnRobotClient;
+  typedef actionlib::SimpleActionClient<stdr_msgs::SpawnRobotsAction> 
+    SpawnRobotsClient;
   typedef actionlib::SimpleActionClient<stdr_msgs::DeleteRobotAction> 
     DeleteRobotClient;
 
@@ -53,6 +56,8 @@ namespace stdr_robot {
     
       //!< Action client for spawning robots
       SpawnRobotClient _spawnRobotClient;
+      //!< Action client for spawning many robots at once
+      SpawnRobotsClient _spawnRobotsClient;
       //!< Action client for deleting robots
       DeleteRobotClient _deleteRobotClient;
       
@@ -72,6 +77,14 @@ namespace stdr_robot {
       **/
       stdr_msgs::RobotIndexedMsg spawnNewRobot(const stdr_msgs::RobotMsg msg);
       
+      /**
+      @brief Spawns many robots in one round trip to the server
+      @param msgs [const std::vector<stdr_msgs::RobotMsg>&] The robot messages from which the robots are created
+      @return std::vector<stdr_msgs::RobotIndexedMsg> : The robot messages with the proper frame_ids
+      **/
+      std::vector<stdr_msgs::RobotIndexedMsg> spawnNewRobots(
+        const std::vector<stdr_msgs::RobotMsg>& msgs);
+      
       /**
       @brief Deletes a robot by frame_id
       @param name [const std::string&] The robot frame_id to be deleted
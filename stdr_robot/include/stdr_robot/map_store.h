@@ -0,0 +1,163 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef MAP_STORE_H
+#define MAP_STORE_H
+
+#include <map>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <nav_msgs/OccupancyGrid.h>
+#include <stdr_robot/occupancy_bitmap.h>
+#include <stdr_robot/occupancy_pyramid.h>
+#include <stdr_robot/sensors/ray_caster.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class SharedMap
+  @brief An immutable occupancy grid map together with the structures \
+  derived from it. Built once per map and shared by all robots of a process.
+  **/
+  class SharedMap {
+
+    public:
+
+      /**
+      @brief Default constructor. Builds the derived structures.
+      @param grid [const nav_msgs::OccupancyGridConstPtr&] The map message
+      @param occupancyThreshold [int] Cells with larger values are occupied
+      @param maxDistanceTransformCells [int] Larger maps get no distance \
+      transform
+      @return void
+      **/
+      SharedMap(const nav_msgs::OccupancyGridConstPtr& grid,
+        int occupancyThreshold, int maxDistanceTransformCells);
+
+      /**
+      @brief Returns the occupancy grid map
+      @return const nav_msgs::OccupancyGrid&
+      **/
+      inline const nav_msgs::OccupancyGrid& getGrid(void) const
+      {
+        return *_grid;
+      }
+
+      /**
+      @brief Returns the occupied and unknown cells of the map
+      @return const OccupancyBitmap&
+      **/
+      inline const OccupancyBitmap& getOccupancy(void) const
+      {
+        return _occupancy;
+      }
+
+      /**
+      @brief Returns the occupancy pyramid of the map
+      @return const OccupancyPyramid&
+      **/
+      inline const OccupancyPyramid& getPyramid(void) const
+      {
+        return _pyramid;
+      }
+
+      /**
+      @brief Returns the ray caster of the map
+      @return const RayCaster&
+      **/
+      inline const RayCaster& getRayCaster(void) const
+      {
+        return _rayCaster;
+      }
+
+    private:
+
+      //!< The map message, as delivered by the subscription
+      nav_msgs::OccupancyGridConstPtr _grid;
+      //!< Bit packed occupancy of the map
+      OccupancyBitmap _occupancy;
+      //!< Max occupancy mipmap of the map
+      OccupancyPyramid _pyramid;
+      //!< Ray caster of the map
+      RayCaster _rayCaster;
+  };
+
+  typedef boost::shared_ptr<const SharedMap> SharedMapConstPtr;
+
+  /**
+  @class MapStore
+  @brief Keeps one SharedMap per map message in the process, keyed by the \
+  map stamp and frame. Robots receiving the same map share it instead of \
+  copying the grid. Maps no robot holds any more are released. The \
+  occupancy threshold is read from the ~occupancy_threshold parameter \
+  and the distance transform size limit from ~distance_transform_max_cells.
+  **/
+  class MapStore {
+
+    public:
+
+      /**
+      @brief Returns the map store of the process, created on first use
+      @return MapStore&
+      **/
+      static MapStore& getInstance(void);
+
+      /**
+      @brief Returns the shared map of a map message, building it if no \
+      robot holds it yet
+      @param grid [const nav_msgs::OccupancyGridConstPtr&] The map message
+      @return SharedMapConstPtr
+      **/
+      SharedMapConstPtr getMap(const nav_msgs::OccupancyGridConstPtr& grid);
+
+    private:
+
+      typedef std::pair<ros::Time, std::string> MapKey;
+      typedef std::map<MapKey, boost::weak_ptr<const SharedMap> > MapTable;
+
+      /**
+      @brief Default constructor
+      @return void
+      **/
+      MapStore(void);
+
+    private:
+
+      //!< Cells with larger values are occupied
+      int _occupancyThreshold;
+      //!< Larger maps are traced on the occupancy pyramid only
+      int _maxDistanceTransformCells;
+
+      //!< The maps held by at least one robot
+      MapTable _maps;
+      //!< Held while looking up or building a map
+      boost::mutex _mutex;
+  };
+
+}
+
+#endif
@@ -23,12 +23,13 @@
 #define MOTION_CONTROLLER_BASE_H
 
 #include <ros/ros.h>
-#include <tf/transform_broadcaster.h>
 #include <geometry_msgs/Twist.h>
 #include <geometry_msgs/Pose2D.h>
 #include <stdr_msgs/KinematicMsg.h>
+#include <stdr_robot/noise_engine.h>
+#include <stdr_robot/fleet_state.h>
 
-#include <ctime>
+#include <cmath>
 
 /**
 @namespace stdr_robot
@@ -39,7 +40,9 @@ namespace stdr_robot {
 
   /**
   @class MotionController
-  @brief Abstract class that provides motion controller abstraction
+  @brief Abstract class that provides motion controller abstraction. \
+  The pose and velocity live in a slot of a FleetState, which integrates \
+  the motion.
   **/ 
   class MotionController {
     
@@ -52,13 +55,14 @@ namespace stdr_robot {
       **/
       virtual void velocityCallback(const geometry_msgs::Twist& msg)
       {
-        _currentTwist = msg;
-        sampleVelocities();
+        geometry_msgs::Twist twist = msg;
+        sampleVelocities(twist);
+        _fleet.setVelocity(_slot, twist);
       }
 
       /**
       @brief Virtual function - Add noise to velocity commands
-      @param msg [geometry_msgs::Twist&] The velocity command
+      @param twist [geometry_msgs::Twist&] The velocity command
       @return void
       **/
       /**     
@@ -72,35 +76,35 @@ namespace stdr_robot {
       Sample(b^2) produces samples from a normal distribution with variance
       equal to b^2.
       **/
-      virtual void sampleVelocities(void)
+      virtual void sampleVelocities(geometry_msgs::Twist& twist)
       {
-        float ux = _currentTwist.linear.x;
-        float uy = _currentTwist.linear.y;
-        float w = _currentTwist.angular.z;
+        float ux = twist.linear.x;
+        float uy = twist.linear.y;
+        float w = twist.angular.z;
 
         float sample_ux = 
           _motion_parameters.a_ux_ux * ux * ux +
           _motion_parameters.a_ux_uy * uy * uy +
           _motion_parameters.a_ux_w  * w  * w;
-        _currentTwist.linear.x += sampleNormal(sqrt(sample_ux));
+        twist.linear.x += sampleNormal(sqrt(sample_ux));
 
         float sample_uy = 
           _motion_parameters.a_uy_ux * ux * ux +
           _motion_parameters.a_uy_uy * uy * uy +
           _motion_parameters.a_uy_w  * w  * w;
-        _currentTwist.linear.y += sampleNormal(sqrt(sample_uy));
+        twist.linear.y += sampleNormal(sqrt(sample_uy));
  
         float sample_w = 
           _motion_parameters.a_w_ux * ux * ux +
           _motion_parameters.a_w_uy * uy * uy +
           _motion_parameters.a_w_w  * w  * w;
-        _currentTwist.angular.z += sampleNormal(sqrt(sample_w));
+        twist.angular.z += sampleNormal(sqrt(sample_w));
 
         float sample_g = 
           _motion_parameters.a_g_ux * ux * ux +
           _motion_parameters.a_g_uy * uy * uy +
           _motion_parameters.a_g_w  * w  * w;
-        _currentTwist.angular.z += sampleNormal(sqrt(sample_g));
+        twist.angular.z += sampleNormal(sqrt(sample_g));
       }
 
       
@@ -110,20 +114,27 @@ namespace stdr_robot {
       **/
       virtual void stop(void)
       {
-        _currentTwist.linear.x = 0;
-        _currentTwist.linear.y = 0;
-        _currentTwist.linear.z = 0;
-        _currentTwist.angular.x = 0;
-        _currentTwist.angular.y = 0;
-        _currentTwist.angular.z = 0;
+        _fleet.setVelocity(_slot, geometry_msgs::Twist());
       }
       
       /**
-      @brief Pure virtual function - Calculates the motion - updates the robot pose
-      @param event [const ros::TimerEvent&] A ROS timer event
+      @brief Integrates the motion of this robot alone over a time step
+      @param dt [const ros::Duration&] The time step
       @return void
       **/
-      virtual void calculateMotion(const ros::TimerEvent& event) = 0;
+      inline void advance(const ros::Duration& dt)
+      {
+        _fleet.integrate(_slot, dt.toSec());
+      }
+
+      /**
+      @brief Returns the slot of the robot in the fleet
+      @return unsigned int
+      **/
+      inline unsigned int getSlot(void) const
+      {
+        return _slot;
+      }
       
       /**
       @brief Returns the pose calculated by the motion controller
@@ -131,7 +142,7 @@ namespace stdr_robot {
       **/
       inline geometry_msgs::Pose2D getPose(void)
       {
-        return _pose;
+        return _fleet.getPose(_slot);
       }
       
       /**
@@ -141,9 +152,7 @@ namespace stdr_robot {
       **/
       inline void setPose(geometry_msgs::Pose2D new_pose)
       {
-        _pose.x = new_pose.x;
-        _pose.y = new_pose.y;
-        _pose.theta = new_pose.theta;
+        _fleet.setPose(_slot, new_pose);
       }
       
       /**
@@ -151,31 +160,26 @@ namespace stdr_robot {
       @return geometry_msgs::Twist
       */
       inline geometry_msgs::Twist getVelocity() {
-        return _currentTwist;
+        return _fleet.getVelocity(_slot);
       }
 
       /**
-      @brief Default desctructor
+      @brief Default desctructor. Frees the slot of the robot.
       @return void
       **/
       virtual ~MotionController(void) 
       {
+        _fleet.removeRobot(_slot);
       }
 
       /**
-      @brief Approaches a normal distribution sampling
+      @brief Samples a normal distribution from the robot noise engine
+      @param sigma [float] The standard deviation
       @return float
-      source: Sebastian Thrun, Probabilistic Robotics
       **/
-      float sampleNormal(float sigma)
+      inline float sampleNormal(float sigma)
       {
-        float tmp = 0;
-        for (unsigned int i = 0 ; i < 12 ; i++)
-        {
-          float sample = (rand() % 100000) / 50000.0 - 1.0; // From -1.0 -> 1.0
-          tmp += sample * sigma;
-        }
-        return tmp / 2.0;
+        return _noise.normal() * sigma;
       }
 
     
@@ -184,30 +188,30 @@ namespace stdr_robot {
       /**
       @brief Default constructor
       @param pose [const geometry_msgs::Pose2D&] The robot pose
-      @param tf [tf::TransformBroadcaster&] A ROS tf broadcaster
+      @param fleet [FleetState&] The fleet holding the robot state
+      @param model [FleetState::MotionModel] The kinematic model
       @param name [const std::string&] The robot frame id
       @return void
       **/
       MotionController(
         const geometry_msgs::Pose2D& pose, 
-        tf::TransformBroadcaster& tf, 
+        FleetState& fleet,
+        FleetState::MotionModel model,
         const std::string& name,
         ros::NodeHandle& n,
         const stdr_msgs::KinematicMsg params
         )
-          : _tfBroadcaster(tf), 
-            _freq(0.1), 
-            _namespace(name),
-            _pose(pose),
-            _motion_parameters(params)
+          : _namespace(name),
+            _fleet(fleet),
+            _slot(fleet.addRobot(pose, model)),
+            _motion_parameters(params),
+            _noise(name)
         { 
           _velocitySubscrider = n.subscribe(
             _namespace + "/cmd_vel",
             1,
             &MotionController::velocityCallback,
             this);  
- 
-          srand(time(NULL));
         }
 
     protected:
@@ -216,18 +220,14 @@ namespace stdr_robot {
       const std::string& _namespace;
       //!< ROS subscriber to the velocity topic
       ros::Subscriber _velocitySubscrider;
-      //!< Frequency of motion calculation
-      ros::Duration _freq;
-      //!< ROS timer for generating motion calculation events
-      ros::Timer _calcTimer;
-      //!< Broadcaster of the robot tf transform
-      tf::TransformBroadcaster& _tfBroadcaster;
-      //!< Robot pose message
-      geometry_msgs::Pose2D _pose;
-      //!< Current motion command
-      geometry_msgs::Twist _currentTwist;
+      //!< The fleet holding the pose and velocity of the robot
+      FleetState& _fleet;
+      //!< The slot of the robot in the fleet
+      const unsigned int _slot;
       //!< The kinematic model parameters
       stdr_msgs::KinematicMsg _motion_parameters;
+      //!< Random numbers of the motion noise, seeded by the robot name
+      NoiseEngine _noise;
   };
     
   typedef boost::shared_ptr<MotionController> MotionControllerPtr;
@@ -58,25 +58,18 @@ namespace stdr_robot
       /**
       @brief Default constructor
       @param pose [const geometry_msgs::Pose2D&] The robot pose
-      @param tf [tf::TransformBroadcaster&] A ROS tf broadcaster
+      @param fleet [FleetState&] The fleet holding the robot state
       @param n [ros::NodeHandle&] The ROS node handle
       @param name [const std::string&] The robot frame id
       @return void
       **/
       OmniMotionController(
         const geometry_msgs::Pose2D& pose, 
-        tf::TransformBroadcaster& tf, 
+        FleetState& fleet,
         ros::NodeHandle& n, 
         const std::string& name,
         const stdr_msgs::KinematicMsg params);
-           
-      /**
-      @brief Calculates the motion - updates the robot pose
-      @param event [const ros::TimerEvent&] A ROS timer event
-      @return void
-      **/
-      void calculateMotion(const ros::TimerEvent& event);
-      
+
       /**
       @brief Default destructor 
       @return void
@@ -0,0 +1,149 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef NOISE_ENGINE_H
+#define NOISE_ENGINE_H
+
+#include <string>
+#include <stdint.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/ 
+namespace stdr_robot {
+
+  /**
+  @class NoiseEngine
+  @brief Random numbers of one robot or sensor. A xoshiro256** generator \
+  seeded from the global noise seed and the name of its stream, so that \
+  a run is reproduced by its seed whatever the loading order. Normal \
+  samples use the ziggurat method. Not thread safe, each owner has its \
+  own engine.
+  **/
+  class NoiseEngine {
+
+    public:
+
+      /**
+      @brief Default constructor
+      @param stream [const std::string&] The name of the stream, \
+      e.g. the robot name or the sensor frame id
+      @return void
+      **/
+      explicit NoiseEngine(const std::string& stream);
+
+      /**
+      @brief Constructor with an explicit seed, for users without a \
+      ROS parameter server
+      @param seed [uint64_t] The seed, used in place of the global seed
+      @param stream [const std::string&] The name of the stream
+      @return void
+      **/
+      NoiseEngine(uint64_t seed, const std::string& stream);
+
+      /**
+      @brief Returns 64 random bits
+      @return uint64_t
+      **/
+      inline uint64_t next(void)
+      {
+        const uint64_t result = rotl(_state[1] * 5, 7) * 9;
+        const uint64_t t = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= t;
+        _state[3] = rotl(_state[3], 45);
+        return result;
+      }
+
+      /**
+      @brief Returns a uniform sample in (0, 1)
+      @return double
+      **/
+      inline double uniform(void)
+      {
+        return ( (next() >> 11) + 0.5 ) * (1.0 / 9007199254740992.0);
+      }
+
+      /**
+      @brief Returns a standard normal sample
+      @return float
+      **/
+      float normal(void);
+
+      /**
+      @brief Fills an array with normal samples
+      @param values [float*] The array
+      @param size [unsigned int] The array size
+      @param mean [float] The mean of the samples
+      @param std [float] The standard deviation of the samples
+      @return void
+      **/
+      void fillNormal(float* values, unsigned int size, float mean, float std);
+
+      /**
+      @brief Returns the global noise seed, the ~noise_seed parameter of \
+      the process. A negative seed draws one from the clock, and logs it.
+      @return uint64_t
+      **/
+      static uint64_t getGlobalSeed(void);
+
+    private:
+
+      /**
+      @brief Seeds the generator state from a seed and a stream name
+      @param seed [uint64_t] The seed
+      @param stream [const std::string&] The name of the stream
+      @return void
+      **/
+      void initState(uint64_t seed, const std::string& stream);
+
+      /**
+      @brief Rotates bits to the left
+      @param x [uint64_t] The bits
+      @param k [int] The rotation
+      @return uint64_t
+      **/
+      static inline uint64_t rotl(uint64_t x, int k)
+      {
+        return (x << k) | (x >> (64 - k));
+      }
+
+      /**
+      @brief Samples the tail and the wedges of the ziggurat
+      @param hz [int32_t] The random integer of the sample
+      @param iz [unsigned int] The layer of the sample
+      @return float
+      **/
+      float normalTail(int32_t hz, unsigned int iz);
+
+    private:
+
+      //!< The generator state, never all zero
+      uint64_t _state[4];
+  };
+
+}
+
+#endif
@@ -0,0 +1,193 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef OCCUPANCY_BITMAP_H
+#define OCCUPANCY_BITMAP_H
+
+#include <vector>
+#include <stdint.h>
+#include <nav_msgs/OccupancyGrid.h>
+#include <stdr_robot/tiled_layout.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class OccupancyBitmap
+  @brief One bit per cell view of an occupancy grid map, with a second \
+  bitplane for unknown cells. Each 64 bit word holds an 8x8 tile of the \
+  TiledLayout, so a zero word is a free 8x8 block and a ray crosses \
+  several cells of a word in any direction. Cells outside the map are \
+  reported as occupied and unknown.
+  **/
+  class OccupancyBitmap {
+
+    public:
+
+      /**
+      @brief Default constructor. Packs the map cells.
+      @param map [const nav_msgs::OccupancyGrid&] The occupancy grid map
+      @param threshold [int] Cells with larger values are occupied
+      @return void
+      **/
+      OccupancyBitmap(const nav_msgs::OccupancyGrid& map, int threshold);
+
+      /**
+      @brief Returns the map width in cells
+      @return int
+      **/
+      inline int getWidth(void) const
+      {
+        return _layout.width;
+      }
+
+      /**
+      @brief Returns the map height in cells
+      @return int
+      **/
+      inline int getHeight(void) const
+      {
+        return _layout.height;
+      }
+
+      /**
+      @brief Returns true if the bitmap holds no cells
+      @return bool
+      **/
+      inline bool empty(void) const
+      {
+        return _occupied.empty();
+      }
+
+      /**
+      @brief Returns true if a cell lies inside the map
+      @param x [int] The cell x
+      @param y [int] The cell y
+      @return bool
+      **/
+      inline bool isInside(int x, int y) const
+      {
+        return x >= 0 && y >= 0 && x < _layout.width && y < _layout.height;
+      }
+
+      /**
+      @brief Returns true if a cell is occupied or outside the map
+      @param x [int] The cell x
+      @param y [int] The cell y
+      @return bool
+      **/
+      inline bool isOccupied(int x, int y) const
+      {
+        return !isInside(x, y) || testBit(_occupied, x, y);
+      }
+
+      /**
+      @brief Returns true if a cell is unknown or outside the map
+      @param x [int] The cell x
+      @param y [int] The cell y
+      @return bool
+      **/
+      inline bool isUnknown(int x, int y) const
+      {
+        return !isInside(x, y) || testBit(_unknown, x, y);
+      }
+
+      /**
+      @brief Returns true if no cell of a row span is occupied. Tests the \
+      cells of a tile row at once.
+      @param y [int] The row
+      @param xBegin [int] The first cell of the span
+      @param xEnd [int] The last cell of the span, inclusive
+      @return bool : False if the span leaves the map
+      **/
+      bool isSpanFree(int y, int xBegin, int xEnd) const;
+
+      /**
+      @brief Returns the first occupied cell of a row at or after a cell. \
+      Skips the free cells of a tile row at once.
+      @param y [int] The row, inside the map
+      @param x [int] The first cell to test, inside the map
+      @return int : The occupied cell x, the map width if there is none
+      **/
+      int nextOccupiedInRow(int y, int x) const;
+
+      /**
+      @brief Returns the occupancy of 64 consecutive cells of a row, bit i \
+      for cell (x + i, y). Cells outside the map are set.
+      @param y [int] The row
+      @param x [int] The first cell
+      @return uint64_t
+      **/
+      uint64_t getRowBits(int y, int x) const;
+
+      /**
+      @brief Returns the occupied bits of the 8x8 tile holding a cell, \
+      bit (y % 8) * 8 + (x % 8) for cell (x, y)
+      @param x [int] The cell x, inside the map
+      @param y [int] The cell y, inside the map
+      @return uint64_t
+      **/
+      inline uint64_t getTile(int x, int y) const
+      {
+        return _occupied[ _layout.index(x, y) >> 6 ];
+      }
+
+      /**
+      @brief Occupancy predicate for castRay. The caller keeps the ray \
+      inside the map.
+      @param x [int] The cell x
+      @param y [int] The cell y
+      @return bool
+      **/
+      inline bool operator()(int x, int y) const
+      {
+        return testBit(_occupied, x, y);
+      }
+
+    private:
+
+      /**
+      @brief Tests the bit of a cell inside the map
+      @return bool
+      **/
+      inline bool testBit(const std::vector<uint64_t>& plane,
+        int x, int y) const
+      {
+        int index = _layout.index(x, y);
+        return ( plane[ index >> 6 ] >> ( index & 63 ) ) & 1;
+      }
+
+    private:
+
+      //!< The tiling of the map, one word per tile
+      TiledLayout _layout;
+      //!< Set bits mark occupied cells
+      std::vector<uint64_t> _occupied;
+      //!< Set bits mark unknown cells
+      std::vector<uint64_t> _unknown;
+  };
+
+}
+
+#endif
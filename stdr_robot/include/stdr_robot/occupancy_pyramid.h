@@ -0,0 +1,104 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef OCCUPANCY_PYRAMID_H
+#define OCCUPANCY_PYRAMID_H
+
+#include <vector>
+#include <stdint.h>
+#include <stdr_robot/occupancy_bitmap.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class OccupancyPyramid
+  @brief Max occupancy mipmap of an OccupancyBitmap. A block of level L \
+  covers 2^L x 2^L cells and is occupied if any of its cells is. Levels \
+  1 to 3 are read from the 8x8 tiles of the bitmap, coarser levels are \
+  stored one byte per block. Rays jump over the largest free block they \
+  are in, so their cost grows with the obstacles they pass by instead of \
+  with their range.
+  **/
+  class OccupancyPyramid {
+
+    public:
+
+      /**
+      @brief Default constructor. Builds the coarse levels.
+      @param occupancy [const OccupancyBitmap&] The occupied cells of the map
+      @return void
+      **/
+      explicit OccupancyPyramid(const OccupancyBitmap& occupancy);
+
+      /**
+      @brief Returns the number of levels, level 0 being the map cells
+      @return int
+      **/
+      inline int getLevels(void) const
+      {
+        return _levels;
+      }
+
+      /**
+      @brief Returns true if the block of a level holding a cell has no \
+      occupied cell
+      @param level [int] The level, less than getLevels()
+      @param x [int] The cell x, inside the map
+      @param y [int] The cell y, inside the map
+      @return bool
+      **/
+      bool isBlockFree(int level, int x, int y) const;
+
+      /**
+      @brief Casts a ray and returns the distance to the first occupied \
+      cell it crosses. Same result as castRay on the bitmap.
+      @param originX [double] The ray origin x in cells
+      @param originY [double] The ray origin y in cells
+      @param dirX [double] The x component of the unit ray direction
+      @param dirY [double] The y component of the unit ray direction
+      @param maxDistance [double] The maximum ray distance in cells
+      @return float : The distance in cells, infinity if nothing was hit
+      **/
+      float castRay(double originX, double originY,
+        double dirX, double dirY, double maxDistance) const;
+
+    private:
+
+      //!< The first level stored in _blocks
+      static const int FIRST_STORED_LEVEL = TiledLayout::TILE_SHIFT + 1;
+
+      //!< The occupied cells of the map
+      const OccupancyBitmap& _occupancy;
+      //!< Number of levels
+      int _levels;
+      //!< Blocks per row of each stored level
+      std::vector<int> _widths;
+      //!< Non zero for occupied blocks, row major, one vector per stored level
+      std::vector<std::vector<uint8_t> > _blocks;
+  };
+
+}
+
+#endif
@@ -0,0 +1,136 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef ROBOT_POOL_H
+#define ROBOT_POOL_H
+
+#include <ros/ros.h>
+#include <nodelet/nodelet.h>
+#include <nodelet/NodeletUnload.h>
+#include <stdr_msgs/LoadPooledRobots.h>
+#include <stdr_robot/stdr_robot.h>
+#include <boost/thread/mutex.hpp>
+#include <map>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/ 
+namespace stdr_robot {
+
+  /**
+  @class RobotPool
+  @brief Owns many robots in one nodelet. The server hands it the robot \
+  descriptions directly, without a nodelet load and register handshake \
+  per robot. The robots share one map subscription and are stepped in one \
+  loop, their topics are the same as those of the robot nodelets.
+  **/ 
+  class RobotPool : public nodelet::Nodelet {
+    
+   public: 
+    
+    /**
+    @brief Default constructor
+    @return void
+    **/
+    RobotPool(void);
+    
+    /**
+    @brief Advertises the pool services and subscribes to the map
+    @return void
+    **/
+    void onInit(void);
+    
+    /**
+    @brief Default destructor
+    @return void
+    **/
+    ~RobotPool(void);
+    
+   private:
+    
+    /**
+    @brief The callback of the load robots service
+    @param req [stdr_msgs::LoadPooledRobots::Request&] The service request
+    @param res [stdr_msgs::LoadPooledRobots::Response&] The service result
+    @return bool
+    **/
+    bool loadRobotsCallback(stdr_msgs::LoadPooledRobots::Request& req,
+      stdr_msgs::LoadPooledRobots::Response& res);
+    
+    /**
+    @brief The callback of the unload robot service
+    @param req [nodelet::NodeletUnload::Request&] The service request
+    @param res [nodelet::NodeletUnload::Response&] The service result
+    @return bool
+    **/
+    bool unloadRobotCallback(nodelet::NodeletUnload::Request& req,
+      nodelet::NodeletUnload::Response& res);
+    
+    /**
+    @brief Callback for getting the occupancy grid map
+    @param msg [const nav_msgs::OccupancyGridConstPtr&] The occupancy grid map
+    @return void
+    **/
+    void mapCallback(const nav_msgs::OccupancyGridConstPtr& msg);
+    
+    /**
+    @brief Moves the fleet and steps all robots on the pool timer, when \
+    not in lockstep
+    @param event [const ros::TimerEvent&] A ROS timer event
+    @return void
+    **/
+    void updateCallback(const ros::TimerEvent& event);
+    
+   private:
+    
+    //!< The poses and velocities of the robots, declared first to outlive
+    //!< their motion controllers
+    FleetState _fleet;
+    
+    //!< The robots of the pool by frame_id, stepped in name order
+    std::map<std::string, RobotPtr> _robots;
+    
+    //!< The map shared by all robots of the process, null until received
+    SharedMapConstPtr _map;
+    
+    //!< ROS subscriber for map
+    ros::Subscriber _mapSubscriber;
+    
+    //!< ROS service server to load robots
+    ros::ServiceServer _loadRobotsService;
+    
+    //!< ROS service server to unload a robot
+    ros::ServiceServer _unloadRobotService;
+    
+    //!< ROS timer stepping the robots at the collision rate
+    ros::Timer _updateTimer;
+    
+    //!< Time of the last step on the pool timer
+    ros::Time _lastUpdate;
+    
+    //!< Guards the robots against the services and the map
+    boost::mutex _mutex;
+  };
+  
+} // namespace stdr_robot
+
+#endif
@@ -0,0 +1,117 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef BEAM_TABLE_H
+#define BEAM_TABLE_H
+
+#include <cmath>
+#include <vector>
+#include <tf/transform_datatypes.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class BeamTable
+  @brief Unit directions of the beams of a sensor. Computed once in the \
+  sensor frame and rotated to the map frame once per scan, without \
+  trigonometry.
+  **/
+  class BeamTable {
+
+    public:
+
+      /**
+      @brief Appends a beam
+      @param angle [float] The beam angle in the sensor frame
+      @return void
+      **/
+      inline void addBeam(float angle)
+      {
+        _sensorCosines.push_back( cos(angle) );
+        _sensorSines.push_back( sin(angle) );
+        _cosines.push_back(0);
+        _sines.push_back(0);
+      }
+
+      /**
+      @brief Returns the number of beams
+      @return int
+      **/
+      inline int size(void) const
+      {
+        return _sensorCosines.size();
+      }
+
+      /**
+      @brief Rotates the beams to the map frame
+      @param sensorTransform [const tf::Transform&] The sensor to map \
+      transform
+      @return void
+      **/
+      inline void rotate(const tf::Transform& sensorTransform)
+      {
+        //!< First column of the rotation matrix, (cos, sin) of the yaw
+        const float c = sensorTransform.getBasis()[0][0];
+        const float s = sensorTransform.getBasis()[1][0];
+        for ( unsigned int i = 0; i < _sensorCosines.size(); i++ )
+        {
+          _cosines[i] = c * _sensorCosines[i] - s * _sensorSines[i];
+          _sines[i] = s * _sensorCosines[i] + c * _sensorSines[i];
+        }
+      }
+
+      /**
+      @brief Returns the cosines of the beam angles in the map frame
+      @return const float*
+      **/
+      inline const float* getCosines(void) const
+      {
+        return _cosines.empty() ? NULL : &_cosines[0];
+      }
+
+      /**
+      @brief Returns the sines of the beam angles in the map frame
+      @return const float*
+      **/
+      inline const float* getSines(void) const
+      {
+        return _sines.empty() ? NULL : &_sines[0];
+      }
+
+    private:
+
+      //!< Cosines of the beam angles in the sensor frame
+      std::vector<float> _sensorCosines;
+      //!< Sines of the beam angles in the sensor frame
+      std::vector<float> _sensorSines;
+      //!< Cosines of the beam angles in the map frame, as of rotate()
+      std::vector<float> _cosines;
+      //!< Sines of the beam angles in the map frame, as of rotate()
+      std::vector<float> _sines;
+  };
+
+}
+
+#endif
@@ -26,7 +26,7 @@
 #include <stdr_robot/sensors/helper.h>
 #include <stdr_msgs/CO2SensorMsg.h>
 #include <stdr_msgs/CO2SensorMeasurementMsg.h>
-#include <stdr_msgs/CO2SourceVector.h>
+#include <stdr_robot/sensors/source_store.h>
 
 /**
 @namespace stdr_robot
@@ -44,7 +44,8 @@ namespace stdr_robot {
     public:
       /**
       @brief Default constructor
-      @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+      @param map [const SharedMapConstPtr&] The shared map of the robot
+      @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
       @param msg [const stdr_msgs::CO2SensorMsg&] The CO2 sensor \
       description message
       @param name [const std::string&] The sensor frame id without the base
@@ -52,7 +53,8 @@ namespace stdr_robot {
       @return void
       **/ 
       CO2Sensor(
-        const nav_msgs::OccupancyGrid& map,
+        const SharedMapConstPtr& map,
+        const RobotPoseConstPtr& robotPose,
         const stdr_msgs::CO2SensorMsg& msg, 
         const std::string& name, 
         ros::NodeHandle& n);
@@ -69,23 +71,24 @@ namespace stdr_robot {
       **/ 
       ~CO2Sensor(void);
       
-      /**
-      @brief Receives the existent co2 sources
-      @param msg [const stdr_msgs::CO2SourceVector&] The CO2 sources message
-      @return void
-      **/
-      void receiveCO2Sources(const stdr_msgs::CO2SourceVector& msg);
-
     private:
 
       //!< CO2 sensor description
       stdr_msgs::CO2SensorMsg _description;
       
-      //!< ROS subscriber for CO2 sources
-      ros::Subscriber co2_sources_subscriber_;
-      
-      //!< The currently existent sources
-      stdr_msgs::CO2SourceVector co2_sources_;
+      //!< Indexes of the sources found by the last update
+      std::vector<unsigned int> _foundSources;
+
+      //!< The last CO2 measurement
+      stdr_msgs::CO2SensorMeasurementMsg _measuredSourcesMsg;
+
+    protected:
+
+      /**
+      @brief Publishes the measurement of the last update
+      @return void
+      **/
+      virtual void publishLastMeasurement(void);
   };
 
 }
@@ -22,7 +22,10 @@
 #ifndef LASER_H
 #define LASER_H
 
+#include <vector>
 #include <stdr_robot/sensors/sensor_base.h>
+#include <stdr_robot/sensors/beam_table.h>
+#include <stdr_robot/sensors/range_noise.h>
 #include <sensor_msgs/LaserScan.h>
 #include <stdr_msgs/LaserSensorMsg.h>
 
@@ -42,13 +45,15 @@ namespace stdr_robot {
 
       /**
       @brief Default constructor
-      @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+      @param map [const SharedMapConstPtr&] The shared map of the robot
+      @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
       @param msg [const stdr_msgs::LaserSensorMsg&] The laser description message
       @param name [const std::string&] The sensor frame id without the base
       @param n [ros::NodeHandle&] The ROS node handle
       @return void
       **/ 
-      Laser(const nav_msgs::OccupancyGrid& map,
+      Laser(const SharedMapConstPtr& map,
+        const RobotPoseConstPtr& robotPose,
         const stdr_msgs::LaserSensorMsg& msg, 
         const std::string& name, 
         ros::NodeHandle& n);
@@ -69,6 +74,28 @@ namespace stdr_robot {
 
       //!< Laser sensor description
       stdr_msgs::LaserSensorMsg _description;
+
+      //!< Directions of the rays
+      BeamTable _beams;
+      //!< Ray distances of the last scan in cells
+      std::vector<float> _rayDistances;
+      //!< Noise of the scan ranges
+      RangeNoise _rangeNoise;
+
+      //!< Number of reused scan messages
+      static const int SCAN_BUFFERS = 2;
+      //!< Scan messages, published without copy and reused once released
+      sensor_msgs::LaserScanPtr _laserScans[SCAN_BUFFERS];
+      //!< Index of the last laser scan in _laserScans
+      int _currentScan;
+
+    protected:
+
+      /**
+      @brief Publishes the measurement of the last update
+      @return void
+      **/
+      virtual void publishLastMeasurement(void);
   };
 
 }
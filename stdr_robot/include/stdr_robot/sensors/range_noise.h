@@ -0,0 +1,99 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef RANGE_NOISE_H
+#define RANGE_NOISE_H
+
+#include <vector>
+#include <stdr_msgs/Noise.h>
+#include <stdr_robot/noise_engine.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/ 
+namespace stdr_robot {
+
+  /**
+  @class RangeNoise
+  @brief The noise stage of the range sensors. Adds the gaussian noise \
+  of the sensor description to the ranges that hit an obstacle, and \
+  drops returns or turns them to max range returns with the \
+  ~range_dropout_probability and ~range_max_return_probability \
+  parameters of the process, or the given probabilities.
+  **/
+  class RangeNoise {
+
+    public:
+
+      /**
+      @brief Default constructor
+      @param noise [const stdr_msgs::Noise&] The sensor noise description
+      @param maxRange [float] The max range of the sensor
+      @return void
+      **/
+      RangeNoise(const stdr_msgs::Noise& noise, float maxRange);
+
+      /**
+      @brief Constructor with explicit dropout probabilities, for users \
+      without a ROS parameter server
+      @param noise [const stdr_msgs::Noise&] The sensor noise description
+      @param maxRange [float] The max range of the sensor
+      @param dropoutProbability [double] Probability of a dropped return
+      @param maxReturnProbability [double] Probability of a max range return
+      @return void
+      **/
+      RangeNoise(const stdr_msgs::Noise& noise, float maxRange,
+        double dropoutProbability, double maxReturnProbability);
+
+      /**
+      @brief Applies the noise to the ranges of one measurement. Dropped \
+      returns become NaN and max range returns +inf.
+      @param engine [NoiseEngine&] The noise engine of the sensor
+      @param ranges [float*] The ranges in meters
+      @param size [unsigned int] The number of ranges
+      @return void
+      **/
+      void apply(NoiseEngine& engine, float* ranges, unsigned int size);
+
+    private:
+
+      //!< True to add gaussian noise
+      bool _gaussian;
+      //!< Mean of the gaussian noise
+      float _mean;
+      //!< Standard deviation of the gaussian noise
+      float _std;
+      //!< Ranges shorter than this hit an obstacle
+      float _maxRange;
+
+      //!< Probability of a dropped return
+      double _dropoutProbability;
+      //!< Probability of a max range return
+      double _maxReturnProbability;
+
+      //!< Gaussian samples of the last measurement
+      std::vector<float> _samples;
+  };
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef RAY_CASTER_H
+#define RAY_CASTER_H
+
+#include <vector>
+#include <stdr_robot/occupancy_bitmap.h>
+#include <stdr_robot/occupancy_pyramid.h>
+#include <stdr_robot/sensors/raycast.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class RayCaster
+  @brief Casts sensor rays on the occupancy grid map. Keeps a euclidean \
+  distance transform of the map, so that rays jump over free space \
+  (sphere tracing) instead of visiting every cell. Without a distance \
+  transform, rays jump over the free blocks of the occupancy pyramid.
+  **/
+  class RayCaster {
+
+    public:
+
+      /**
+      @brief Default constructor
+      @param occupancy [const OccupancyBitmap&] The occupied cells of the map
+      @param pyramid [const OccupancyPyramid&] The occupancy pyramid of the map
+      @return void
+      **/
+      RayCaster(const OccupancyBitmap& occupancy,
+        const OccupancyPyramid& pyramid);
+
+      /**
+      @brief Rebuilds the distance transform. Must be called every time \
+      the map changes.
+      @return void
+      **/
+      void updateMap(void);
+
+      /**
+      @brief Traces a ray through every cell it crosses, starting from a \
+      point in map cells
+      @param xMap [double] The ray origin x in cells
+      @param yMap [double] The ray origin y in cells
+      @param cosAngle [double] The cosine of the ray angle
+      @param sinAngle [double] The sine of the ray angle
+      @param maxDistance [double] The maximum ray distance in cells
+      @return float : The distance to the first occupied cell in cells, \
+      infinity if the ray leaves the map or exceeds its range
+      **/
+      float trace(double xMap, double yMap, double cosAngle, double sinAngle,
+        double maxDistance) const;
+
+      /**
+      @brief Traces a batch of rays sharing an origin. Uses the SIMD \
+      kernels of castRays when the distance transform is available.
+      @param xMap [double] The rays origin x in cells
+      @param yMap [double] The rays origin y in cells
+      @param cosAngles [const float*] The cosines of the ray angles
+      @param sinAngles [const float*] The sines of the ray angles
+      @param count [int] The number of rays
+      @param maxDistance [double] The maximum ray distance in cells
+      @param distances [float*] The distances to the first occupied cells \
+      in cells, infinity where nothing was hit
+      @return void
+      **/
+      void traceBatch(double xMap, double yMap,
+        const float* cosAngles, const float* sinAngles, int count,
+        double maxDistance, float* distances) const;
+
+      /**
+      @brief Returns true if the map has a distance transform
+      @return bool
+      **/
+      inline bool hasDistanceTransform(void) const
+      {
+        return !_distances.empty();
+      }
+
+      /**
+      @brief Returns the distance of a cell to the nearest occupied cell, \
+      between cell centers. Needs the distance transform.
+      @param x [int] The cell x, inside the map
+      @param y [int] The cell y, inside the map
+      @return float : The distance in cells
+      **/
+      inline float getDistance(int x, int y) const
+      {
+        return _distances[ _layout.index(x, y) ];
+      }
+
+      /**
+      @brief Default destructor
+      @return void
+      **/
+      ~RayCaster(void) {}
+
+    private:
+
+      /**
+      @brief Computes the 1D squared distance transform of a sampled function
+      @param f [const float*] The sampled function
+      @param n [int] The number of samples
+      @param d [float*] The output squared distances
+      @param v [int*] Scratch buffer for parabola locations (n)
+      @param z [float*] Scratch buffer for parabola boundaries (n + 1)
+      @return void
+      **/
+      static void distanceTransform1D(const float* f, int n, float* d,
+        int* v, float* z);
+
+    private:
+
+      //!< Length of a cell diagonal in cells
+      static const double SQRT2;
+      //!< Absorbs floating point error of the traversal
+      static const double SKIP_TOLERANCE;
+      //!< Shorter jumps are not worth restarting the traversal
+      static const double MIN_SKIP;
+
+      //!< The occupied cells of the map
+      const OccupancyBitmap& _occupancy;
+      //!< The occupancy pyramid of the map
+      const OccupancyPyramid& _pyramid;
+
+      //!< Map size and storage layout of _distances
+      TiledLayout _layout;
+      //!< Distance of every cell to the nearest obstacle in cells, tiled
+      std::vector<float> _distances;
+  };
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef RAYCAST_H
+#define RAYCAST_H
+
+#include <cmath>
+#include <limits>
+#include <stdint.h>
+#include <stdr_robot/tiled_layout.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @struct GridRay
+  @brief Grid traversal state of a ray (Amanatides & Woo). Visits every \
+  cell crossed by the ray exactly once, in order, without trigonometry.
+  **/
+  struct GridRay {
+
+    //!< Current cell
+    int x, y;
+    //!< Cell increment on each axis (-1, 0 or 1)
+    int stepX, stepY;
+    //!< Ray distance at which the next x / y cell border is crossed
+    double tMaxX, tMaxY;
+    //!< Ray distance between two consecutive x / y cell borders
+    double tDeltaX, tDeltaY;
+    //!< Ray distance at which the current cell was entered
+    double t;
+
+    /**
+    @brief Places the ray at a distance along its direction
+    @param originX [double] The ray origin x in cells
+    @param originY [double] The ray origin y in cells
+    @param dirX [double] The x component of the unit ray direction
+    @param dirY [double] The y component of the unit ray direction
+    @param distance [double] The distance from the origin in cells
+    @return void
+    **/
+    inline void start(double originX, double originY,
+      double dirX, double dirY, double distance)
+    {
+      double px = originX + dirX * distance;
+      double py = originY + dirY * distance;
+
+      x = floor(px);
+      y = floor(py);
+      t = distance;
+
+      initAxis(px, x, dirX, distance, stepX, tMaxX, tDeltaX);
+      initAxis(py, y, dirY, distance, stepY, tMaxY, tDeltaY);
+    }
+
+    /**
+    @brief Moves to the next cell crossed by the ray
+    @return void
+    **/
+    inline void next(void)
+    {
+      if ( tMaxX < tMaxY )
+      {
+        t = tMaxX;
+        tMaxX += tDeltaX;
+        x += stepX;
+      }
+      else
+      {
+        t = tMaxY;
+        tMaxY += tDeltaY;
+        y += stepY;
+      }
+    }
+
+    private:
+
+    /**
+    @brief Computes the traversal constants of one axis
+    @return void
+    **/
+    static inline void initAxis(double p, int cell, double dir,
+      double distance, int& step, double& tMax, double& tDelta)
+    {
+      if ( dir > 0 )
+      {
+        step = 1;
+        tDelta = 1.0 / dir;
+        tMax = distance + ( cell + 1 - p ) * tDelta;
+      }
+      else if ( dir < 0 )
+      {
+        step = -1;
+        tDelta = -1.0 / dir;
+        tMax = distance + ( p - cell ) * tDelta;
+      }
+      else
+      {
+        step = 0;
+        tDelta = std::numeric_limits<double>::infinity();
+        tMax = std::numeric_limits<double>::infinity();
+      }
+    }
+  };
+
+  /**
+  @brief Casts a ray on a grid and returns the distance to the first \
+  occupied cell it crosses
+  @param originX [double] The ray origin x in cells
+  @param originY [double] The ray origin y in cells
+  @param dirX [double] The x component of the unit ray direction
+  @param dirY [double] The y component of the unit ray direction
+  @param maxDistance [double] The maximum ray distance in cells
+  @param width [int] The grid width in cells
+  @param height [int] The grid height in cells
+  @param isOccupied [const OccupancyPredicate&] Returns true for occupied (x, y)
+  @return float : The distance in cells, infinity if nothing was hit
+  **/
+  template <typename OccupancyPredicate>
+  inline float castRay(double originX, double originY,
+    double dirX, double dirY, double maxDistance, int width, int height,
+    const OccupancyPredicate& isOccupied)
+  {
+    GridRay ray;
+    ray.start(originX, originY, dirX, dirY, 0);
+
+    while ( ray.t <= maxDistance )
+    {
+      if ( ray.x < 0 || ray.y < 0 || ray.x >= width || ray.y >= height )
+      {
+        break;
+      }
+      if ( isOccupied(ray.x, ray.y) )
+      {
+        return ray.t;
+      }
+      ray.next();
+    }
+    return std::numeric_limits<float>::infinity();
+  }
+
+  /**
+  @struct DistanceGrid
+  @brief Tiled grid holding the distance of every cell to its nearest \
+  occupied cell (zero for occupied cells)
+  **/
+  struct DistanceGrid {
+
+    //!< The distances in cells, stored in layout order
+    const float* distances;
+    //!< The grid size and storage layout
+    TiledLayout layout;
+  };
+
+  /**
+  @brief Casts a batch of rays sharing an origin on a distance grid. Jumps \
+  over free space and walks the cells crossed near obstacles. Dispatches at \
+  runtime to the widest SIMD kernel the cpu supports. All kernels return \
+  bit identical distances.
+  @param grid [const DistanceGrid&] The distance grid
+  @param originX [float] The rays origin x in cells
+  @param originY [float] The rays origin y in cells
+  @param dirX [const float*] The x components of the unit ray directions
+  @param dirY [const float*] The y components of the unit ray directions
+  @param count [int] The number of rays
+  @param maxDistance [float] The maximum ray distance in cells
+  @param distances [float*] The distances in cells, infinity if nothing \
+  was hit
+  @return void
+  **/
+  void castRays(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances);
+
+  /**
+  @brief Portable kernel of castRays, one ray at a time
+  **/
+  void castRaysScalar(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances);
+
+  /**
+  @brief SSE4.1 kernel of castRays, 4 rays in lockstep
+  **/
+  void castRaysSSE4(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances);
+
+  /**
+  @brief AVX2 kernel of castRays, 8 rays in lockstep
+  **/
+  void castRaysAVX2(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances);
+
+  //!< Jumps are shortened by a cell diagonal plus a floating point margin
+  const float RAYCAST_SKIP_OFFSET = 1.41421356f + 0.05f;
+  //!< Shorter jumps are not worth restarting the traversal
+  const float RAYCAST_MIN_SKIP = 2.0f;
+
+}
+
+#endif
@@ -26,7 +26,7 @@
 #include <stdr_robot/sensors/helper.h>
 #include <stdr_msgs/RfidSensorMsg.h>
 #include <stdr_msgs/RfidSensorMeasurementMsg.h>
-#include <stdr_msgs/RfidTagVector.h>
+#include <stdr_robot/sensors/source_store.h>
 
 /**
 @namespace stdr_robot
@@ -43,14 +43,16 @@ namespace stdr_robot {
     public:
       /**
       @brief Default constructor
-      @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+      @param map [const SharedMapConstPtr&] The shared map of the robot
+      @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
       @param msg [const stdr_msgs::RfidSensorMsg&] The rfid reader \
       description message
       @param name [const std::string&] The sensor frame id without the base
       @param n [ros::NodeHandle&] The ROS node handle
       @return void
       **/ 
-      RfidReader(const nav_msgs::OccupancyGrid& map,
+      RfidReader(const SharedMapConstPtr& map,
+        const RobotPoseConstPtr& robotPose,
         const stdr_msgs::RfidSensorMsg& msg, 
         const std::string& name, 
         ros::NodeHandle& n);
@@ -67,23 +69,24 @@ namespace stdr_robot {
       **/ 
       ~RfidReader(void);
       
-      /**
-      @brief Receives the existent rfid tags
-      @param msg [const stdr_msgs::RfidTagVector&] The rfid tags message
-      @return void
-      **/
-      void receiveRfids(const stdr_msgs::RfidTagVector& msg);
-
     private:
 
       //!< Sonar rfid reader description
       stdr_msgs::RfidSensorMsg _description;
       
-      //!< ROS subscriber for rfids
-      ros::Subscriber rfids_subscriber_;
-      
-      //!< The currently existent RFID tags
-      stdr_msgs::RfidTagVector rfid_tags_;
+      //!< Indexes of the sources found by the last update
+      std::vector<unsigned int> _foundSources;
+
+      //!< The last rfid tags measurement
+      stdr_msgs::RfidSensorMeasurementMsg _measuredTagsMsg;
+
+    protected:
+
+      /**
+      @brief Publishes the measurement of the last update
+      @return void
+      **/
+      virtual void publishLastMeasurement(void);
   };
 
 }
@@ -23,9 +23,11 @@
 #define SENSOR_H
 
 #include <ros/ros.h>
-#include <tf/transform_listener.h>
+#include <tf/transform_datatypes.h>
 #include <nav_msgs/OccupancyGrid.h>
 #include <geometry_msgs/Pose2D.h>
+#include <stdr_robot/map_store.h>
+#include <stdr_robot/noise_engine.h>
 
 /**
 @namespace stdr_robot
@@ -33,6 +35,9 @@
 **/ 
 namespace stdr_robot {
 
+  //!< Pose of a robot in the map, replaced as a whole on every robot step
+  typedef boost::shared_ptr<const geometry_msgs::Pose2D> RobotPoseConstPtr;
+
   /**
   @class Sensor
   @brief A class that provides sensor abstraction
@@ -43,11 +48,36 @@ namespace stdr_robot {
       
       /**
       @brief Virtual function for sensor value callback. Implement this function
-      on derived class to publish sensor measurements.
+      on derived class to compute the sensor measurements and set \
+      _hasMeasurement. Called by the SensorScheduler from a worker thread.
       @return void
       **/ 
       virtual void updateSensorCallback(void) = 0;
       
+      /**
+      @brief Publishes the measurement of the last updateSensorCallback(), \
+      if there is one
+      @return void
+      **/ 
+      void publishMeasurement(void);
+      
+      /**
+      @brief Computes the sensor transform from the last pose of the robot. \
+      Called by the SensorScheduler before updateSensorCallback(), so that \
+      the sensor sees one pose for the whole update.
+      @return bool : False until the robot has a pose
+      **/ 
+      bool updateTransform(void);
+      
+      /**
+      @brief Getter function for returning the sensor update frequency
+      @return float
+      **/ 
+      inline float getUpdateFrequency(void) const
+      {
+        return _updateFrequency;
+      }
+      
       /**
       @brief Getter function for returning the sensor pose relatively to robot
       @return geometry_msgs::Pose2D
@@ -59,11 +89,11 @@ namespace stdr_robot {
       
       /**
       @brief Getter function for returning the sensor frame id
-      @return std::string
+      @return const std::string&
       **/ 
-      inline std::string getFrameId(void) const
+      inline const std::string& getFrameId(void) const
       {
-        return _namespace + "_" + _sensorFrameId;
+        return _frameId;
       } 
       
       /**
@@ -78,16 +108,18 @@ namespace stdr_robot {
       
       /**
       @brief Default constructor
-      @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+      @param map [const SharedMapConstPtr&] The shared map of the robot
+      @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
       @param name [const std::string&] The sensor frame id without the base
-      @param n [ros::NodeHandle& n] A ROS NodeHandle to create timers
+      @param n [ros::NodeHandle& n] A ROS NodeHandle of the robot
       @param sensorPose [const geometry_msgs::Pose2D&] The sensor's pose relative to robot
       @param sensorFrameId [const std::string&] The sensor's frame id
       @param updateFrequency [float] The sensor's update frequnecy
       @return void
       **/ 
       Sensor(
-            const nav_msgs::OccupancyGrid& map,
+            const SharedMapConstPtr& map,
+            const RobotPoseConstPtr& robotPose,
             const std::string& name,
             ros::NodeHandle& n,
             const geometry_msgs::Pose2D& sensorPose,
@@ -95,25 +127,30 @@ namespace stdr_robot {
             float updateFrequency);
       
       /**
-      @brief Checks if transform is available and calls updateSensorCallback()
-      @param ev [const ros::TimerEvent&] A ROS timer event
+      @brief Virtual function for publishing the measurement of the last \
+      updateSensorCallback(). Implement this function on derived class.
       @return void
       **/
-      void checkAndUpdateSensor(const ros::TimerEvent& ev);
+      virtual void publishLastMeasurement(void) = 0;
       
       /**
-      @brief Function for updating the sensor tf transform
-      @param ev [const ros::TimerEvent&] A ROS timer event
-      @return void
-      **/ 
-      void updateTransform(const ros::TimerEvent& ev);
+      @brief Returns the current map of the robot. The robot may replace \
+      its map at any time, so take one snapshot per update.
+      @return SharedMapConstPtr : Null until the robot gets a map
+      **/
+      inline SharedMapConstPtr getMap(void) const
+      {
+        return boost::atomic_load(&_map);
+      }
       
     protected:
     
       //!< The base for the sensor frame_id
       const std::string& _namespace;
-      //!< The environment occupancy grid map
-      const nav_msgs::OccupancyGrid& _map;
+      //!< The shared map of the robot, read through getMap()
+      const SharedMapConstPtr& _map;
+      //!< The pose snapshot of the robot, read by updateTransform()
+      const RobotPoseConstPtr& _robotPose;
       
       //!< Sensor pose relative to robot
       const geometry_msgs::Pose2D _sensorPose;
@@ -121,21 +158,21 @@ namespace stdr_robot {
       const float _updateFrequency;
       //!< Sensor frame id
       const std::string _sensorFrameId;
-      
-      //!< A ROS timer for updating the sensor values
-      ros::Timer _timer;
-      //!< A ROS timer for updating the sensor tf
-      ros::Timer _tfTimer;
+      //!< Sensor frame id with the base, as published
+      const std::string _frameId;
       
       //!< ROS publisher for posting the sensor measurements
       ros::Publisher _publisher;
-      //!< ROS tf listener
-      tf::TransformListener _tfListener;
-      //!< ROS transform from sensor to map
-      tf::StampedTransform _sensorTransform;
+      //!< Transform from sensor to map, as of updateTransform()
+      tf::Transform _sensorTransform;
+      //!< Transform from sensor to robot
+      const tf::Transform _robotToSensor;
+      
+      //!< True if the last update produced a measurement to publish
+      bool _hasMeasurement;
       
-      //!< True if sensor got the _sensorTransform
-      bool _gotTransform;
+      //!< Random numbers of the sensor noise, seeded by the frame id
+      NoiseEngine _noise;
   };
 
   typedef boost::shared_ptr<Sensor> SensorPtr;
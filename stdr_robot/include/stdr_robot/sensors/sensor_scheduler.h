@@ -0,0 +1,139 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+
+#ifndef SENSOR_SCHEDULER_H
+#define SENSOR_SCHEDULER_H
+
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdr_robot/sensors/sensor_base.h>
+#include <stdr_robot/sensors/work_stealing_pool.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class SensorScheduler
+  @brief Updates the sensors of all robots loaded in a process. On every \
+  tick, the sensors that are due are traced in parallel on a work stealing \
+  pool and their measurements are published in frame id order. The number \
+  of worker threads is read from the ~sensor_threads parameter. With \
+  /use_sim_time set, the SimulationStepper ticks the scheduler instead of \
+  its own thread.
+  **/
+  class SensorScheduler {
+
+    public:
+
+      /**
+      @brief Returns the scheduler of the process, created on first use
+      @return SensorScheduler&
+      **/
+      static SensorScheduler& getInstance(void);
+
+      /**
+      @brief Starts updating a sensor at its update frequency
+      @param sensor [const SensorPtr&] The sensor
+      @return void
+      **/
+      void addSensor(const SensorPtr& sensor);
+
+      /**
+      @brief Stops updating a sensor. Blocks while the sensor is being \
+      updated, so the sensor can be destroyed right after.
+      @param sensor [const SensorPtr&] The sensor
+      @return void
+      **/
+      void removeSensor(const SensorPtr& sensor);
+
+      /**
+      @brief Traces the sensors that are due and publishes their measurements
+      @param now [const ros::Time&] The current time
+      @return ros::Time : The time of the next update
+      **/
+      ros::Time tick(const ros::Time& now);
+
+      /**
+      @brief Default destructor. Stops the scheduler thread.
+      @return void
+      **/
+      ~SensorScheduler(void);
+
+    private:
+
+      /**
+      @struct ScheduledSensor
+      @brief A sensor and its update timing
+      **/
+      struct ScheduledSensor {
+        //!< The sensor
+        SensorPtr sensor;
+        //!< The sensor frame id, defines the publishing order
+        std::string frameId;
+        //!< The update period
+        ros::Duration period;
+        //!< The time of the next update
+        ros::Time nextUpdate;
+      };
+
+      /**
+      @brief Default constructor
+      @return void
+      **/
+      SensorScheduler(void);
+
+      /**
+      @brief The scheduler thread loop
+      @return void
+      **/
+      void spin(void);
+
+    private:
+
+      //!< Sensors due within this window are traced in the same tick
+      static const double BATCH_WINDOW;
+      //!< The longest the scheduler sleeps, so new sensors are picked up
+      static const double MAX_SLEEP;
+
+      //!< The scheduled sensors, sorted by frame id
+      std::vector<ScheduledSensor> _sensors;
+      //!< The sensors traced in the current tick
+      std::vector<Sensor*> _dueSensors;
+      //!< The update tasks of the current tick
+      std::vector<WorkStealingPool::Task> _tasks;
+
+      //!< The pool tracing the sensors
+      boost::scoped_ptr<WorkStealingPool> _pool;
+      //!< Held while the sensors are added, removed or updated
+      boost::mutex _mutex;
+      //!< The scheduler thread
+      boost::thread _thread;
+  };
+
+}
+
+#endif
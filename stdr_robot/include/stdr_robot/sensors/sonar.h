@@ -22,7 +22,10 @@
 #ifndef SONAR_H
 #define SONAR_H
 
+#include <vector>
 #include <stdr_robot/sensors/sensor_base.h>
+#include <stdr_robot/sensors/beam_table.h>
+#include <stdr_robot/sensors/range_noise.h>
 #include <sensor_msgs/Range.h>
 #include <stdr_msgs/SonarSensorMsg.h>
 
@@ -41,13 +44,15 @@ namespace stdr_robot {
     public:
       /**
       @brief Default constructor
-      @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+      @param map [const SharedMapConstPtr&] The shared map of the robot
+      @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
       @param msg [const stdr_msgs::SonarSensorMsg&] The sonar description message
       @param name [const std::string&] The sensor frame id without the base
       @param n [ros::NodeHandle&] The ROS node handle
       @return void
       **/ 
-      Sonar(const nav_msgs::OccupancyGrid& map,
+      Sonar(const SharedMapConstPtr& map,
+        const RobotPoseConstPtr& robotPose,
         const stdr_msgs::SonarSensorMsg& msg, 
         const std::string& name, 
         ros::NodeHandle& n);
@@ -68,6 +73,24 @@ namespace stdr_robot {
 
       //!< Sonar sensor description
       stdr_msgs::SonarSensorMsg _description;
+
+      //!< Directions of the rays of the cone, one per degree
+      BeamTable _beams;
+      //!< Ray distances of the last update in cells
+      std::vector<float> _rayDistances;
+      //!< Noise of the sonar range
+      RangeNoise _rangeNoise;
+
+      //!< The last sonar range
+      sensor_msgs::Range _sonarRangeMsg;
+
+    protected:
+
+      /**
+      @brief Publishes the measurement of the last update
+      @return void
+      **/
+      virtual void publishLastMeasurement(void);
   };
 
 }
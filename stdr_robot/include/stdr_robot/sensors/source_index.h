@@ -0,0 +1,261 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef SOURCE_INDEX_H
+#define SOURCE_INDEX_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/ 
+namespace stdr_robot {
+
+  /**
+  @class SourceIndex
+  @brief An immutable uniform grid over point sources, such as rfid tags \
+  or co2, thermal and sound sources. A range query visits the cells \
+  overlapping the range only, so its cost follows the sources nearby \
+  and not the total. Source must have a pose with x and y. Sources \
+  without a finite position are left out.
+  **/
+  template <class Source>
+  class SourceIndex {
+
+    public:
+
+      /**
+      @brief Default constructor. Sorts the sources by cell.
+      @param sources [const std::vector<Source>&] The sources
+      @param cellSize [float] The cell side in meters, positive. The \
+      index is left empty otherwise.
+      @return void
+      **/
+      SourceIndex(const std::vector<Source>& sources, float cellSize)
+        :
+          _cellSize(cellSize),
+          _originX(0),
+          _originY(0),
+          _width(1),
+          _height(1)
+      {
+        //!< A source without a finite position is never in range of a
+        //!< query, and would break the grid bounds
+        std::vector<unsigned int> valid;
+        for ( unsigned int i = 0 ; i < sources.size() ; i++ )
+        {
+          if ( boost::math::isfinite(sources[i].pose.x) &&
+            boost::math::isfinite(sources[i].pose.y) )
+          {
+            valid.push_back(i);
+          }
+        }
+
+        if ( valid.size() == 0 || !( _cellSize > 0 ) )
+        {
+          _cellStarts.assign(2, 0);
+          return;
+        }
+
+        float maxX, maxY;
+        _originX = maxX = sources[ valid[0] ].pose.x;
+        _originY = maxY = sources[ valid[0] ].pose.y;
+        for ( unsigned int i = 1 ; i < valid.size() ; i++ )
+        {
+          const Source& source = sources[ valid[i] ];
+          _originX = std::min<float>(_originX, source.pose.x);
+          _originY = std::min<float>(_originY, source.pose.y);
+          maxX = std::max<float>(maxX, source.pose.x);
+          maxY = std::max<float>(maxY, source.pose.y);
+        }
+
+        //!< Sparse sources over a large area get larger cells, so that
+        //!< the grid stays within a few cells per source. The extent is
+        //!< taken in double, it may not fit in a float.
+        const double extentX = static_cast<double>(maxX) - _originX;
+        const double extentY = static_cast<double>(maxY) - _originY;
+        while ( ( extentX / _cellSize + 1 ) * ( extentY / _cellSize + 1 ) >
+          4.0 * valid.size() + 16 )
+        {
+          _cellSize *= 2;
+        }
+        _width = static_cast<int>( extentX / _cellSize ) + 1;
+        _height = static_cast<int>( extentY / _cellSize ) + 1;
+
+        //!< Counting sort of the sources by cell
+        std::vector<unsigned int> cells( valid.size() );
+        _cellStarts.assign(_width * _height + 1, 0);
+        for ( unsigned int i = 0 ; i < valid.size() ; i++ )
+        {
+          const Source& source = sources[ valid[i] ];
+          cells[i] = getCell(source.pose.x, source.pose.y);
+          _cellStarts[ cells[i] + 1 ]++;
+        }
+        for ( unsigned int c = 0 ; c < _width * _height ; c++ )
+        {
+          _cellStarts[c + 1] += _cellStarts[c];
+        }
+        std::vector<unsigned int> next(
+          _cellStarts.begin(), _cellStarts.end() - 1);
+        _sources.resize( valid.size() );
+        _x.resize( valid.size() );
+        _y.resize( valid.size() );
+        for ( unsigned int i = 0 ; i < valid.size() ; i++ )
+        {
+          const Source& source = sources[ valid[i] ];
+          const unsigned int j = next[ cells[i] ]++;
+          _sources[j] = source;
+          _x[j] = source.pose.x;
+          _y[j] = source.pose.y;
+        }
+      }
+
+      /**
+      @brief Finds the sources within a range of a point
+      @param x [float] The point x in meters
+      @param y [float] The point y in meters
+      @param range [float] The range in meters
+      @param found [std::vector<unsigned int>&] The indexes of the sources \
+      found, for getSource(), cleared first
+      @return void
+      **/
+      void query(float x, float y, float range,
+        std::vector<unsigned int>& found) const
+      {
+        found.clear();
+        if ( _sources.size() == 0 || !(range >= 0) )
+        {
+          return;
+        }
+
+        const int minCellX = std::max( 0,
+          getRangeCell(x - range - _originX, _width) );
+        const int maxCellX = std::min( static_cast<int>(_width) - 1,
+          getRangeCell(x + range - _originX, _width) );
+        const int minCellY = std::max( 0,
+          getRangeCell(y - range - _originY, _height) );
+        const int maxCellY = std::min( static_cast<int>(_height) - 1,
+          getRangeCell(y + range - _originY, _height) );
+
+        //!< The range lies wholly beside the grid
+        if ( minCellX > maxCellX || minCellY > maxCellY )
+        {
+          return;
+        }
+
+        const float rangeSquared = range * range;
+        for ( int cellY = minCellY ; cellY <= maxCellY ; cellY++ )
+        {
+          //!< The cells of a row are contiguous
+          const unsigned int begin = _cellStarts[cellY * _width + minCellX];
+          const unsigned int end = _cellStarts[cellY * _width + maxCellX + 1];
+          for ( unsigned int i = begin ; i < end ; i++ )
+          {
+            const float dx = _x[i] - x;
+            const float dy = _y[i] - y;
+            if ( dx * dx + dy * dy <= rangeSquared )
+            {
+              found.push_back(i);
+            }
+          }
+        }
+      }
+
+      /**
+      @brief Returns a source found by query()
+      @param index [unsigned int] The index of the source
+      @return const Source&
+      **/
+      inline const Source& getSource(unsigned int index) const
+      {
+        return _sources[index];
+      }
+
+      /**
+      @brief Returns the number of sources
+      @return unsigned int
+      **/
+      inline unsigned int size(void) const
+      {
+        return _sources.size();
+      }
+
+    private:
+
+      /**
+      @brief Returns the cell column or row of a range bound, -1 before \
+      the grid and cells past it
+      @param offset [double] The bound from the grid origin in meters
+      @param cells [unsigned int] The grid width or height in cells
+      @return int
+      **/
+      inline int getRangeCell(double offset, unsigned int cells) const
+      {
+        //!< Clamped in double, far away bounds would overflow an int
+        return static_cast<int>( std::min<double>( cells,
+          std::max<double>( -1, floor( offset / _cellSize ) ) ) );
+      }
+
+      /**
+      @brief Returns the cell of a point inside the grid
+      @param x [float] The point x in meters
+      @param y [float] The point y in meters
+      @return unsigned int
+      **/
+      inline unsigned int getCell(float x, float y) const
+      {
+        const int cellX = std::min( static_cast<int>(_width) - 1,
+          static_cast<int>( ( static_cast<double>(x) - _originX ) /
+            _cellSize ) );
+        const int cellY = std::min( static_cast<int>(_height) - 1,
+          static_cast<int>( ( static_cast<double>(y) - _originY ) /
+            _cellSize ) );
+        return cellY * _width + cellX;
+      }
+
+    private:
+
+      //!< The cell side in meters
+      float _cellSize;
+      //!< The corner of the first cell
+      float _originX;
+      float _originY;
+      //!< The grid size in cells
+      unsigned int _width;
+      unsigned int _height;
+
+      //!< First source of every cell, plus the source count
+      std::vector<unsigned int> _cellStarts;
+      //!< The sources, sorted by cell
+      std::vector<Source> _sources;
+      //!< The source positions, sorted by cell
+      std::vector<float> _x;
+      std::vector<float> _y;
+  };
+
+}
+
+#endif
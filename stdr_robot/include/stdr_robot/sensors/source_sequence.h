@@ -0,0 +1,101 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef SOURCE_SEQUENCE_H
+#define SOURCE_SEQUENCE_H
+
+#include <stdint.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/ 
+namespace stdr_robot {
+
+  /**
+  @class SourceSequence
+  @brief Follows the numbered changes of one source list of the server. \
+  Changes are applied in order after a snapshot. Changes before the first \
+  snapshot are part of it. A gap means that changes were lost, and the \
+  subscriber must connect again to get a new snapshot.
+  **/
+  class SourceSequence {
+
+    public:
+
+      /**
+      @enum Action
+      @brief What to do with a received change
+      **/
+      enum Action {
+        APPLY,
+        SKIP,
+        RESYNC
+      };
+
+      /**
+      @brief Default constructor, waiting for a snapshot
+      @return void
+      **/
+      SourceSequence(void)
+        : _sequence(0)
+        , _synced(false)
+      {
+      }
+
+      /**
+      @brief Accounts for a change or a snapshot of the list
+      @param delta [const Delta&] The change, with a sequence number and \
+      a snapshot flag
+      @return Action : APPLY to apply it, SKIP if it is already applied or \
+      comes before the snapshot, RESYNC if changes were lost
+      **/
+      template <class Delta>
+      Action receive(const Delta& delta)
+      {
+        if (delta.snapshot)
+        {
+          _synced = true;
+        }
+        else if (!_synced || delta.sequence <= _sequence)
+        {
+          return SKIP;
+        }
+        else if (delta.sequence != _sequence + 1)
+        {
+          _synced = false;
+          return RESYNC;
+        }
+        _sequence = delta.sequence;
+        return APPLY;
+      }
+
+    private:
+
+      //!< Number of the last applied change
+      uint64_t _sequence;
+      //!< True after a snapshot, until a change is lost
+      bool _synced;
+  };
+
+}
+
+#endif
@@ -0,0 +1,303 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef SOURCE_STORE_H
+#define SOURCE_STORE_H
+
+#include <map>
+#include <ros/ros.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdr_msgs/source_delta.h>
+#include <stdr_msgs/RfidTagDelta.h>
+#include <stdr_msgs/CO2SourceDelta.h>
+#include <stdr_msgs/ThermalSourceDelta.h>
+#include <stdr_msgs/SoundSourceDelta.h>
+#include <stdr_robot/sensors/source_index.h>
+#include <stdr_robot/sensors/source_sequence.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/ 
+namespace stdr_robot {
+
+  /**
+  @brief Returns the id of an rfid tag
+  @param tag [const stdr_msgs::RfidTag&] The tag
+  @return const std::string&
+  **/
+  inline const std::string& getSourceId(const stdr_msgs::RfidTag& tag)
+  {
+    return tag.tag_id;
+  }
+
+  /**
+  @brief Returns the id of a co2, thermal or sound source
+  @param source [const Source&] The source
+  @return const std::string&
+  **/
+  template <class Source>
+  inline const std::string& getSourceId(const Source& source)
+  {
+    return source.id;
+  }
+
+  /**
+  @class SourceMirror
+  @brief Mirrors one source list of the server from its numbered changes \
+  and keeps a spatial index of it. Not thread safe, SourceStore locks it.
+  **/
+  template <class Source, class Delta>
+  class SourceMirror {
+
+    public:
+
+      typedef SourceIndex<Source> Index;
+      typedef boost::shared_ptr<const Index> IndexConstPtr;
+
+      /**
+      @brief Default constructor
+      @return void
+      **/
+      SourceMirror(void)
+        : _dirty(false)
+      {
+      }
+
+      /**
+      @brief Applies a change or a snapshot of the list. Changes before \
+      the first snapshot are ignored, they are part of it.
+      @param delta [const Delta&] The change
+      @return bool : False if changes were lost and a snapshot is needed
+      **/
+      bool apply(const Delta& delta)
+      {
+        const SourceSequence::Action action = _sequence.receive(delta);
+        if (action != SourceSequence::APPLY)
+        {
+          return action == SourceSequence::SKIP;
+        }
+        if (delta.snapshot)
+        {
+          _sources.clear();
+        }
+
+        for (unsigned int i = 0; i < delta.removed.size(); i++)
+        {
+          _sources.erase(delta.removed[i]);
+        }
+        for (unsigned int i = 0; i < delta.added.size(); i++)
+        {
+          _sources[getSourceId(delta.added[i])] = delta.added[i];
+        }
+        _dirty = true;
+        return true;
+      }
+
+      /**
+      @brief Rebuilds the index if the list changed since the last build
+      @param cellSize [float] The cell side of the index in meters
+      @return void
+      **/
+      void rebuild(float cellSize)
+      {
+        if (!_dirty)
+        {
+          return;
+        }
+        std::vector<Source> sources;
+        sources.reserve(_sources.size());
+        for (typename std::map<std::string, Source>::const_iterator it =
+          _sources.begin(); it != _sources.end(); ++it)
+        {
+          sources.push_back(it->second);
+        }
+        IndexConstPtr index(new Index(sources, cellSize));
+        boost::atomic_store(&_index, index);
+        _dirty = false;
+      }
+
+      /**
+      @brief Returns the last built index
+      @return IndexConstPtr : Null until the first snapshot is received
+      **/
+      inline IndexConstPtr getIndex(void) const
+      {
+        return boost::atomic_load(&_index);
+      }
+
+    private:
+
+      //!< The sources by id
+      std::map<std::string, Source> _sources;
+      //!< The changes applied so far
+      SourceSequence _sequence;
+      //!< True if _sources changed after the index was built
+      bool _dirty;
+      //!< The index, replaced as a whole
+      IndexConstPtr _index;
+  };
+
+  typedef SourceMirror<stdr_msgs::RfidTag, stdr_msgs::RfidTagDelta>
+    RfidTagMirror;
+  typedef RfidTagMirror::Index RfidTagIndex;
+  typedef RfidTagMirror::IndexConstPtr RfidTagIndexConstPtr;
+  typedef SourceMirror<stdr_msgs::CO2Source, stdr_msgs::CO2SourceDelta>
+    CO2SourceMirror;
+  typedef CO2SourceMirror::Index CO2SourceIndex;
+  typedef CO2SourceMirror::IndexConstPtr CO2SourceIndexConstPtr;
+  typedef SourceMirror<stdr_msgs::ThermalSource, stdr_msgs::ThermalSourceDelta>
+    ThermalSourceMirror;
+  typedef ThermalSourceMirror::Index ThermalSourceIndex;
+  typedef ThermalSourceMirror::IndexConstPtr ThermalSourceIndexConstPtr;
+  typedef SourceMirror<stdr_msgs::SoundSource, stdr_msgs::SoundSourceDelta>
+    SoundSourceMirror;
+  typedef SoundSourceMirror::Index SoundSourceIndex;
+  typedef SoundSourceMirror::IndexConstPtr SoundSourceIndexConstPtr;
+
+  /**
+  @class SourceStore
+  @brief Keeps the rfid tags and the co2, thermal and sound sources of the \
+  server in one spatial index per kind, shared by all sensors of the \
+  process. Subscribes to the change topics once, and rebuilds the index \
+  of a changed kind at most every ~source_rebuild_period seconds, so that \
+  a burst of additions costs one build. The cell side is read from the \
+  ~source_cell_size parameter.
+  **/
+  class SourceStore {
+
+    public:
+
+      /**
+      @brief Returns the source store of the process, created on first use
+      @return SourceStore&
+      **/
+      static SourceStore& getInstance(void);
+
+      /**
+      @brief Returns the index of the rfid tags
+      @return RfidTagIndexConstPtr : Null until the list is received
+      **/
+      inline RfidTagIndexConstPtr getRfidTags(void) const
+      {
+        return _rfidTags.getIndex();
+      }
+
+      /**
+      @brief Returns the index of the co2 sources
+      @return CO2SourceIndexConstPtr : Null until the list is received
+      **/
+      inline CO2SourceIndexConstPtr getCO2Sources(void) const
+      {
+        return _co2Sources.getIndex();
+      }
+
+      /**
+      @brief Returns the index of the thermal sources
+      @return ThermalSourceIndexConstPtr : Null until the list is received
+      **/
+      inline ThermalSourceIndexConstPtr getThermalSources(void) const
+      {
+        return _thermalSources.getIndex();
+      }
+
+      /**
+      @brief Returns the index of the sound sources
+      @return SoundSourceIndexConstPtr : Null until the list is received
+      **/
+      inline SoundSourceIndexConstPtr getSoundSources(void) const
+      {
+        return _soundSources.getIndex();
+      }
+
+    private:
+
+      /**
+      @brief Default constructor
+      @return void
+      **/
+      SourceStore(void);
+
+      /**
+      @brief Applies a change of the rfid tags
+      @param msg [const stdr_msgs::RfidTagDeltaConstPtr&] The change
+      @return void
+      **/
+      void receiveRfidTags(const stdr_msgs::RfidTagDeltaConstPtr& msg);
+
+      /**
+      @brief Applies a change of the co2 sources
+      @param msg [const stdr_msgs::CO2SourceDeltaConstPtr&] The change
+      @return void
+      **/
+      void receiveCO2Sources(const stdr_msgs::CO2SourceDeltaConstPtr& msg);
+
+      /**
+      @brief Applies a change of the thermal sources
+      @param msg [const stdr_msgs::ThermalSourceDeltaConstPtr&] The change
+      @return void
+      **/
+      void receiveThermalSources(
+        const stdr_msgs::ThermalSourceDeltaConstPtr& msg);
+
+      /**
+      @brief Applies a change of the sound sources
+      @param msg [const stdr_msgs::SoundSourceDeltaConstPtr&] The change
+      @return void
+      **/
+      void receiveSoundSources(
+        const stdr_msgs::SoundSourceDeltaConstPtr& msg);
+
+      /**
+      @brief Rebuilds the indexes of the changed lists
+      @param event [const ros::TimerEvent&] The timer event
+      @return void
+      **/
+      void rebuildIndexes(const ros::TimerEvent& event);
+
+    private:
+
+      //!< The cell side of the indexes in meters
+      double _cellSize;
+
+      //!< ROS node handle of the subscriptions
+      ros::NodeHandle _nodeHandle;
+      //!< ROS subscribers for the source list changes
+      ros::Subscriber _rfidTagsSubscriber;
+      ros::Subscriber _co2SourcesSubscriber;
+      ros::Subscriber _thermalSourcesSubscriber;
+      ros::Subscriber _soundSourcesSubscriber;
+      //!< Rebuilds the indexes of the changed lists
+      ros::Timer _rebuildTimer;
+
+      //!< Serializes the changes and the rebuilds
+      boost::mutex _mutex;
+      //!< The source lists and their indexes, read through the getters
+      RfidTagMirror _rfidTags;
+      CO2SourceMirror _co2Sources;
+      ThermalSourceMirror _thermalSources;
+      SoundSourceMirror _soundSources;
+  };
+
+}
+
+#endif
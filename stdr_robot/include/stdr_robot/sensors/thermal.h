@@ -26,7 +26,7 @@
 #include <stdr_robot/sensors/helper.h>
 #include <stdr_msgs/ThermalSensorMsg.h>
 #include <stdr_msgs/ThermalSensorMeasurementMsg.h>
-#include <stdr_msgs/ThermalSourceVector.h>
+#include <stdr_robot/sensors/source_store.h>
 
 /**
 @namespace stdr_robot
@@ -44,7 +44,8 @@ namespace stdr_robot {
     public:
       /**
       @brief Default constructor
-      @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+      @param map [const SharedMapConstPtr&] The shared map of the robot
+      @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
       @param msg [const stdr_msgs::ThermalSensorMsg&] The thermal sensor \
       description message
       @param name [const std::string&] The sensor frame id without the base
@@ -52,7 +53,8 @@ namespace stdr_robot {
       @return void
       **/ 
       ThermalSensor(
-        const nav_msgs::OccupancyGrid& map,
+        const SharedMapConstPtr& map,
+        const RobotPoseConstPtr& robotPose,
         const stdr_msgs::ThermalSensorMsg& msg, 
         const std::string& name, 
         ros::NodeHandle& n);
@@ -69,23 +71,24 @@ namespace stdr_robot {
       **/ 
       ~ThermalSensor(void);
       
-      /**
-      @brief Receives the existent sound sources
-      @param msg [const stdr_msgs::ThermalSourceVector&] The thermal sources message
-      @return void
-      **/
-      void receiveThermalSources(const stdr_msgs::ThermalSourceVector& msg);
-
     private:
 
       //!< thermal sensor description
       stdr_msgs::ThermalSensorMsg _description;
       
-      //!< ROS subscriber for sound sources
-      ros::Subscriber thermal_sources_subscriber_;
-      
-      //!< The currently existent sources
-      stdr_msgs::ThermalSourceVector thermal_sources_;
+      //!< Indexes of the sources found by the last update
+      std::vector<unsigned int> _foundSources;
+
+      //!< The last thermal measurement
+      stdr_msgs::ThermalSensorMeasurementMsg _measuredSourcesMsg;
+
+    protected:
+
+      /**
+      @brief Publishes the measurement of the last update
+      @return void
+      **/
+      virtual void publishLastMeasurement(void);
   };
 
 
@@ -0,0 +1,136 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <deque>
+#include <utility>
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class WorkStealingPool
+  @brief Fixed size pool of worker threads. Every worker owns a queue of \
+  tasks and steals from the other queues when its own runs dry.
+  **/
+  class WorkStealingPool {
+
+    public:
+
+      typedef boost::function<void(void)> Task;
+
+      /**
+      @brief Default constructor
+      @param threads [unsigned int] The number of worker threads. With zero \
+      threads the tasks run on the calling thread.
+      @return void
+      **/
+      explicit WorkStealingPool(unsigned int threads);
+
+      /**
+      @brief Runs a batch of tasks and blocks until all of them finish
+      @param tasks [const std::vector<Task>&] The tasks
+      @return void
+      **/
+      void run(const std::vector<Task>& tasks);
+
+      /**
+      @brief Returns the number of worker threads
+      @return unsigned int
+      **/
+      inline unsigned int getThreadCount(void) const
+      {
+        return _queues.size();
+      }
+
+      /**
+      @brief Default destructor. Joins the worker threads.
+      @return void
+      **/
+      ~WorkStealingPool(void);
+
+    private:
+
+      //!< A task of a batch, by index
+      typedef std::pair<const std::vector<Task>*, size_t> TaskRef;
+
+      /**
+      @struct TaskQueue
+      @brief The queue of task indexes owned by one worker
+      **/
+      struct TaskQueue {
+        boost::mutex mutex;
+        std::deque<TaskRef> tasks;
+      };
+
+      /**
+      @brief The worker thread loop
+      @param worker [unsigned int] The worker index
+      @return void
+      **/
+      void workerLoop(unsigned int worker);
+
+      /**
+      @brief Pops a task from the front of the worker's own queue, or \
+      steals one from the back of another queue
+      @param worker [unsigned int] The worker index
+      @param task [TaskRef&] The task found
+      @return bool : False when every queue is empty
+      **/
+      bool nextTask(unsigned int worker, TaskRef& task);
+
+    private:
+
+      //!< One task queue per worker
+      std::vector<boost::shared_ptr<TaskQueue> > _queues;
+      //!< The worker threads
+      boost::thread_group _threads;
+
+      //!< Tasks of the current batch not finished yet
+      size_t _pending;
+      //!< Incremented on every batch, wakes up the workers
+      unsigned long _generation;
+      //!< Set on destruction
+      bool _stop;
+
+      //!< Protects the batch state
+      boost::mutex _mutex;
+      //!< Signals a new batch to the workers
+      boost::condition_variable _batchStarted;
+      //!< Signals the end of a batch to run()
+      boost::condition_variable _batchFinished;
+  };
+
+}
+
+#endif
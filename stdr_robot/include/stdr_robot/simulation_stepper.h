@@ -0,0 +1,135 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef SIMULATION_STEPPER_H
+#define SIMULATION_STEPPER_H
+
+#include <vector>
+#include <ros/ros.h>
+#include <ros/callback_queue.h>
+#include <rosgraph_msgs/Clock.h>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <stdr_robot/fleet_state.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  class Robot;
+
+  /**
+  @class SimulationStepper
+  @brief Steps the robots of a process in lockstep with the /clock of \
+  stdr_server, when /use_sim_time is set. On every tick the fleet of all \
+  robots moves in one pass and the robots check their collisions in name \
+  order, then the SensorScheduler updates the sensors and the \
+  TransformPublisher the tf transforms that are due, and the step is \
+  reported done to the server.
+  **/
+  class SimulationStepper {
+
+    public:
+
+      /**
+      @brief Returns the stepper of the process, created on first use
+      @return SimulationStepper&
+      **/
+      static SimulationStepper& getInstance(void);
+
+      /**
+      @brief Starts stepping a robot
+      @param name [const std::string&] The robot name, defines the step order
+      @param robot [Robot*] The robot
+      @return void
+      **/
+      void addRobot(const std::string& name, Robot* robot);
+
+      /**
+      @brief Stops stepping a robot. Blocks while a step is in progress, \
+      so the robot can be destroyed right after.
+      @param robot [Robot*] The robot
+      @return void
+      **/
+      void removeRobot(Robot* robot);
+
+      /**
+      @brief Returns the fleet of the stepped robots
+      @return FleetState&
+      **/
+      inline FleetState& getFleet(void)
+      {
+        return _fleet;
+      }
+
+      /**
+      @brief Default destructor. Stops the stepper thread.
+      @return void
+      **/
+      ~SimulationStepper(void);
+
+    private:
+
+      /**
+      @brief Default constructor
+      @return void
+      **/
+      SimulationStepper(void);
+
+      /**
+      @brief The stepper thread loop
+      @return void
+      **/
+      void spin(void);
+
+      /**
+      @brief Callback of the /clock ticks, steps the simulation
+      @param msg [const rosgraph_msgs::ClockConstPtr&] The tick
+      @return void
+      **/
+      void clockCallback(const rosgraph_msgs::ClockConstPtr& msg);
+
+    private:
+
+      //!< The stepped robots and their names, sorted by name
+      std::vector<std::pair<std::string, Robot*> > _robots;
+      //!< The time of the last tick
+      ros::Time _lastTime;
+      //!< The poses and velocities of the stepped robots
+      FleetState _fleet;
+
+      //!< Callback queue of the ticks, served by the stepper thread
+      ros::CallbackQueue _queue;
+      //!< ROS subscriber for /clock
+      ros::Subscriber _clockSubscriber;
+      //!< ROS publisher of the step reports
+      ros::Publisher _stepDonePublisher;
+      //!< Held while the robots are added, removed or stepped
+      boost::mutex _mutex;
+      //!< The stepper thread
+      boost::thread _thread;
+  };
+
+}
+
+#endif
@@ -24,10 +24,15 @@
 
 #include <ros/ros.h>
 #include <nodelet/nodelet.h>
-#include <tf/transform_broadcaster.h>
+#include <tf/transform_datatypes.h>
 #include <stdr_msgs/RobotMsg.h>
 #include <stdr_msgs/MoveRobot.h>
 #include <stdr_robot/sensors/sensor_base.h>
+#include <stdr_robot/sensors/sensor_scheduler.h>
+#include <stdr_robot/map_store.h>
+#include <stdr_robot/collision_checker.h>
+#include <stdr_robot/simulation_stepper.h>
+#include <stdr_robot/transform_publisher.h>
 #include <stdr_robot/sensors/laser.h>
 #include <stdr_robot/sensors/sonar.h>
 #include <stdr_robot/sensors/rfid_reader.h>
@@ -40,6 +45,8 @@
 #include <nav_msgs/OccupancyGrid.h>
 #include <nav_msgs/Odometry.h>
 #include <actionlib/client/simple_action_client.h>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <stdr_msgs/RegisterRobotAction.h>
 
 /**
@@ -51,6 +58,9 @@ namespace stdr_robot {
   typedef actionlib::SimpleActionClient<stdr_msgs::RegisterRobotAction> 
     RegisterRobotClient;
   typedef boost::shared_ptr<RegisterRobotClient> RegisterRobotClientPtr;
+  
+  class Robot;
+  typedef boost::shared_ptr<Robot> RobotPtr;
 
   /**
   @class Robot
@@ -66,6 +76,20 @@ namespace stdr_robot {
     **/
     Robot(void);
     
+    /**
+    @brief Creates a robot of a RobotPool, without the nodelet load and \
+    register handshake. The pool steps the robot and gives it the map.
+    @param name [const std::string&] The robot frame_id
+    @param description [const stdr_msgs::RobotMsg&] The robot description
+    @param map [const SharedMapConstPtr&] The current map, null if none
+    @param fleet [FleetState&] The fleet of the pool. In lockstep the \
+    robot joins the fleet of the SimulationStepper instead.
+    @param n [ros::NodeHandle&] The node handle of the pool
+    @return void
+    **/
+    Robot(const std::string& name, const stdr_msgs::RobotMsg& description,
+      const SharedMapConstPtr& map, FleetState& fleet, ros::NodeHandle& n);
+    
     /**
     @brief Initializes the robot and gets the environment occupancy grid map
     @return void
@@ -88,6 +112,13 @@ namespace stdr_robot {
     **/
     void mapCallback(const nav_msgs::OccupancyGridConstPtr& msg);
     
+    /**
+    @brief Sets the map of the robot and its sensors
+    @param map [const SharedMapConstPtr&] The map shared by the robots
+    @return void
+    **/
+    void setMap(const SharedMapConstPtr& map);
+    
     /**
     @brief The callback of the re-place robot service
     @param req [stdr_msgs::MoveRobot::Request&] The service request
@@ -96,6 +127,15 @@ namespace stdr_robot {
     **/
     bool moveRobotCallback(stdr_msgs::MoveRobot::Request& req,
       stdr_msgs::MoveRobot::Response& res);
+    
+    /**
+    @brief Advances the robot by one tick of its collision timer, or of \
+    the lockstep simulation, after its fleet has moved. Resolves the \
+    collisions of the motion and sets the sensor poses.
+    @param now [const ros::Time&] The time of the tick
+    @return void
+    **/
+    void step(const ros::Time& now);
       
     /**
     @brief Default destructor
@@ -106,16 +146,23 @@ namespace stdr_robot {
    private:
    
     /**
-    @brief Checks the robot collision -2b changed-
+    @brief Advertises the robot topics and services and reads its rates
+    @param n [ros::NodeHandle&] The node handle of the robot topics
+    @param pn [ros::NodeHandle&] The node handle of the robot parameters
     @return void
     **/
-    bool collisionExists(
-      const geometry_msgs::Pose2D& newPose, 
-      const geometry_msgs::Pose2D& collisionPoint);
-      
-    bool collisionExistsNoPath(
-      const geometry_msgs::Pose2D& newPose); 
-
+    void advertise(ros::NodeHandle& n, ros::NodeHandle& pn);
+    
+    /**
+    @brief Creates the sensors and motion controller of the description \
+    and starts stepping the robot
+    @param description [const stdr_msgs::RobotMsg&] The robot description
+    @param n [ros::NodeHandle&] The node handle of the robot topics
+    @return void
+    **/
+    void loadDescription(const stdr_msgs::RobotMsg& description,
+      ros::NodeHandle& n);
+   
     /**
     @brief Checks the robot's reposition into unknown area
     @param newPose [const geometry_msgs::Pose2D] The pose for the robot to be moved to
@@ -124,19 +171,47 @@ namespace stdr_robot {
     bool checkUnknownOccupancy(const geometry_msgs::Pose2D& newPose);
 
     /**
-    @brief Publishes the tf transforms every with 10Hz
+    @brief Accepts the pose of the motion controller up to the first \
+    contact of its motion. With sliding on, the rest of the motion along \
+    the contact is kept.
     @return void
     **/
-    void publishTransforms(const ros::TimerEvent&);
+    void updatePose(void);
+
+    /**
+    @brief Steps the robot on its collision timer
+    @param event [const ros::TimerEvent&] A ROS timer event
+    @return void
+    **/
+    void updateCallback(const ros::TimerEvent& event);
+
+    /**
+    @brief Publishes the odometry. The TransformPublisher sends the tf.
+    @param now [const ros::Time&] The stamp of the odometry
+    @return void
+    **/
+    void publishOdometry(const ros::Time& now);
    
    
    private:
   
+    //!< The robot frame_id, the nodelet name unless pooled
+    std::string _name;
+    
     //!< ROS subscriber for map
     ros::Subscriber _mapSubscriber;
     
-    //!< ROS timer to publish tf transforms (10Hz)
-    ros::Timer _tfTimer;
+    //!< ROS timer stepping the robot at its collision rate
+    ros::Timer _updateTimer;
+    
+    //!< Time of the last step on the collision timer
+    ros::Time _lastUpdate;
+    
+    //!< Period of the odometry publication
+    ros::Duration _publishPeriod;
+    
+    //!< Next odometry publication
+    ros::Time _nextOdomPublish;
     
     //!< ROS service server to move robot
     ros::ServiceServer _moveRobotService;
@@ -144,12 +219,9 @@ namespace stdr_robot {
     //!< Container for robot sensors
     SensorPtrVector _sensors;
     
-    //!< The occupancy grid map
-    nav_msgs::OccupancyGrid _map;
+    //!< The map shared by all robots of the process, null until received
+    SharedMapConstPtr _map;
     
-    //!< ROS tf transform broadcaster
-    tf::TransformBroadcaster _tfBroadcaster;
-
     //!< Odometry Publisher
     ros::Publisher _odomPublisher;
     
@@ -159,23 +231,32 @@ namespace stdr_robot {
     //!< Holds robots previous pose
     geometry_msgs::Pose2D _previousPose;
     
+    //!< Guards the poses against the replace service while the robot steps
+    boost::mutex _poseMutex;
+    
+    //!< Snapshot of _previousPose for the sensors, null until loaded
+    RobotPoseConstPtr _robotPose;
+    
+    //!< The fleet holding the robot pose and velocity
+    FleetState* _fleet;
+    
+    //!< The fleet of a robot on its own timer, outlives the controller
+    boost::scoped_ptr<FleetState> _ownFleet;
+    
     //!< Pointer of a motion controller
     MotionControllerPtr _motionControllerPtr;
     
     //!< Actionlib client for registering the robot
     RegisterRobotClientPtr _registerClientPtr;
   
-    //!< The robot footprint in points (row * 10000 + col)
-    std::vector<std::pair<float,float> > _footprint;
-    
-    std::vector<std::pair<int,int> > getPointsBetween(
-      int x1, int y1, int x2, int y2) ;
-    
-    //!< Robot's previous movement direction in X Axis
-    bool _previousMovementXAxis;
+    //!< Checks the robot footprint against the map
+    CollisionCheckerPtr _collisionChecker;
 
-    //!< Robot's previous movement direction in Y Axis
-    bool _previousMovementYAxis;
+    //!< True to slide along obstacles instead of stopping at them
+    bool _slideOnCollision;
+    
+    //!< True when a RobotPool steps the robot instead of its timer
+    bool _pooled;
   };  
   
 } // namespace stdr_robot
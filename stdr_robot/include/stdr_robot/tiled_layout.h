@@ -0,0 +1,97 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef TILED_LAYOUT_H
+#define TILED_LAYOUT_H
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @struct TiledLayout
+  @brief Memory layout of the grids derived from the map. Cells are stored \
+  in 8x8 tiles, row major inside a tile and tiles row major in the map, so \
+  that neighbouring cells share memory whichever the direction of a ray. \
+  The map is padded to whole tiles.
+  **/
+  struct TiledLayout {
+
+    //!< log2 of the tile side
+    static const int TILE_SHIFT = 3;
+    //!< Tile side in cells
+    static const int TILE_SIZE = 1 << TILE_SHIFT;
+    //!< Cells of a tile
+    static const int TILE_CELLS = TILE_SIZE * TILE_SIZE;
+
+    //!< Map width in cells
+    int width;
+    //!< Map height in cells
+    int height;
+    //!< Number of tiles of a tile row
+    int tilesPerRow;
+    //!< Number of tile rows
+    int tileRows;
+
+    /**
+    @brief Sets the map size
+    @param mapWidth [int] The map width in cells
+    @param mapHeight [int] The map height in cells
+    @return void
+    **/
+    inline void resize(int mapWidth, int mapHeight)
+    {
+      width = mapWidth;
+      height = mapHeight;
+      tilesPerRow = ( width + TILE_SIZE - 1 ) >> TILE_SHIFT;
+      tileRows = ( height + TILE_SIZE - 1 ) >> TILE_SHIFT;
+    }
+
+    /**
+    @brief Returns the number of stored cells, padding included
+    @return int
+    **/
+    inline int size(void) const
+    {
+      return tilesPerRow * tileRows * TILE_CELLS;
+    }
+
+    /**
+    @brief Returns the storage index of a cell inside the map. The tile of \
+    the cell is index / TILE_CELLS.
+    @param x [int] The cell x
+    @param y [int] The cell y
+    @return int
+    **/
+    inline int index(int x, int y) const
+    {
+      return ( ( ( y >> TILE_SHIFT ) * tilesPerRow + ( x >> TILE_SHIFT ) )
+        << ( 2 * TILE_SHIFT ) ) |
+        ( ( y & ( TILE_SIZE - 1 ) ) << TILE_SHIFT ) |
+        ( x & ( TILE_SIZE - 1 ) );
+    }
+  };
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef TRANSFORM_PUBLISHER_H
+#define TRANSFORM_PUBLISHER_H
+
+#include <string>
+#include <vector>
+#include <ros/ros.h>
+#include <tf2_msgs/TFMessage.h>
+#include <geometry_msgs/TransformStamped.h>
+#include <boost/thread/mutex.hpp>
+#include <stdr_robot/sensors/sensor_base.h>
+
+/**
+@namespace stdr_robot
+@brief The main namespace for STDR Robot
+**/
+namespace stdr_robot {
+
+  /**
+  @class TransformPublisher
+  @brief Publishes the tf transforms of all robots of a process. The \
+  sensor frames are fixed on their robots, so they are published on \
+  /tf_static only on the first tick after robots are added or removed. \
+  The robot frames of all robots go out in one message per tick, with \
+  one stamp, at the ~publish_rate of the process. In lockstep \
+  the SimulationStepper ticks it after every step, otherwise a timer does.
+  **/
+  class TransformPublisher {
+
+    public:
+
+      /**
+      @brief Returns the transform publisher of the process, created on \
+      first use
+      @return TransformPublisher&
+      **/
+      static TransformPublisher& getInstance(void);
+
+      /**
+      @brief Starts publishing the transforms of a robot
+      @param frameId [const std::string&] The robot frame id
+      @param pose [const RobotPoseConstPtr&] The pose snapshot of the \
+      robot, must outlive removeRobot()
+      @param sensors [const std::vector<geometry_msgs::TransformStamped>&] \
+      The transforms from the robot to its sensors
+      @return void
+      **/
+      void addRobot(const std::string& frameId,
+        const RobotPoseConstPtr& pose,
+        const std::vector<geometry_msgs::TransformStamped>& sensors);
+
+      /**
+      @brief Stops publishing the transforms of a robot. Blocks while a \
+      tick is in progress, so the robot can be destroyed right after.
+      @param frameId [const std::string&] The robot frame id
+      @return void
+      **/
+      void removeRobot(const std::string& frameId);
+
+      /**
+      @brief Publishes the sensor transforms if robots were added or \
+      removed, and the robot transforms if they are due
+      @param now [const ros::Time&] The current time, stamp of the transforms
+      @return void
+      **/
+      void tick(const ros::Time& now);
+
+    private:
+
+      /**
+      @brief Default constructor
+      @return void
+      **/
+      TransformPublisher(void);
+
+      /**
+      @brief Ticks on the publish timer, when not in lockstep
+      @param event [const ros::TimerEvent&] The timer event
+      @return void
+      **/
+      void timerCallback(const ros::TimerEvent& event);
+
+      /**
+      @brief Publishes the sensor transforms of all robots. Call locked.
+      @return void
+      **/
+      void publishStatic(void);
+
+    private:
+
+      /**
+      @struct PublishedRobot
+      @brief A robot frame, its pose and its sensor frames
+      **/
+      struct PublishedRobot
+      {
+        std::string frameId;
+        const RobotPoseConstPtr* pose;
+        std::vector<geometry_msgs::TransformStamped> sensors;
+      };
+
+      //!< The published robots
+      std::vector<PublishedRobot> _robots;
+      //!< The robot transforms of the last tick, reused between ticks
+      tf2_msgs::TFMessage _message;
+      //!< Period of the robot transforms
+      ros::Duration _publishPeriod;
+      //!< Time of the next robot transforms
+      ros::Time _nextPublish;
+      //!< True if robots were added or removed since the last sensor
+      //!< transforms
+      bool _staticChanged;
+
+      //!< ROS node handle of the publishers
+      ros::NodeHandle _nodeHandle;
+      //!< ROS publisher of the robot transforms
+      ros::Publisher _tfPublisher;
+      //!< ROS publisher of the sensor transforms, latched
+      ros::Publisher _staticPublisher;
+      //!< Ticks the publisher when not in lockstep
+      ros::Timer _timer;
+      //!< Held while the robots are added, removed or published
+      boost::mutex _mutex;
+  };
+
+}
+
+#endif
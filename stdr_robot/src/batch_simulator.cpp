@@ -0,0 +1,280 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/batch_simulator.h>
+#include <stdr_robot/fleet_state.h>
+#include <algorithm>
+#include <limits>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+namespace stdr_robot {
+
+  const unsigned int BatchSimulator::CHUNK_SIZE = 16;
+
+  /**
+  @brief Default constructor
+  @param config [const BatchSimulatorConfig&] The simulator settings
+  @return void
+  **/
+  BatchSimulator::BatchSimulator(const BatchSimulatorConfig& config)
+    :
+      _config(config)
+  {
+    _pool.reset( new WorkStealingPool(_config.threads) );
+    _laserOffsets.push_back(0);
+    _rangesOffsets.push_back(0);
+  }
+
+  /**
+  @brief Builds the shared map of a map message with the map settings \
+  of the simulator
+  @param grid [const nav_msgs::OccupancyGridConstPtr&] The map message
+  @return SharedMapConstPtr
+  **/
+  SharedMapConstPtr BatchSimulator::loadMap(
+    const nav_msgs::OccupancyGridConstPtr& grid) const
+  {
+    return SharedMapConstPtr( new SharedMap(grid,
+      _config.occupancyThreshold, _config.maxDistanceTransformCells) );
+  }
+
+  /**
+  @brief Adds a robot at its initial pose
+  @param map [const SharedMapConstPtr&] The map of the robot
+  @param description [const stdr_msgs::RobotMsg&] The robot description
+  @return unsigned int : The robot index
+  **/
+  unsigned int BatchSimulator::addRobot(const SharedMapConstPtr& map,
+    const stdr_msgs::RobotMsg& description)
+  {
+    const unsigned int robot = _x.size();
+
+    _x.push_back(description.initialPose.x);
+    _y.push_back(description.initialPose.y);
+    _theta.push_back(description.initialPose.theta);
+    _collisions.push_back(0);
+    _previousX.push_back(description.initialPose.x);
+    _previousY.push_back(description.initialPose.y);
+    _previousTheta.push_back(description.initialPose.theta);
+    _omni.push_back(description.kinematicModel.type == "omni" ? 1 : 0);
+    _lateralCommands.push_back(0);
+    _maps.push_back(map);
+    _collisionCheckers.push_back( CollisionChecker(description.footprint) );
+
+    for ( unsigned int i = 0; i < description.laserSensors.size(); i++ )
+    {
+      const stdr_msgs::LaserSensorMsg& msg = description.laserSensors[i];
+
+      BatchLaser laser;
+      laser.pose = msg.pose;
+      laser.minRange = msg.minRange;
+      laser.maxRange = msg.maxRange;
+      laser.noise.reset( new RangeNoise(msg.noise, msg.maxRange,
+        _config.rangeDropoutProbability,
+        _config.rangeMaxReturnProbability) );
+      laser.engine.reset( new NoiseEngine( _config.noiseSeed, "batch_" +
+        boost::lexical_cast<std::string>(robot) + "_" + msg.frame_id ) );
+
+      //!< Same beams as the Laser sensor
+      int divisions = 1;
+      if ( msg.numRays > 1 )
+      {
+        divisions = msg.numRays - 1;
+      }
+      for ( int j = 0; j < msg.numRays; j++ )
+      {
+        laser.beams.addBeam( msg.minAngle + j *
+          ( msg.maxAngle - msg.minAngle ) / divisions );
+      }
+
+      _ranges.resize( _ranges.size() + laser.beams.size(),
+        std::numeric_limits<float>::infinity() );
+      _lasers.push_back(laser);
+    }
+    _laserOffsets.push_back( _lasers.size() );
+    _rangesOffsets.push_back( _ranges.size() );
+
+    //!< One task per chunk, the last chunk may grow
+    if ( robot % CHUNK_SIZE == 0 )
+    {
+      _tasks.push_back( WorkStealingPool::Task() );
+    }
+    _tasks.back() = boost::bind(&BatchSimulator::stepRobots, this,
+      robot - robot % CHUNK_SIZE, robot + 1);
+
+    traceLasers(robot);
+    return robot;
+  }
+
+  /**
+  @brief Moves a robot. Does not check for collisions.
+  @param robot [unsigned int] The robot index
+  @param pose [const geometry_msgs::Pose2D&] The new pose
+  @return void
+  **/
+  void BatchSimulator::setPose(unsigned int robot,
+    const geometry_msgs::Pose2D& pose)
+  {
+    _x[robot] = pose.x;
+    _y[robot] = pose.y;
+    _theta[robot] = pose.theta;
+    _collisions[robot] = 0;
+    traceLasers(robot);
+  }
+
+  /**
+  @brief Advances all robots by one time step and traces their lasers
+  @param linear [const float*] Forward velocity command of every robot
+  @param lateral [const float*] Lateral velocity command of every robot
+  @param angular [const float*] Angular velocity command of every robot
+  @param dt [float] The time step in seconds
+  @return void
+  **/
+  void BatchSimulator::step(const float* linear, const float* lateral,
+    const float* angular, float dt)
+  {
+    const unsigned int count = _x.size();
+    if ( count == 0 )
+    {
+      return;
+    }
+
+    //!< All robots move in one vectorized pass, the chunks then resolve
+    //!< the collisions of the motion from the previous poses
+    _previousX = _x;
+    _previousY = _y;
+    _previousTheta = _theta;
+    for ( unsigned int i = 0; i < count; i++ )
+    {
+      _lateralCommands[i] = lateral[i] * _omni[i];
+    }
+    FleetState::integrateMotion(&_x[0], &_y[0], &_theta[0],
+      linear, &_lateralCommands[0], angular, count, dt);
+
+    _pool->run(_tasks);
+  }
+
+  /**
+  @brief Resolves the collisions of the motion of a chunk of robots and \
+  traces their lasers
+  @param begin [unsigned int] The first robot
+  @param end [unsigned int] One past the last robot
+  @return void
+  **/
+  void BatchSimulator::stepRobots(unsigned int begin, unsigned int end)
+  {
+    for ( unsigned int robot = begin; robot < end; robot++ )
+    {
+      geometry_msgs::Pose2D previousPose;
+      previousPose.x = _previousX[robot];
+      previousPose.y = _previousY[robot];
+      previousPose.theta = _previousTheta[robot];
+
+      geometry_msgs::Pose2D pose;
+      pose.x = _x[robot];
+      pose.y = _y[robot];
+      pose.theta = _theta[robot];
+
+      //!< Motion stops at the first contact, as it does for Robot
+      _collisions[robot] = 0;
+      if ( _maps[robot] )
+      {
+        const Contact contact = _collisionCheckers[robot].sweep(
+          *_maps[robot], pose, previousPose);
+        if ( contact.time < 1 )
+        {
+          _collisions[robot] = 1;
+          pose = CollisionChecker::interpolate(
+            previousPose, pose, contact.time);
+        }
+      }
+      _x[robot] = pose.x;
+      _y[robot] = pose.y;
+      _theta[robot] = pose.theta;
+
+      traceLasers(robot);
+    }
+  }
+
+  /**
+  @brief Traces the lasers of a robot at its current pose
+  @param robot [unsigned int] The robot index
+  @return void
+  **/
+  void BatchSimulator::traceLasers(unsigned int robot)
+  {
+    const SharedMapConstPtr& map = _maps[robot];
+    if ( getRangesCount(robot) == 0 || !map ||
+      map->getGrid().info.height == 0 || map->getGrid().info.width == 0 )
+    {
+      return;
+    }
+    const float resolution = map->getGrid().info.resolution;
+
+    tf::Transform mapToRobot(tf::createQuaternionFromYaw(_theta[robot]),
+      tf::Vector3(_x[robot], _y[robot], 0));
+
+    float* ranges = &_ranges[0] + _rangesOffsets[robot];
+    for ( unsigned int i = _laserOffsets[robot];
+      i < _laserOffsets[robot + 1]; i++ )
+    {
+      BatchLaser& laser = _lasers[i];
+      if ( laser.beams.size() == 0 )
+      {
+        continue;
+      }
+
+      tf::Transform robotToSensor(
+        tf::createQuaternionFromYaw(laser.pose.theta),
+        tf::Vector3(laser.pose.x, laser.pose.y, 0));
+      tf::Transform sensorTransform = mapToRobot * robotToSensor;
+
+      laser.beams.rotate(sensorTransform);
+
+      //!< Distances in cells are traced in place, then turned into ranges
+      map->getRayCaster().traceBatch(
+        sensorTransform.getOrigin().x() / resolution,
+        sensorTransform.getOrigin().y() / resolution,
+        laser.beams.getCosines(), laser.beams.getSines(), laser.beams.size(),
+        laser.maxRange / resolution, ranges);
+
+      for ( int j = 0; j < laser.beams.size(); j++ )
+      {
+        ranges[j] *= resolution;
+      }
+      laser.noise->apply(*laser.engine, ranges, laser.beams.size());
+
+      for ( int j = 0; j < laser.beams.size(); j++ )
+      {
+        const float range = ranges[j];
+        if ( range > laser.maxRange )
+          ranges[j] = std::numeric_limits<float>::infinity();
+        else if ( range < laser.minRange )
+          ranges[j] = - std::numeric_limits<float>::infinity();
+        else
+          ranges[j] = range;
+      }
+      ranges += laser.beams.size();
+    }
+  }
+
+}  // namespace stdr_robot
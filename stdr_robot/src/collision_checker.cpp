@@ -0,0 +1,517 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/collision_checker.h>
+#include <algorithm>
+#include <cmath>
+
+namespace stdr_robot {
+
+  const double CollisionChecker::CIRCLE_MARGIN = 1.0;
+  const double CollisionChecker::MIN_ADVANCE = 0.5;
+  const int CollisionChecker::CONTACT_BISECTIONS = 4;
+
+  /**
+  @brief Default constructor
+  @param footprint [const stdr_msgs::FootprintMsg&] The robot footprint. \
+  Without points, a circle of the footprint radius is used.
+  @return void
+  **/
+  CollisionChecker::CollisionChecker(const stdr_msgs::FootprintMsg& footprint)
+    :
+      _circular(footprint.points.size() == 0),
+      _radius(footprint.radius)
+  {
+    if( footprint.points.size() == 0 ) {
+      float radius = footprint.radius;
+      for(unsigned int i = 0 ; i < 360 ; i++)
+      {
+        float x = cos(i * 3.14159265359 / 180.0) * radius;
+        float y = sin(i * 3.14159265359 / 180.0) * radius;
+        _footprint.push_back( std::pair<float,float>(x,y));
+      }
+    } else {
+      for( unsigned int i = 0 ;
+          i < footprint.points.size() ; 
+          i++ ) {
+        geometry_msgs::Point p = footprint.points[i];
+        _footprint.push_back( std::pair<float,float>(p.x, p.y));
+      }
+    }
+  }
+
+  /**
+  @brief Checks the robot collision at a pose
+  @param map [const SharedMap&] The map
+  @param newPose [const geometry_msgs::Pose2D&] The robot pose
+  @return True on collision
+  **/
+  bool CollisionChecker::collisionExistsNoPath(
+    const SharedMap& map,
+    const geometry_msgs::Pose2D& newPose) const
+  {
+    const nav_msgs::OccupancyGrid& grid = map.getGrid();
+    const OccupancyBitmap& occupancy = map.getOccupancy();
+
+    if(grid.info.width == 0 || grid.info.height == 0)
+    {
+      return false;
+    }
+
+    if( _circular && map.getRayCaster().hasDistanceTransform() )
+    {
+      return getClearance(map, newPose.x / grid.info.resolution,
+        newPose.y / grid.info.resolution) <
+        _radius / grid.info.resolution + CIRCLE_MARGIN;
+    }
+
+    int xMap = newPose.x / grid.info.resolution;
+    int yMap = newPose.y / grid.info.resolution;
+
+    for(unsigned int i = 0 ; i < _footprint.size() ; i++)
+    {
+      double x = _footprint[i].first * cos(newPose.theta) -
+                 _footprint[i].second * sin(newPose.theta);
+      double y = _footprint[i].first * sin(newPose.theta) +
+                 _footprint[i].second * cos(newPose.theta);
+                 
+      int xx = xMap + (int)(x / grid.info.resolution);
+      int yy = yMap + (int)(y / grid.info.resolution);
+
+      if(occupancy.isOccupied(xx, yy))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+  @brief Sweeps the robot from the previous pose to the new pose
+  @param map [const SharedMap&] The map
+  @param newPose [const geometry_msgs::Pose2D&] The new robot pose
+  @param previousPose [const geometry_msgs::Pose2D&] The previous pose
+  @return Contact : The first contact along the motion
+  **/
+  Contact CollisionChecker::sweep(
+    const SharedMap& map,
+    const geometry_msgs::Pose2D& newPose,
+    const geometry_msgs::Pose2D& previousPose)
+  {
+    const nav_msgs::OccupancyGrid& grid = map.getGrid();
+
+    if(grid.info.width == 0 || grid.info.height == 0)
+    {
+      Contact contact = {1, 0, 0};
+      return contact;
+    }
+
+    if( _circular && map.getRayCaster().hasDistanceTransform() )
+    {
+      return sweepCircle(map, newPose, previousPose);
+    }
+
+    if( !_raster || _raster->getResolution() != grid.info.resolution )
+    {
+      _raster = FootprintRaster::get(_footprint, grid.info.resolution);
+    }
+    return sweepRaster(map, newPose, previousPose);
+  }
+
+  /**
+  @brief Returns a pose part of the way between two poses
+  @param from [const geometry_msgs::Pose2D&] The pose at time 0
+  @param to [const geometry_msgs::Pose2D&] The pose at time 1
+  @param time [double] The fraction of the way
+  @return geometry_msgs::Pose2D
+  **/
+  geometry_msgs::Pose2D CollisionChecker::interpolate(
+    const geometry_msgs::Pose2D& from,
+    const geometry_msgs::Pose2D& to,
+    double time)
+  {
+    if ( time >= 1 )
+    {
+      return to;
+    }
+    //!< Turns the short way round
+    const double turn = atan2( sin(to.theta - from.theta),
+      cos(to.theta - from.theta) );
+    geometry_msgs::Pose2D pose;
+    pose.x = from.x + (to.x - from.x) * time;
+    pose.y = from.y + (to.y - from.y) * time;
+    pose.theta = from.theta + turn * time;
+    return pose;
+  }
+
+  /**
+  @brief Sweeps a polygonal robot with its footprint raster
+  @param map [const SharedMap&] The map
+  @param newPose [const geometry_msgs::Pose2D&] The new robot pose
+  @param previousPose [const geometry_msgs::Pose2D&] The previous pose
+  @return Contact : The first contact along the motion
+  **/
+  Contact CollisionChecker::sweepRaster(
+    const SharedMap& map,
+    const geometry_msgs::Pose2D& newPose,
+    const geometry_msgs::Pose2D& previousPose) const
+  {
+    const OccupancyBitmap& occupancy = map.getOccupancy();
+    const double resolution = map.getGrid().info.resolution;
+
+    geometry_msgs::Pose2D from = previousPose;
+    from.x /= resolution;
+    from.y /= resolution;
+    geometry_msgs::Pose2D to = newPose;
+    to.x /= resolution;
+    to.y /= resolution;
+    const double dx = to.x - from.x;
+    const double dy = to.y - from.y;
+
+    Contact contact = {1, 0, 0};
+    int hitX, hitY;
+
+    //!< A robot already touching an obstacle may move away from it or
+    //!< along it, and is swept against the cells it does not touch yet
+    FootprintRaster::Cells startCells;
+    if ( rasterHit(occupancy, from, hitX, hitY) )
+    {
+      Contact start = contact;
+      setRasterNormal(start, occupancy, from, hitX, hitY);
+      if ( dx * start.normalX + dy * start.normalY < 0 )
+      {
+        start.time = 0;
+        normalize(start, dx, dy);
+        return start;
+      }
+      _raster->findCollisions(occupancy, static_cast<int>( floor(from.x) ),
+        static_cast<int>( floor(from.y) ), from.theta, startCells);
+      std::sort(startCells.begin(), startCells.end());
+    }
+
+    //!< Samples the path at most MIN_ADVANCE cells apart, so that no
+    //!< obstacle cell is jumped over by the dilated outline
+    const int samples = std::max( 1,
+      static_cast<int>( ceil( sqrt(dx * dx + dy * dy) / MIN_ADVANCE ) ) );
+    for ( int i = 1 ; i <= samples ; i++ )
+    {
+      double hi = static_cast<double>(i) / samples;
+      if ( !sweepHit(occupancy, interpolate(from, to, hi), startCells,
+        dx, dy, hitX, hitY) )
+      {
+        continue;
+      }
+
+      //!< Narrows the contact down between the last free sample and the
+      //!< first colliding one
+      double lo = static_cast<double>(i - 1) / samples;
+      int midX, midY;
+      for ( int j = 0 ; j < CONTACT_BISECTIONS ; j++ )
+      {
+        const double mid = (lo + hi) / 2;
+        if ( sweepHit(occupancy, interpolate(from, to, mid), startCells,
+          dx, dy, midX, midY) )
+        {
+          hi = mid;
+          hitX = midX;
+          hitY = midY;
+        }
+        else
+        {
+          lo = mid;
+        }
+      }
+      contact.time = lo;
+      setRasterNormal(contact, occupancy,
+        interpolate(from, to, hi), hitX, hitY);
+      normalize(contact, dx, dy);
+      return contact;
+    }
+    return contact;
+  }
+
+  /**
+  @brief Sweeps a circular robot by conservative advancement on the \
+  distance transform
+  @param map [const SharedMap&] The map, with a distance transform
+  @param newPose [const geometry_msgs::Pose2D&] The new robot pose
+  @param previousPose [const geometry_msgs::Pose2D&] The previous pose
+  @return Contact : The first contact along the motion
+  **/
+  Contact CollisionChecker::sweepCircle(
+    const SharedMap& map,
+    const geometry_msgs::Pose2D& newPose,
+    const geometry_msgs::Pose2D& previousPose) const
+  {
+    const double resolution = map.getGrid().info.resolution;
+    const double radius = _radius / resolution + CIRCLE_MARGIN;
+
+    const double x0 = previousPose.x / resolution;
+    const double y0 = previousPose.y / resolution;
+    const double dx = newPose.x / resolution - x0;
+    const double dy = newPose.y / resolution - y0;
+    const double length = sqrt(dx * dx + dy * dy);
+
+    Contact contact = {1, 0, 0};
+
+    //!< A robot already touching an obstacle may move, but nowhere along
+    //!< the way closer to an obstacle than at the start
+    const double limit = std::min( radius, getClearance(map, x0, y0) );
+
+    //!< Sampled at cell centers, the clearance changes by at most the
+    //!< distance moved plus a cell diagonal
+    double previous = 0;
+    double t = 0;
+    while ( true )
+    {
+      const double f = length > 0 ? t / length : 1;
+      const double clearance = getClearance(map, x0 + dx * f, y0 + dy * f);
+      if ( clearance < limit )
+      {
+        break;
+      }
+      if ( t >= length )
+      {
+        return contact;
+      }
+      previous = t;
+      t = std::min( length,
+        t + std::max( MIN_ADVANCE, clearance - limit - M_SQRT2 ) );
+    }
+
+    //!< Narrows the contact down between the last free advancement and
+    //!< the first colliding one
+    double lo = previous / length;
+    double hi = t / length;
+    for ( int j = 0 ; j < CONTACT_BISECTIONS ; j++ )
+    {
+      const double mid = (lo + hi) / 2;
+      if ( getClearance(map, x0 + dx * mid, y0 + dy * mid) < limit )
+      {
+        hi = mid;
+      }
+      else
+      {
+        lo = mid;
+      }
+    }
+    const double x = x0 + dx * hi;
+    const double y = y0 + dy * hi;
+    contact.time = lo;
+    contact.normalX = getClearance(map, x + 1, y) - getClearance(map, x - 1, y);
+    contact.normalY = getClearance(map, x, y + 1) - getClearance(map, x, y - 1);
+    normalize(contact, dx, dy);
+    return contact;
+  }
+
+  /**
+  @brief Returns the footprint cell hit at a pose of the sweep
+  @param occupancy [const OccupancyBitmap&] The map occupancy
+  @param pose [const geometry_msgs::Pose2D&] The pose in cells
+  @param hitX [int&] The x of the cell hit
+  @param hitY [int&] The y of the cell hit
+  @return bool : True on collision
+  **/
+  bool CollisionChecker::rasterHit(const OccupancyBitmap& occupancy,
+    const geometry_msgs::Pose2D& pose, int& hitX, int& hitY) const
+  {
+    return _raster->findCollision(occupancy,
+      static_cast<int>( floor(pose.x) ), static_cast<int>( floor(pose.y) ),
+      pose.theta, hitX, hitY);
+  }
+
+  /**
+  @brief Returns the footprint cell stopping the sweep at a pose. \
+  Without start cells every cell hit stops it. A robot starting in \
+  contact ignores the cells it touched at the start, and is stopped \
+  only by the new cells it moves into.
+  @param occupancy [const OccupancyBitmap&] The map occupancy
+  @param pose [const geometry_msgs::Pose2D&] The pose in cells
+  @param startCells [const FootprintRaster::Cells&] The sorted cells \
+  hit at the start of the sweep
+  @param dx [double] The motion x in cells
+  @param dy [double] The motion y in cells
+  @param hitX [int&] The x of the cell hit
+  @param hitY [int&] The y of the cell hit
+  @return bool : True on collision
+  **/
+  bool CollisionChecker::sweepHit(const OccupancyBitmap& occupancy,
+    const geometry_msgs::Pose2D& pose,
+    const FootprintRaster::Cells& startCells, double dx, double dy,
+    int& hitX, int& hitY) const
+  {
+    if ( startCells.empty() )
+    {
+      return rasterHit(occupancy, pose, hitX, hitY);
+    }
+
+    FootprintRaster::Cells cells;
+    _raster->findCollisions(occupancy, static_cast<int>( floor(pose.x) ),
+      static_cast<int>( floor(pose.y) ), pose.theta, cells);
+    for ( unsigned int i = 0 ; i < cells.size() ; i++ )
+    {
+      if ( std::binary_search(startCells.begin(), startCells.end(),
+        cells[i]) )
+      {
+        continue;
+      }
+      //!< Cells inside an obstacle only come with cells of its surface
+      bool surface = false;
+      for ( int y = -1 ; y <= 1 && !surface ; y++ )
+      {
+        for ( int x = -1 ; x <= 1 && !surface ; x++ )
+        {
+          surface = !occupancy.isOccupied(cells[i].first + x,
+            cells[i].second + y);
+        }
+      }
+      if ( !surface )
+      {
+        continue;
+      }
+
+      //!< New cells alongside the motion are slid past, thin walls
+      //!< ahead face the robot center and stop it
+      Contact contact;
+      setRasterNormal(contact, occupancy, pose, cells[i].first,
+        cells[i].second);
+      if ( dx * contact.normalX + dy * contact.normalY < 0 )
+      {
+        hitX = cells[i].first;
+        hitY = cells[i].second;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+  @brief Sets the normal of a contact from the free cells around the \
+  cell hit. Thin obstacles, free on both sides, take the side of the \
+  robot center.
+  @param contact [Contact&] The contact
+  @param occupancy [const OccupancyBitmap&] The map occupancy
+  @param pose [const geometry_msgs::Pose2D&] The pose in cells
+  @param hitX [int] The x of the cell hit
+  @param hitY [int] The y of the cell hit
+  @return void
+  **/
+  void CollisionChecker::setRasterNormal(Contact& contact,
+    const OccupancyBitmap& occupancy, const geometry_msgs::Pose2D& pose,
+    int hitX, int hitY)
+  {
+    const double centerX = pose.x - (hitX + 0.5);
+    const double centerY = pose.y - (hitY + 0.5);
+    double normalX = 0;
+    double normalY = 0;
+    for ( int y = -1 ; y <= 1 ; y++ )
+    {
+      for ( int x = -1 ; x <= 1 ; x++ )
+      {
+        if ( !occupancy.isOccupied(hitX + x, hitY + y) )
+        {
+          normalX += x;
+          normalY += y;
+        }
+      }
+    }
+    if ( normalX * centerX + normalY * centerY <= 0 )
+    {
+      //!< Only the free edge neighbours on the side of the robot center
+      //!< count, diagonal ones reach round the ends of the obstacle
+      normalX = normalY = 0;
+      const int sides[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+      for ( int i = 0 ; i < 4 ; i++ )
+      {
+        const int x = sides[i][0];
+        const int y = sides[i][1];
+        if ( x * centerX + y * centerY > 0 &&
+          !occupancy.isOccupied(hitX + x, hitY + y) )
+        {
+          normalX += x;
+          normalY += y;
+        }
+      }
+      if ( normalX * centerX + normalY * centerY <= 0 )
+      {
+        normalX = centerX;
+        normalY = centerY;
+      }
+    }
+    contact.normalX = normalX;
+    contact.normalY = normalY;
+  }
+
+  /**
+  @brief Normalizes a contact normal, or falls back to the reverse of \
+  the motion when it is degenerate
+  @param contact [Contact&] The contact
+  @param dx [double] The motion x
+  @param dy [double] The motion y
+  @return void
+  **/
+  void CollisionChecker::normalize(Contact& contact, double dx, double dy)
+  {
+    double length = sqrt( contact.normalX * contact.normalX +
+      contact.normalY * contact.normalY );
+    if ( length < 1e-9 )
+    {
+      contact.normalX = -dx;
+      contact.normalY = -dy;
+      length = sqrt(dx * dx + dy * dy);
+    }
+    if ( length < 1e-9 )
+    {
+      contact.normalX = contact.normalY = 0;
+      return;
+    }
+    contact.normalX /= length;
+    contact.normalY /= length;
+  }
+
+  /**
+  @brief Returns the distance of a point to the nearest occupied cell \
+  or to the outside of the map, from the cell holding the point
+  @param map [const SharedMap&] The map, with a distance transform
+  @param x [double] The point x in cells
+  @param y [double] The point y in cells
+  @return double : The distance in cells, 0 outside the map
+  **/
+  double CollisionChecker::getClearance(const SharedMap& map,
+    double x, double y)
+  {
+    const int xCell = floor(x);
+    const int yCell = floor(y);
+    const OccupancyBitmap& occupancy = map.getOccupancy();
+    if ( !occupancy.isInside(xCell, yCell) )
+    {
+      return 0;
+    }
+
+    //!< The cells around the map count as occupied
+    const int border = std::min(
+      std::min( xCell + 1, occupancy.getWidth() - xCell ),
+      std::min( yCell + 1, occupancy.getHeight() - yCell ) );
+    return std::min( static_cast<double>(border),
+      static_cast<double>( map.getRayCaster().getDistance(xCell, yCell) ) );
+  }
+
+}  // namespace stdr_robot
@@ -0,0 +1,257 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/fleet_state.h>
+#include <math.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief Sine and cosine without branches or library calls, so that the \
+  loops using them vectorize. Within a few float ulps of sinf and cosf. \
+  Selections are written as arithmetic on 0 or 1, which compilers keep \
+  in vector registers where they would branch on conditionals.
+  @param angle [float] The angle in radians
+  @param sine [float&] The sine of the angle
+  @param cosine [float&] The cosine of the angle
+  @return void
+  **/
+  static inline void sinCos(float angle, float& sine, float& cosine)
+  {
+    //!< Reduces to [-pi/4, pi/4] around the nearest multiple of pi/2
+    const float scaled = angle * 0.636619772f;
+    const int truncated = static_cast<int>(scaled);
+    const float fraction = scaled - truncated;
+    const int quadrant = truncated +
+      static_cast<int>(fraction >= 0.5f) - static_cast<int>(fraction <= -0.5f);
+    const float q = quadrant;
+    const float r = ( ( angle - q * 1.5703125f ) -
+      q * 4.837512969970703125e-4f ) - q * 7.549789954891882e-8f;
+
+    //!< Minimax polynomials of the reduced angle
+    const float r2 = r * r;
+    const float s = r + r * r2 * ( -1.6666654611e-1f +
+      r2 * ( 8.3321608736e-3f + r2 * -1.9515295891e-4f ) );
+    const float c = 1.0f - 0.5f * r2 + r2 * r2 * ( 4.166664568298827e-2f +
+      r2 * ( -1.388731625493765e-3f + r2 * 2.443315711809948e-5f ) );
+
+    //!< Odd quadrants swap sine and cosine, the signs follow the quadrant
+    const float swap = quadrant & 1;
+    sine = ( s + swap * ( c - s ) ) * ( 1 - ( quadrant & 2 ) );
+    cosine = ( c + swap * ( s - c ) ) * ( 1 - ( ( quadrant + 1 ) & 2 ) );
+  }
+
+  /**
+  @brief Default constructor
+  @return void
+  **/
+  FleetState::FleetState(void)
+  {
+  }
+
+  /**
+  @brief Adds a robot standing at a pose
+  @param pose [const geometry_msgs::Pose2D&] The robot pose
+  @param model [MotionModel] The kinematic model of the robot
+  @return unsigned int : The slot of the robot
+  **/
+  unsigned int FleetState::addRobot(const geometry_msgs::Pose2D& pose,
+    MotionModel model)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    unsigned int slot = _x.size();
+    if ( _freeSlots.empty() )
+    {
+      _x.push_back(0);
+      _y.push_back(0);
+      _theta.push_back(0);
+      _linear.push_back(0);
+      _lateral.push_back(0);
+      _angular.push_back(0);
+      _models.push_back(model);
+    }
+    else
+    {
+      slot = _freeSlots.back();
+      _freeSlots.pop_back();
+      _models[slot] = model;
+    }
+    _x[slot] = pose.x;
+    _y[slot] = pose.y;
+    _theta[slot] = pose.theta;
+    return slot;
+  }
+
+  /**
+  @brief Removes a robot, its slot may be reused
+  @param slot [unsigned int] The slot of the robot
+  @return void
+  **/
+  void FleetState::removeRobot(unsigned int slot)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _linear[slot] = 0;
+    _lateral[slot] = 0;
+    _angular[slot] = 0;
+    _freeSlots.push_back(slot);
+  }
+
+  /**
+  @brief Returns the pose of a robot
+  @param slot [unsigned int] The slot of the robot
+  @return geometry_msgs::Pose2D
+  **/
+  geometry_msgs::Pose2D FleetState::getPose(unsigned int slot)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    geometry_msgs::Pose2D pose;
+    pose.x = _x[slot];
+    pose.y = _y[slot];
+    pose.theta = _theta[slot];
+    return pose;
+  }
+
+  /**
+  @brief Moves a robot
+  @param slot [unsigned int] The slot of the robot
+  @param pose [const geometry_msgs::Pose2D&] The new pose
+  @return void
+  **/
+  void FleetState::setPose(unsigned int slot,
+    const geometry_msgs::Pose2D& pose)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _x[slot] = pose.x;
+    _y[slot] = pose.y;
+    _theta[slot] = pose.theta;
+  }
+
+  /**
+  @brief Sets the velocity of a robot. Ideal robots ignore the lateral \
+  velocity.
+  @param slot [unsigned int] The slot of the robot
+  @param twist [const geometry_msgs::Twist&] The velocity in the robot frame
+  @return void
+  **/
+  void FleetState::setVelocity(unsigned int slot,
+    const geometry_msgs::Twist& twist)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _linear[slot] = twist.linear.x;
+    _lateral[slot] = _models[slot] == OMNI ? twist.linear.y : 0;
+    _angular[slot] = twist.angular.z;
+  }
+
+  /**
+  @brief Returns the velocity of a robot, zero laterally for ideal robots
+  @param slot [unsigned int] The slot of the robot
+  @return geometry_msgs::Twist : The velocity in the robot frame
+  **/
+  geometry_msgs::Twist FleetState::getVelocity(unsigned int slot)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    geometry_msgs::Twist twist;
+    twist.linear.x = _linear[slot];
+    twist.linear.y = _lateral[slot];
+    twist.angular.z = _angular[slot];
+    return twist;
+  }
+
+  /**
+  @brief Integrates the motion of all robots over a time step
+  @param dt [float] The time step in seconds
+  @return void
+  **/
+  void FleetState::integrate(float dt)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    if ( _x.empty() )
+    {
+      return;
+    }
+    integrateMotion(&_x[0], &_y[0], &_theta[0],
+      &_linear[0], &_lateral[0], &_angular[0], _x.size(), dt);
+  }
+
+  /**
+  @brief Integrates the motion of one robot over a time step
+  @param slot [unsigned int] The slot of the robot
+  @param dt [float] The time step in seconds
+  @return void
+  **/
+  void FleetState::integrate(unsigned int slot, float dt)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    integrateMotion(&_x[slot], &_y[slot], &_theta[slot],
+      &_linear[slot], &_lateral[slot], &_angular[slot], 1, dt);
+  }
+
+  /**
+  @brief Integrates constant velocities in the robot frame over a time \
+  step, along the exact arc of the turn. The arrays must not overlap, \
+  which lets the loop vectorize.
+  @param x [float*] The x coordinates to update
+  @param y [float*] The y coordinates to update
+  @param theta [float*] The orientations to update
+  @param linear [const float*] The forward velocities
+  @param lateral [const float*] The lateral velocities
+  @param angular [const float*] The angular velocities
+  @param count [unsigned int] The number of robots
+  @param dt [float] The time step in seconds
+  @return void
+  **/
+  void FleetState::integrateMotion(
+    float* __restrict__ x, float* __restrict__ y, float* __restrict__ theta,
+    const float* __restrict__ linear, const float* __restrict__ lateral,
+    const float* __restrict__ angular, unsigned int count, float dt)
+  {
+    for ( unsigned int i = 0; i < count; i++ )
+    {
+      //!< The chord of the arc heads along the middle of the turn, and is
+      //!< sin(half) / half of the arc length
+      const float turn = angular[i] * dt;
+      const float heading = theta[i];
+      const float half = 0.5f * turn;
+      float sineHalf, cosineHalf;
+      sinCos(half, sineHalf, cosineHalf);
+      float sine, cosine;
+      sinCos(heading + half, sine, cosine);
+
+      //!< The same signed bias on both sides gives 1 for straight motion
+      //!< without a branch, and vanishes against any real turn
+      const float bias = copysignf(1e-30f, half);
+      const float chord = ( sineHalf + bias ) / ( half + bias );
+
+      const float forward = linear[i] * dt * chord;
+      const float sideways = lateral[i] * dt * chord;
+      x[i] += forward * cosine - sideways * sine;
+      y[i] += forward * sine + sideways * cosine;
+
+      //!< Wraps to [-pi, pi], the reduction of sinCos loses accuracy on
+      //!< the large angles of robots turning for long
+      const float next = heading + turn;
+      const float turns = next * 0.159154943f;
+      theta[i] = next - 6.283185307f *
+        static_cast<int>( turns + copysignf(0.5f, turns) );
+    }
+  }
+
+}  // namespace stdr_robot
@@ -0,0 +1,334 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/footprint_raster.h>
+#include <algorithm>
+#include <cmath>
+
+namespace stdr_robot {
+
+  const unsigned int FootprintRaster::MAX_HEADINGS = 1024;
+  const unsigned int FootprintRaster::BIN_SAMPLES = 5;
+  const int FootprintRaster::DILATION = 2;
+
+  /**
+  @brief Returns the raster of a footprint, building it if no robot \
+  holds it yet
+  @param footprint [const Footprint&] The footprint points in meters
+  @param resolution [float] The map resolution
+  @return FootprintRasterConstPtr
+  **/
+  FootprintRasterConstPtr FootprintRaster::get(const Footprint& footprint,
+    float resolution)
+  {
+    typedef std::pair<Footprint, float> RasterKey;
+    typedef std::map<RasterKey, boost::weak_ptr<const FootprintRaster> >
+      RasterTable;
+
+    static RasterTable rasters;
+    static boost::mutex mutex;
+
+    boost::mutex::scoped_lock lock(mutex);
+
+    RasterTable::iterator it = rasters.begin();
+    while ( it != rasters.end() )
+    {
+      if ( it->second.expired() )
+      {
+        rasters.erase(it++);
+      }
+      else
+      {
+        it++;
+      }
+    }
+
+    RasterKey key(footprint, resolution);
+    FootprintRasterConstPtr raster = rasters[key].lock();
+    if ( !raster )
+    {
+      raster.reset( new FootprintRaster(footprint, resolution) );
+      rasters[key] = raster;
+    }
+    return raster;
+  }
+
+  /**
+  @brief Default constructor. Rasterizes all heading bins.
+  @param footprint [const Footprint&] The footprint points in meters
+  @param resolution [float] The map resolution
+  @return void
+  **/
+  FootprintRaster::FootprintRaster(const Footprint& footprint,
+    float resolution)
+    :
+      _resolution(resolution)
+  {
+    //!< A bin turns the farthest point by at most a quarter of a cell
+    float radius = 0;
+    for ( unsigned int i = 0; i < footprint.size(); i++ )
+    {
+      radius = std::max( radius, static_cast<float>( sqrt(
+        footprint[i].first * footprint[i].first +
+        footprint[i].second * footprint[i].second ) / resolution ) );
+    }
+    unsigned int headings = static_cast<unsigned int>(
+      ceil( 4 * M_PI * radius ) );
+    headings = std::max( 8u, std::min( MAX_HEADINGS, headings ) );
+
+    _headingRows.push_back(0);
+    for ( unsigned int h = 0; h < headings; h++ )
+    {
+      rasterize(footprint, 2 * M_PI * h / headings, 2 * M_PI / headings);
+      _headingRows.push_back( _rows.size() );
+    }
+  }
+
+  /**
+  @brief Rasterizes the footprint outline over a heading bin
+  @param footprint [const Footprint&] The footprint points in meters
+  @param theta [float] The heading at the bin center
+  @param binWidth [float] The bin width
+  @return void
+  **/
+  void FootprintRaster::rasterize(const Footprint& footprint,
+    float theta, float binWidth)
+  {
+    //!< The outline points of every sampled heading, one cell apart
+    std::vector<std::pair<int,int> > points;
+    for ( unsigned int k = 0; k < BIN_SAMPLES; k++ )
+    {
+      const double sample = theta +
+        binWidth * ( static_cast<float>(k) / ( BIN_SAMPLES - 1 ) - 0.5 );
+
+      //!< Vertices in cells, floored as the robot center cell adds up
+      std::vector<std::pair<int,int> > vertices;
+      for ( unsigned int i = 0; i < footprint.size(); i++ )
+      {
+        double x = footprint[i].first * cos(sample) -
+                   footprint[i].second * sin(sample);
+        double y = footprint[i].first * sin(sample) +
+                   footprint[i].second * cos(sample);
+        vertices.push_back( std::pair<int,int>(
+          floor(x / _resolution), floor(y / _resolution) ) );
+      }
+
+      for ( unsigned int i = 0; i < vertices.size(); i++ )
+      {
+        const std::pair<int,int>& p1 = vertices[i];
+        const std::pair<int,int>& p2 =
+          vertices[ ( i + 1 ) % vertices.size() ];
+
+        float angle = atan2(p2.second - p1.second, p2.first - p1.first);
+        float dist = sqrt( pow(p2.first - p1.first, 2) +
+          pow(p2.second - p1.second, 2) );
+        for ( int d = 0; d < dist; d++ )
+        {
+          points.push_back( std::pair<int,int>(
+            p1.first + static_cast<int>( floor( d * cos(angle) ) ),
+            p1.second + static_cast<int>( floor( d * sin(angle) ) ) ) );
+        }
+      }
+    }
+    if ( points.empty() )
+    {
+      return;
+    }
+
+    int minX = points[0].first, maxX = points[0].first;
+    int minY = points[0].second, maxY = points[0].second;
+    for ( unsigned int i = 1; i < points.size(); i++ )
+    {
+      minX = std::min(minX, points[i].first);
+      maxX = std::max(maxX, points[i].first);
+      minY = std::min(minY, points[i].second);
+      maxY = std::max(maxY, points[i].second);
+    }
+
+    //!< Every point with its 8 neighbours, dilated by one more cell.
+    //!< Between the sampled headings a vertex may floor to the next cell
+    //!< and shift its edge points by a cell, the dilation keeps the mask
+    //!< a superset of the cells probed at the exact heading.
+    minX -= DILATION; minY -= DILATION; maxX += DILATION; maxY += DILATION;
+    const int width = maxX - minX + 1;
+    std::vector<uint8_t> cells( width * ( maxY - minY + 1 ), 0 );
+    for ( unsigned int i = 0; i < points.size(); i++ )
+    {
+      for ( int dy = -DILATION; dy <= DILATION; dy++ )
+      {
+        uint8_t* row = &cells[ ( points[i].second + dy - minY ) * width ];
+        for ( int dx = -DILATION; dx <= DILATION; dx++ )
+        {
+          row[ points[i].first + dx - minX ] = 1;
+        }
+      }
+    }
+
+    for ( int y = minY; y <= maxY; y++ )
+    {
+      const uint8_t* row = &cells[ ( y - minY ) * width ];
+      int first = 0;
+      while ( first < width && !row[first] )
+      {
+        first++;
+      }
+      if ( first == width )
+      {
+        continue;
+      }
+      int last = width - 1;
+      while ( !row[last] )
+      {
+        last--;
+      }
+
+      MaskRow mask;
+      mask.dy = y;
+      mask.dx = minX + first;
+      mask.firstWord = _words.size();
+      mask.words = ( last - first ) / 64 + 1;
+      _words.resize( _words.size() + mask.words, 0 );
+      for ( int x = first; x <= last; x++ )
+      {
+        if ( row[x] )
+        {
+          _words[ mask.firstWord + ( x - first ) / 64 ] |=
+            uint64_t(1) << ( ( x - first ) % 64 );
+        }
+      }
+      _rows.push_back(mask);
+    }
+  }
+
+  /**
+  @brief Returns the heading bin of an orientation
+  @param theta [float] The orientation
+  @return unsigned int
+  **/
+  unsigned int FootprintRaster::getHeading(float theta) const
+  {
+    //!< Orientations are not normalized by the motion controllers
+    double turns = theta / ( 2 * M_PI );
+    turns -= floor(turns);
+    const unsigned int headings = getHeadings();
+    return static_cast<unsigned int>( turns * headings + 0.5 ) % headings;
+  }
+
+  /**
+  @brief Returns true if the footprint touches an occupied cell or \
+  leaves the map
+  @param occupancy [const OccupancyBitmap&] The map occupancy
+  @param x [int] The cell of the robot center
+  @param y [int] The cell of the robot center
+  @param theta [float] The robot orientation
+  @return bool
+  **/
+  bool FootprintRaster::collides(const OccupancyBitmap& occupancy,
+    int x, int y, float theta) const
+  {
+    const unsigned int heading = getHeading(theta);
+    for ( unsigned int r = _headingRows[heading];
+      r < _headingRows[heading + 1]; r++ )
+    {
+      const MaskRow& row = _rows[r];
+      const uint64_t* words = &_words[row.firstWord];
+      for ( unsigned int w = 0; w < row.words; w++ )
+      {
+        if ( occupancy.getRowBits(y + row.dy, x + row.dx + 64 * w) &
+          words[w] )
+        {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+  @brief Like collides(), also returning the first cell hit
+  @param occupancy [const OccupancyBitmap&] The map occupancy
+  @param x [int] The cell of the robot center
+  @param y [int] The cell of the robot center
+  @param theta [float] The robot orientation
+  @param hitX [int&] The x of the cell hit
+  @param hitY [int&] The y of the cell hit
+  @return bool
+  **/
+  bool FootprintRaster::findCollision(const OccupancyBitmap& occupancy,
+    int x, int y, float theta, int& hitX, int& hitY) const
+  {
+    const unsigned int heading = getHeading(theta);
+    for ( unsigned int r = _headingRows[heading];
+      r < _headingRows[heading + 1]; r++ )
+    {
+      const MaskRow& row = _rows[r];
+      const uint64_t* words = &_words[row.firstWord];
+      for ( unsigned int w = 0; w < row.words; w++ )
+      {
+        const int first = x + row.dx + 64 * w;
+        const uint64_t hits = occupancy.getRowBits(y + row.dy, first) &
+          words[w];
+        if ( hits )
+        {
+          hitX = first + __builtin_ctzll(hits);
+          hitY = y + row.dy;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  /**
+  @brief Like collides(), also returning every cell hit
+  @param occupancy [const OccupancyBitmap&] The map occupancy
+  @param x [int] The cell of the robot center
+  @param y [int] The cell of the robot center
+  @param theta [float] The robot orientation
+  @param cells [Cells&] The cells hit
+  @return bool
+  **/
+  bool FootprintRaster::findCollisions(const OccupancyBitmap& occupancy,
+    int x, int y, float theta, Cells& cells) const
+  {
+    cells.clear();
+    const unsigned int heading = getHeading(theta);
+    for ( unsigned int r = _headingRows[heading];
+      r < _headingRows[heading + 1]; r++ )
+    {
+      const MaskRow& row = _rows[r];
+      const uint64_t* words = &_words[row.firstWord];
+      for ( unsigned int w = 0; w < row.words; w++ )
+      {
+        const int first = x + row.dx + 64 * w;
+        uint64_t hits = occupancy.getRowBits(y + row.dy, first) & words[w];
+        while ( hits )
+        {
+          cells.push_back( std::pair<int,int>(
+            first + __builtin_ctzll(hits), y + row.dy ) );
+          hits &= hits - 1;
+        }
+      }
+    }
+    return !cells.empty();
+  }
+
+}  // namespace stdr_robot
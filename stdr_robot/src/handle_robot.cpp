@@ -29,6 +29,7 @@ namespace stdr_robot {
   **/
   HandleRobot::HandleRobot() 
     : _spawnRobotClient("stdr_server/spawn_robot", true)
+    , _spawnRobotsClient("stdr_server/spawn_robots", true)
     , _deleteRobotClient("stdr_server/delete_robot", true)
   {
   }
@@ -71,6 +72,46 @@ namespace stdr_robot {
     
   }
 
+  /**
+  @brief Spawns many robots in one round trip to the server
+  @param msgs [const std::vector<stdr_msgs::RobotMsg>&] The robot messages from which the robots are created
+  @return std::vector<stdr_msgs::RobotIndexedMsg> : The robot messages with the proper frame_ids
+  **/
+  std::vector<stdr_msgs::RobotIndexedMsg> HandleRobot::spawnNewRobots(
+    const std::vector<stdr_msgs::RobotMsg>& msgs) 
+  {
+    
+    stdr_msgs::SpawnRobotsGoal goal;
+    goal.descriptions = msgs;
+      
+    while (!_spawnRobotsClient.waitForServer(ros::Duration(1)) && ros::ok()) {
+      ROS_WARN("Could not find stdr_server/spawn_robots action.");
+    }
+    
+    _spawnRobotsClient.sendGoal(goal);
+    
+    //!< The server bounds the wait for every robot and unloads the late
+    //!< ones, a deadline here would lose robots it goes on to spawn
+    bool success = _spawnRobotsClient.waitForResult();
+    if (!success) {
+      throw ConnectionException("Could not spawn robots...");
+    }
+    
+    actionlib::SimpleClientGoalState state = _spawnRobotsClient.getState();
+    if(state.toString() == "ABORTED")
+    {
+      std::string msg = std::string("Could not spawn robots. ") + 
+        _spawnRobotsClient.getResult()->message;
+      throw DoubleFrameIdException(msg);
+    }
+    
+    ROS_INFO("%u new robots spawned successfully.", 
+      (unsigned int)_spawnRobotsClient.getResult()->indexedDescriptions.size());
+    
+    return _spawnRobotsClient.getResult()->indexedDescriptions;
+    
+  }
+
   /**
   @brief Deletes a robot by frame_id
   @param name [const std::string&] The robot frame_id to be deleted
@@ -23,6 +23,8 @@
 #include <stdr_parser/stdr_parser.h>
 
 #define USAGE "USAGE: robot_handler add <description.yaml> <x> <y> <theta>\n" \
+"OR: robot_handler add_all <description.yaml> <x> <y> <theta> " \
+"[<description.yaml> <x> <y> <theta> ...]\n"\
 "OR: robot_handler delete <robot_name>\n"\
 "OR: robot_handler replace <robot_name> <new_x> <new_y> <new_theta>"
 
@@ -70,6 +72,48 @@ int main(int argc, char** argv) {
       return -1;
     }
     
+  }
+  //!< add many robots in one request
+  else if ((argc >= 6) && ((argc - 2) % 4 == 0) && 
+    (std::string(argv[1]) == "add_all")) 
+  {
+    
+    std::vector<stdr_msgs::RobotMsg> msgs;
+    
+    for (int i = 2; i < argc; i += 4) {
+      
+      stdr_msgs::RobotMsg msg;
+      
+      try {
+        msg = stdr_parser::Parser::createMessage
+          <stdr_msgs::RobotMsg>(std::string(argv[i]));
+      }
+      catch(stdr_parser::ParserException& ex)
+      {
+        ROS_ERROR("[STDR_PARSER] %s", ex.what());
+        return -1;
+      }
+      
+      msg.initialPose.x = atof(argv[i + 1]);
+      msg.initialPose.y = atof(argv[i + 2]);
+      msg.initialPose.theta = atof(argv[i + 3]);
+      
+      msgs.push_back(msg);
+    }
+    
+    try {
+      handler.spawnNewRobots(msgs);
+      return 0;
+    }
+    catch (stdr_robot::ConnectionException& ex) {
+      ROS_ERROR("%s", ex.what());
+      return -1;
+    }
+    catch (stdr_robot::DoubleFrameIdException& ex) {
+      ROS_ERROR("%s", ex.what());
+      return -1;
+    }
+    
   }
   //!< delete
   else if ((argc == 3) && (std::string(argv[1]) == "delete")) {
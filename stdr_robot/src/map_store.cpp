@@ -0,0 +1,114 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/map_store.h>
+#include <ros/ros.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief Default constructor. Builds the derived structures.
+  @param grid [const nav_msgs::OccupancyGridConstPtr&] The map message
+  @param occupancyThreshold [int] Cells with larger values are occupied
+  @param maxDistanceTransformCells [int] Larger maps get no distance \
+  transform
+  @return void
+  **/
+  SharedMap::SharedMap(const nav_msgs::OccupancyGridConstPtr& grid,
+    int occupancyThreshold, int maxDistanceTransformCells)
+    :
+      _grid(grid),
+      _occupancy(*grid, occupancyThreshold),
+      _pyramid(_occupancy),
+      _rayCaster(_occupancy, _pyramid)
+  {
+    //!< 4 bytes per cell, too much for huge maps
+    if ( static_cast<double>(_occupancy.getWidth()) * _occupancy.getHeight()
+      <= maxDistanceTransformCells )
+    {
+      _rayCaster.updateMap();
+    }
+  }
+
+  /**
+  @brief Default constructor
+  @return void
+  **/
+  MapStore::MapStore(void)
+  {
+    ros::param::param<int>("~occupancy_threshold", _occupancyThreshold, 70);
+    ros::param::param<int>("~distance_transform_max_cells",
+      _maxDistanceTransformCells, 4096 * 4096);
+  }
+
+  /**
+  @brief Returns the map store of the process, created on first use
+  @return MapStore&
+  **/
+  MapStore& MapStore::getInstance(void)
+  {
+    static MapStore store;
+    return store;
+  }
+
+  /**
+  @brief Returns the shared map of a map message, building it if no \
+  robot holds it yet
+  @param grid [const nav_msgs::OccupancyGridConstPtr&] The map message
+  @return SharedMapConstPtr
+  **/
+  SharedMapConstPtr MapStore::getMap(
+    const nav_msgs::OccupancyGridConstPtr& grid)
+  {
+    MapKey key(grid->header.stamp, grid->header.frame_id);
+
+    //!< Robots wait for the first one to build the map, not build their own
+    boost::mutex::scoped_lock lock(_mutex);
+
+    MapTable::iterator it = _maps.begin();
+    while ( it != _maps.end() )
+    {
+      if ( it->second.expired() )
+      {
+        _maps.erase(it++);
+      }
+      else
+      {
+        it++;
+      }
+    }
+
+    SharedMapConstPtr map = _maps[key].lock();
+    if ( map &&
+      map->getGrid().info.width == grid->info.width &&
+      map->getGrid().info.height == grid->info.height &&
+      map->getGrid().info.resolution == grid->info.resolution )
+    {
+      return map;
+    }
+
+    map.reset( new SharedMap(grid, _occupancyThreshold,
+      _maxDistanceTransformCells) );
+    _maps[key] = map;
+    return map;
+  }
+
+}  // namespace stdr_robot
@@ -26,56 +26,21 @@ namespace stdr_robot {
   /**
   @brief Default constructor
   @param pose [const geometry_msgs::Pose2D&] The robot pose
-  @param tf [tf::TransformBroadcaster&] A ROS tf broadcaster
+  @param fleet [FleetState&] The fleet holding the robot state
   @param n [ros::NodeHandle&] The ROS node handle
   @param name [const std::string&] The robot frame id
   @return void
   **/
   IdealMotionController::IdealMotionController(
     const geometry_msgs::Pose2D& pose, 
-    tf::TransformBroadcaster& tf, 
+    FleetState& fleet,
     ros::NodeHandle& n, 
     const std::string& name,
     const stdr_msgs::KinematicMsg params)
-      : MotionController(pose, tf, name, n, params)
+      : MotionController(pose, fleet, FleetState::IDEAL, name, n, params)
   {
-    _calcTimer = n.createTimer(
-      _freq, 
-      &IdealMotionController::calculateMotion, 
-      this);
   }
-   
-  /**
-  @brief Calculates the motion - updates the robot pose
-  @param event [const ros::TimerEvent&] A ROS timer event
-  @return void
-  **/
-  void IdealMotionController::calculateMotion(const ros::TimerEvent& event) 
-  {
-    //!< updates _posePtr based on _currentTwist and time passed (event.last_real)
-    
-    ros::Duration dt = ros::Time::now() - event.last_real;
-    
-    if (_currentTwist.angular.z == 0) {
-      
-      _pose.x += _currentTwist.linear.x * dt.toSec() * cosf(_pose.theta);
-      _pose.y += _currentTwist.linear.x * dt.toSec() * sinf(_pose.theta);
-    }
-    else {
-      
-      _pose.x += - _currentTwist.linear.x / _currentTwist.angular.z * 
-        sinf(_pose.theta) + 
-        _currentTwist.linear.x / _currentTwist.angular.z * 
-        sinf(_pose.theta + dt.toSec() * _currentTwist.angular.z);
-      
-      _pose.y -= - _currentTwist.linear.x / _currentTwist.angular.z * 
-        cosf(_pose.theta) + 
-        _currentTwist.linear.x / _currentTwist.angular.z * 
-        cosf(_pose.theta + dt.toSec() * _currentTwist.angular.z);
-    }
-    _pose.theta += _currentTwist.angular.z * dt.toSec();
-  }
-  
+
   /**
   @brief Default destructor 
   @return void
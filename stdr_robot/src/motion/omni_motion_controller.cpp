@@ -40,56 +40,21 @@ namespace stdr_robot {
   /**
   @brief Default constructor
   @param pose [const geometry_msgs::Pose2D&] The robot pose
-  @param tf [tf::TransformBroadcaster&] A ROS tf broadcaster
+  @param fleet [FleetState&] The fleet holding the robot state
   @param n [ros::NodeHandle&] The ROS node handle
   @param name [const std::string&] The robot frame id
   @return void
   **/  
   OmniMotionController::OmniMotionController(
     const geometry_msgs::Pose2D& pose, 
-    tf::TransformBroadcaster& tf, 
+    FleetState& fleet,
     ros::NodeHandle& n, 
     const std::string& name,
     const stdr_msgs::KinematicMsg params)
-      : MotionController(pose, tf, name, n, params)
+      : MotionController(pose, fleet, FleetState::OMNI, name, n, params)
   {
-    _calcTimer = n.createTimer(
-      _freq, 
-      &OmniMotionController::calculateMotion, 
-      this);
   }
 
-  
-  /**
-  @brief Calculates the motion - updates the robot pose
-  @param event [const ros::TimerEvent&] A ROS timer event
-  @return void
-  **/
-  void OmniMotionController::calculateMotion(const ros::TimerEvent& event) 
-  {
-    //!< updates _posePtr based on _currentTwist and time passed (event.last_real)
-    
-    ros::Duration dt = ros::Time::now() - event.last_real;
-    
-    // Simple omni model
-    // TODO: Add kinematic model uncertainties
-    if (_currentTwist.angular.z != 0 || _currentTwist.linear.x != 0 ||
-     _currentTwist.linear.y != 0) 
-    {
-      // Dx and Dy takes under consideration both linear rotations, 
-      // independently of each other
-      _pose.x += 
-        _currentTwist.linear.x * dt.toSec() * cosf(_pose.theta) + 
-        _currentTwist.linear.y * dt.toSec() * cosf(_pose.theta + M_PI/2.0); 
-
-      _pose.y += 
-        _currentTwist.linear.y * dt.toSec() * sinf(_pose.theta + M_PI/2.0) +
-        _currentTwist.linear.x * dt.toSec() * sinf(_pose.theta);
-
-      _pose.theta += _currentTwist.angular.z * dt.toSec();
-    }
-  }
-  
   /**
   @brief Default destructor 
   @return void
@@ -0,0 +1,264 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/noise_engine.h>
+#include <ros/ros.h>
+#include <cmath>
+
+namespace stdr_robot {
+
+  namespace {
+
+    //!< Layers of the ziggurat
+    const unsigned int LAYERS = 128;
+    //!< Start of the tail of the ziggurat
+    const double TAIL = 3.442619855899;
+    //!< Area of each layer
+    const double LAYER_AREA = 9.91256303526217e-3;
+    //!< Scale of the random integers of the samples
+    const double INT_SCALE = 2147483648.0;
+
+    /**
+    @struct ZigguratTables
+    @brief The layer tables of the ziggurat, after Marsaglia and Tsang
+    **/
+    struct ZigguratTables {
+
+      ZigguratTables(void)
+      {
+        double dn = TAIL;
+        double tn = dn;
+        const double q = LAYER_AREA / exp(-0.5 * dn * dn);
+
+        kn[0] = static_cast<uint32_t>( (dn / q) * INT_SCALE );
+        kn[1] = 0;
+        wn[0] = static_cast<float>( q / INT_SCALE );
+        wn[LAYERS - 1] = static_cast<float>( dn / INT_SCALE );
+        fn[0] = 1.0f;
+        fn[LAYERS - 1] = static_cast<float>( exp(-0.5 * dn * dn) );
+
+        for ( unsigned int i = LAYERS - 2 ; i >= 1 ; i-- )
+        {
+          dn = sqrt( -2 * log( LAYER_AREA / dn + exp(-0.5 * dn * dn) ) );
+          kn[i + 1] = static_cast<uint32_t>( (dn / tn) * INT_SCALE );
+          tn = dn;
+          fn[i] = static_cast<float>( exp(-0.5 * dn * dn) );
+          wn[i] = static_cast<float>( dn / INT_SCALE );
+        }
+      }
+
+      //!< Samples below are inside their layer
+      uint32_t kn[LAYERS];
+      //!< Sample scale of each layer
+      float wn[LAYERS];
+      //!< Density at the top of each layer
+      float fn[LAYERS];
+    };
+
+    /**
+    @brief Returns the ziggurat tables, built on first use
+    @return const ZigguratTables&
+    **/
+    const ZigguratTables& getTables(void)
+    {
+      static const ZigguratTables tables;
+      return tables;
+    }
+
+    /**
+    @brief Mixes 64 bits, the splitmix64 step
+    @param x [uint64_t&] The state, advanced
+    @return uint64_t
+    **/
+    uint64_t splitMix(uint64_t& x)
+    {
+      uint64_t z = (x += 0x9E3779B97F4A7C15ULL);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      return z ^ (z >> 31);
+    }
+
+    /**
+    @brief Returns the magnitude of a random integer, INT32_MIN included
+    @param hz [int32_t] The integer
+    @return uint32_t
+    **/
+    inline uint32_t magnitude(int32_t hz)
+    {
+      return hz < 0 ? 0u - static_cast<uint32_t>(hz) : hz;
+    }
+
+    /**
+    @brief Reads the ~noise_seed parameter, or draws a seed from the clock
+    @return uint64_t
+    **/
+    uint64_t readGlobalSeed(void)
+    {
+      int seed;
+      ros::param::param<int>("~noise_seed", seed, -1);
+      if ( seed < 0 )
+      {
+        seed = static_cast<int>( ros::WallTime::now().toNSec() & 0x7FFFFFFF );
+        ROS_INFO("Noise seed %d, set ~noise_seed to repeat the run", seed);
+      }
+      return seed;
+    }
+
+  }  // namespace
+
+  /**
+  @brief Default constructor
+  @param stream [const std::string&] The name of the stream, \
+  e.g. the robot name or the sensor frame id
+  @return void
+  **/
+  NoiseEngine::NoiseEngine(const std::string& stream)
+  {
+    initState(getGlobalSeed(), stream);
+  }
+
+  /**
+  @brief Constructor with an explicit seed
+  @param seed [uint64_t] The seed, used in place of the global seed
+  @param stream [const std::string&] The name of the stream
+  @return void
+  **/
+  NoiseEngine::NoiseEngine(uint64_t seed, const std::string& stream)
+  {
+    initState(seed, stream);
+  }
+
+  /**
+  @brief Seeds the generator state from a seed and a stream name
+  @param seed [uint64_t] The seed
+  @param stream [const std::string&] The name of the stream
+  @return void
+  **/
+  void NoiseEngine::initState(uint64_t seed, const std::string& stream)
+  {
+    //!< FNV-1a of the stream name
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for ( unsigned int i = 0 ; i < stream.size() ; i++ )
+    {
+      hash ^= static_cast<unsigned char>(stream[i]);
+      hash *= 0x100000001B3ULL;
+    }
+
+    uint64_t state = seed ^ splitMix(hash);
+    for ( unsigned int i = 0 ; i < 4 ; i++ )
+    {
+      _state[i] = splitMix(state);
+    }
+  }
+
+  /**
+  @brief Returns a standard normal sample
+  @return float
+  **/
+  float NoiseEngine::normal(void)
+  {
+    const ZigguratTables& tables = getTables();
+    //!< Separate bits for the layer and the sample, unlike the original
+    const uint64_t bits = next();
+    const unsigned int iz = bits & (LAYERS - 1);
+    const int32_t hz = static_cast<int32_t>(bits >> 32);
+    if ( magnitude(hz) < tables.kn[iz] )
+    {
+      return hz * tables.wn[iz];
+    }
+    return normalTail(hz, iz);
+  }
+
+  /**
+  @brief Fills an array with normal samples
+  @param values [float*] The array
+  @param size [unsigned int] The array size
+  @param mean [float] The mean of the samples
+  @param std [float] The standard deviation of the samples
+  @return void
+  **/
+  void NoiseEngine::fillNormal(float* values, unsigned int size,
+    float mean, float std)
+  {
+    //!< The layer tables are looked up once for the whole array
+    const ZigguratTables& tables = getTables();
+    for ( unsigned int i = 0 ; i < size ; i++ )
+    {
+      const uint64_t bits = next();
+      const unsigned int iz = bits & (LAYERS - 1);
+      const int32_t hz = static_cast<int32_t>(bits >> 32);
+      const float sample = magnitude(hz) < tables.kn[iz] ?
+        hz * tables.wn[iz] : normalTail(hz, iz);
+      values[i] = mean + std * sample;
+    }
+  }
+
+  /**
+  @brief Samples the tail and the wedges of the ziggurat
+  @param hz [int32_t] The random integer of the sample
+  @param iz [unsigned int] The layer of the sample
+  @return float
+  **/
+  float NoiseEngine::normalTail(int32_t hz, unsigned int iz)
+  {
+    const ZigguratTables& tables = getTables();
+    while ( true )
+    {
+      const float x = hz * tables.wn[iz];
+      if ( iz == 0 )
+      {
+        double tx, ty;
+        do
+        {
+          tx = -log( uniform() ) / TAIL;
+          ty = -log( uniform() );
+        }
+        while ( ty + ty < tx * tx );
+        return static_cast<float>( hz > 0 ? TAIL + tx : -TAIL - tx );
+      }
+      if ( tables.fn[iz] + uniform() * (tables.fn[iz - 1] - tables.fn[iz]) <
+        exp(-0.5 * x * x) )
+      {
+        return x;
+      }
+
+      const uint64_t bits = next();
+      iz = bits & (LAYERS - 1);
+      hz = static_cast<int32_t>(bits >> 32);
+      if ( magnitude(hz) < tables.kn[iz] )
+      {
+        return hz * tables.wn[iz];
+      }
+    }
+  }
+
+  /**
+  @brief Returns the global noise seed, the ~noise_seed parameter of \
+  the process. A negative seed draws one from the clock, and logs it.
+  @return uint64_t
+  **/
+  uint64_t NoiseEngine::getGlobalSeed(void)
+  {
+    static const uint64_t seed = readGlobalSeed();
+    return seed;
+  }
+
+}
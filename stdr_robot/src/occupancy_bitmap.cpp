@@ -0,0 +1,156 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/occupancy_bitmap.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief Default constructor. Packs the map cells.
+  @param map [const nav_msgs::OccupancyGrid&] The occupancy grid map
+  @param threshold [int] Cells with larger values are occupied
+  @return void
+  **/
+  OccupancyBitmap::OccupancyBitmap(const nav_msgs::OccupancyGrid& map,
+    int threshold)
+  {
+    _layout.resize(0, 0);
+
+    //!< A malformed map is left empty, every cell reads as outside
+    if ( map.info.width == 0 || map.info.height == 0 ||
+      map.data.size() != map.info.width * map.info.height )
+    {
+      return;
+    }
+
+    _layout.resize(map.info.width, map.info.height);
+    _occupied.assign(_layout.size() / TiledLayout::TILE_CELLS, 0);
+    _unknown.assign(_occupied.size(), 0);
+
+    for ( int y = 0; y < _layout.height; y++ )
+    {
+      const int8_t* row = &map.data[ y * _layout.width ];
+      for ( int x = 0; x < _layout.width; x++ )
+      {
+        int index = _layout.index(x, y);
+        uint64_t bit = uint64_t(1) << ( index & 63 );
+        if ( row[x] > threshold )
+        {
+          _occupied[ index >> 6 ] |= bit;
+        }
+        else if ( row[x] == -1 )
+        {
+          _unknown[ index >> 6 ] |= bit;
+        }
+      }
+    }
+  }
+
+  /**
+  @brief Returns true if no cell of a row span is occupied. Tests the \
+  cells of a tile row at once.
+  @param y [int] The row
+  @param xBegin [int] The first cell of the span
+  @param xEnd [int] The last cell of the span, inclusive
+  @return bool : False if the span leaves the map
+  **/
+  bool OccupancyBitmap::isSpanFree(int y, int xBegin, int xEnd) const
+  {
+    if ( !isInside(xBegin, y) || !isInside(xEnd, y) )
+    {
+      return false;
+    }
+    return nextOccupiedInRow(y, xBegin) > xEnd;
+  }
+
+  /**
+  @brief Returns the first occupied cell of a row at or after a cell. \
+  Skips the free cells of a tile row at once.
+  @param y [int] The row, inside the map
+  @param x [int] The first cell to test, inside the map
+  @return int : The occupied cell x, the map width if there is none
+  **/
+  int OccupancyBitmap::nextOccupiedInRow(int y, int x) const
+  {
+    const int shift = ( y & ( TiledLayout::TILE_SIZE - 1 ) ) *
+      TiledLayout::TILE_SIZE;
+    const uint64_t* tiles =
+      &_occupied[ ( y >> TiledLayout::TILE_SHIFT ) * _layout.tilesPerRow ];
+    int tile = x >> TiledLayout::TILE_SHIFT;
+
+    //!< The row of the tile, without the cells before x
+    unsigned int bits = ( ( tiles[tile] >> shift ) & 0xff ) &
+      ( 0xffu << ( x & ( TiledLayout::TILE_SIZE - 1 ) ) );
+    while ( bits == 0 )
+    {
+      if ( ++tile == _layout.tilesPerRow )
+      {
+        return _layout.width;
+      }
+      bits = ( tiles[tile] >> shift ) & 0xff;
+    }
+    //!< Padding bits are never set, so the cell lies inside the map
+    return ( tile << TiledLayout::TILE_SHIFT ) + __builtin_ctz(bits);
+  }
+
+  /**
+  @brief Returns the occupancy of 64 consecutive cells of a row, bit i \
+  for cell (x + i, y). Cells outside the map are set.
+  @param y [int] The row
+  @param x [int] The first cell
+  @return uint64_t
+  **/
+  uint64_t OccupancyBitmap::getRowBits(int y, int x) const
+  {
+    if ( y < 0 || y >= _layout.height || x >= _layout.width || x <= -64 )
+    {
+      return ~uint64_t(0);
+    }
+
+    const int shift = ( y & ( TiledLayout::TILE_SIZE - 1 ) ) *
+      TiledLayout::TILE_SIZE;
+    const uint64_t* tiles =
+      &_occupied[ ( y >> TiledLayout::TILE_SHIFT ) * _layout.tilesPerRow ];
+    const int firstTile = x >> TiledLayout::TILE_SHIFT;
+    const int offset = x & ( TiledLayout::TILE_SIZE - 1 );
+
+    //!< The tile rows covering the cells, 9 of them unless x is aligned
+    uint64_t bits = 0;
+    const int tileCount = offset == 0 ? 8 : 9;
+    for ( int i = 0; i < tileCount; i++ )
+    {
+      const int tile = firstTile + i;
+      const uint64_t row = ( tile >= 0 && tile < _layout.tilesPerRow ) ?
+        ( tiles[tile] >> shift ) & 0xff : 0xff;
+      const int position = i * TiledLayout::TILE_SIZE - offset;
+      bits |= position >= 0 ? row << position : row >> -position;
+    }
+
+    //!< Padding bits are never set, mark the cells past the width
+    const int inside = _layout.width - x;
+    if ( inside < 64 )
+    {
+      bits |= ~uint64_t(0) << inside;
+    }
+    return bits;
+  }
+
+}  // namespace stdr_robot
@@ -0,0 +1,183 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/occupancy_pyramid.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace stdr_robot {
+
+  /**
+  @brief Default constructor. Builds the coarse levels.
+  @param occupancy [const OccupancyBitmap&] The occupied cells of the map
+  @return void
+  **/
+  OccupancyPyramid::OccupancyPyramid(const OccupancyBitmap& occupancy)
+    :
+      _occupancy(occupancy),
+      _levels(0)
+  {
+    const int width = _occupancy.getWidth();
+    const int height = _occupancy.getHeight();
+    if ( _occupancy.empty() )
+    {
+      return;
+    }
+
+    //!< Up to the level whose single block covers the map
+    _levels = 1;
+    while ( ( 1 << ( _levels - 1 ) ) < std::max(width, height) )
+    {
+      _levels++;
+    }
+
+    for ( int level = FIRST_STORED_LEVEL; level < _levels; level++ )
+    {
+      const int levelWidth = ( width + ( 1 << level ) - 1 ) >> level;
+      const int levelHeight = ( height + ( 1 << level ) - 1 ) >> level;
+      _widths.push_back(levelWidth);
+      _blocks.push_back(std::vector<uint8_t>(levelWidth * levelHeight, 0));
+      std::vector<uint8_t>& blocks = _blocks.back();
+
+      //!< The first stored level pools 2x2 tiles, the others 2x2 blocks
+      if ( level == FIRST_STORED_LEVEL )
+      {
+        for ( int y = 0; y < height; y += TiledLayout::TILE_SIZE )
+        {
+          for ( int x = 0; x < width; x += TiledLayout::TILE_SIZE )
+          {
+            if ( _occupancy.getTile(x, y) )
+            {
+              blocks[ ( y >> level ) * levelWidth + ( x >> level ) ] = 1;
+            }
+          }
+        }
+        continue;
+      }
+
+      const std::vector<uint8_t>& finer = _blocks[ _blocks.size() - 2 ];
+      const int finerWidth = _widths[ _widths.size() - 2 ];
+      for ( unsigned int i = 0; i < finer.size(); i++ )
+      {
+        if ( finer[i] )
+        {
+          int x = i % finerWidth;
+          int y = i / finerWidth;
+          blocks[ ( y >> 1 ) * levelWidth + ( x >> 1 ) ] = 1;
+        }
+      }
+    }
+  }
+
+  /**
+  @brief Returns true if the block of a level holding a cell has no \
+  occupied cell
+  @param level [int] The level, less than getLevels()
+  @param x [int] The cell x, inside the map
+  @param y [int] The cell y, inside the map
+  @return bool
+  **/
+  bool OccupancyPyramid::isBlockFree(int level, int x, int y) const
+  {
+    if ( level == 0 )
+    {
+      return !_occupancy(x, y);
+    }
+
+    if ( level < FIRST_STORED_LEVEL )
+    {
+      //!< The block lies in the tile, as one square of bits
+      static const uint64_t masks[] =
+        { 0, 0x0303ULL, 0x0f0f0f0fULL, ~uint64_t(0) };
+      const int tileMask = TiledLayout::TILE_SIZE - 1;
+      const int blockMask = ~( ( 1 << level ) - 1 );
+      const int shift =
+        ( ( y & tileMask & blockMask ) << TiledLayout::TILE_SHIFT ) +
+        ( x & tileMask & blockMask );
+      return ( _occupancy.getTile(x, y) & ( masks[level] << shift ) ) == 0;
+    }
+
+    const int stored = level - FIRST_STORED_LEVEL;
+    return _blocks[stored][ ( y >> level ) * _widths[stored] +
+      ( x >> level ) ] == 0;
+  }
+
+  /**
+  @brief Casts a ray and returns the distance to the first occupied \
+  cell it crosses. Same result as castRay on the bitmap.
+  @param originX [double] The ray origin x in cells
+  @param originY [double] The ray origin y in cells
+  @param dirX [double] The x component of the unit ray direction
+  @param dirY [double] The y component of the unit ray direction
+  @param maxDistance [double] The maximum ray distance in cells
+  @return float : The distance in cells, infinity if nothing was hit
+  **/
+  float OccupancyPyramid::castRay(double originX, double originY,
+    double dirX, double dirY, double maxDistance) const
+  {
+    const double inf = std::numeric_limits<double>::infinity();
+    int x = floor(originX);
+    int y = floor(originY);
+    double t = 0;
+
+    while ( t <= maxDistance && _occupancy.isInside(x, y) )
+    {
+      if ( _occupancy(x, y) )
+      {
+        return t;
+      }
+
+      int level = 0;
+      while ( level + 1 < _levels && isBlockFree(level + 1, x, y) )
+      {
+        level++;
+      }
+
+      //!< Leave the free block through its nearest side
+      const int size = 1 << level;
+      const int blockX = ( x >> level ) << level;
+      const int blockY = ( y >> level ) << level;
+      const double exitX = dirX > 0 ? ( blockX + size - originX ) / dirX :
+        ( dirX < 0 ? ( blockX - originX ) / dirX : inf );
+      const double exitY = dirY > 0 ? ( blockY + size - originY ) / dirY :
+        ( dirY < 0 ? ( blockY - originY ) / dirY : inf );
+
+      //!< The entered cell is derived from the crossed side, not rounded
+      if ( exitX < exitY )
+      {
+        t = exitX;
+        x = dirX > 0 ? blockX + size : blockX - 1;
+        y = std::min(std::max(static_cast<int>(floor(originY + dirY * t)),
+          blockY), blockY + size - 1);
+      }
+      else
+      {
+        t = exitY;
+        y = dirY > 0 ? blockY + size : blockY - 1;
+        x = std::min(std::max(static_cast<int>(floor(originX + dirX * t)),
+          blockX), blockX + size - 1);
+      }
+    }
+    return std::numeric_limits<float>::infinity();
+  }
+
+}  // namespace stdr_robot
@@ -0,0 +1,165 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/robot_pool.h>
+#include <pluginlib/class_list_macros.h>
+#include <algorithm>
+
+PLUGINLIB_EXPORT_CLASS(stdr_robot::RobotPool, nodelet::Nodelet)
+
+namespace stdr_robot
+{
+  /**
+  @brief Default constructor
+  @return void
+  **/
+  RobotPool::RobotPool(void)
+  {
+
+  }
+
+  /**
+  @brief Advertises the pool services and subscribes to the map
+  @return void
+  **/
+  void RobotPool::onInit(void)
+  {
+    ros::NodeHandle n = getMTNodeHandle();
+
+    _mapSubscriber = n.subscribe("map", 1, &RobotPool::mapCallback, this);
+
+    _loadRobotsService = n.advertiseService(
+      "robot_pool/load_robots", &RobotPool::loadRobotsCallback, this);
+    _unloadRobotService = n.advertiseService(
+      "robot_pool/unload_robot", &RobotPool::unloadRobotCallback, this);
+
+    //!< In lockstep the SimulationStepper steps the pooled robots
+    if ( !ros::Time::isSimTime() )
+    {
+      double collisionRate;
+      ros::param::param<double>("~collision_rate", collisionRate, 10.0);
+      _lastUpdate = ros::Time::now();
+      _updateTimer = n.createTimer(
+        ros::Duration(1.0 / std::max(collisionRate, 1.0)),
+        &RobotPool::updateCallback, this);
+    }
+  }
+
+  /**
+  @brief The callback of the load robots service
+  @param req [stdr_msgs::LoadPooledRobots::Request&] The service request
+  @param res [stdr_msgs::LoadPooledRobots::Response&] The service result
+  @return bool
+  **/
+  bool RobotPool::loadRobotsCallback(
+    stdr_msgs::LoadPooledRobots::Request& req,
+    stdr_msgs::LoadPooledRobots::Response& res)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+
+    for ( unsigned int i = 0; i < req.robots.size(); i++ )
+    {
+      if ( _robots.find(req.robots[i].name) != _robots.end() )
+      {
+        res.success = false;
+        res.message = "Duplicate robot name " + req.robots[i].name;
+        return true;
+      }
+    }
+
+    ros::NodeHandle n = getMTNodeHandle();
+    for ( unsigned int i = 0; i < req.robots.size(); i++ )
+    {
+      RobotPtr robot(
+        new Robot(req.robots[i].name, req.robots[i].robot, _map, _fleet, n) );
+      _robots.insert( std::make_pair(req.robots[i].name, robot) );
+      NODELET_INFO("Loaded new robot, %s", req.robots[i].name.c_str());
+    }
+
+    res.success = true;
+    return true;
+  }
+
+  /**
+  @brief The callback of the unload robot service
+  @param req [nodelet::NodeletUnload::Request&] The service request
+  @param res [nodelet::NodeletUnload::Response&] The service result
+  @return bool
+  **/
+  bool RobotPool::unloadRobotCallback(nodelet::NodeletUnload::Request& req,
+    nodelet::NodeletUnload::Response& res)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    res.success = _robots.erase(req.name) > 0;
+    return true;
+  }
+
+  /**
+  @brief Callback for getting the occupancy grid map
+  @param msg [const nav_msgs::OccupancyGridConstPtr&] The occupancy grid map
+  @return void
+  **/
+  void RobotPool::mapCallback(const nav_msgs::OccupancyGridConstPtr& msg)
+  {
+    SharedMapConstPtr map = MapStore::getInstance().getMap(msg);
+
+    boost::mutex::scoped_lock lock(_mutex);
+    _map = map;
+    for ( std::map<std::string, RobotPtr>::iterator it = _robots.begin();
+      it != _robots.end(); ++it )
+    {
+      it->second->setMap(map);
+    }
+  }
+
+  /**
+  @brief Moves the fleet and steps all robots on the pool timer, when \
+  not in lockstep
+  @param event [const ros::TimerEvent&] A ROS timer event
+  @return void
+  **/
+  void RobotPool::updateCallback(const ros::TimerEvent& event)
+  {
+    const ros::Time now = ros::Time::now();
+    const ros::Duration dt = now - _lastUpdate;
+    _lastUpdate = now;
+
+    boost::mutex::scoped_lock lock(_mutex);
+    _fleet.integrate(dt.toSec());
+    for ( std::map<std::string, RobotPtr>::iterator it = _robots.begin();
+      it != _robots.end(); ++it )
+    {
+      it->second->step(now);
+    }
+  }
+
+  /**
+  @brief Default destructor
+  @return void
+  **/
+  RobotPool::~RobotPool(void)
+  {
+    _updateTimer.stop();
+    boost::mutex::scoped_lock lock(_mutex);
+    _robots.clear();
+  }
+
+}  // namespace stdr_robot
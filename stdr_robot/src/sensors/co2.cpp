@@ -25,29 +25,28 @@ namespace stdr_robot {
   
   /**
   @brief Default constructor
-  @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+  @param map [const SharedMapConstPtr&] The shared map of the robot
+  @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
   @param msg [const stdr_msgs::CO2SensorMsg&] The sensor description message
   @param name [const std::string&] The sensor frame id without the base
   @param n [ros::NodeHandle&] The ROS node handle
   @return void
   **/ 
   CO2Sensor::CO2Sensor(
-    const nav_msgs::OccupancyGrid& map,
+    const SharedMapConstPtr& map,
+    const RobotPoseConstPtr& robotPose,
     const stdr_msgs::CO2SensorMsg& msg, 
     const std::string& name,
     ros::NodeHandle& n)
-    : Sensor(map, name, n, msg.pose, msg.frame_id, msg.frequency)
+    : Sensor(map, robotPose, name, n, msg.pose, msg.frame_id, msg.frequency)
   {
     _description = msg;
 
     _publisher = n.advertise<stdr_msgs::CO2SensorMeasurementMsg>
       ( _namespace + "/" + msg.frame_id, 1 );
       
-    co2_sources_subscriber_ = n.subscribe(
-      "stdr_server/co2_sources_list", 
-      1, 
-      &CO2Sensor::receiveCO2Sources,
-      this);
+    //!< Subscribes the process to the sources, once
+    SourceStore::getInstance();
   }
   
   /**
@@ -65,49 +64,51 @@ namespace stdr_robot {
   **/ 
   void CO2Sensor::updateSensorCallback() 
   {
-    if (co2_sources_.co2_sources.size() == 0) return;    
+    CO2SourceIndexConstPtr sources =
+      SourceStore::getInstance().getCO2Sources();
+    if (!sources || sources->size() == 0) return;    
 
-    stdr_msgs::CO2SensorMeasurementMsg measuredSourcesMsg;
+    _measuredSourcesMsg = stdr_msgs::CO2SensorMeasurementMsg();
 
-    measuredSourcesMsg.header.frame_id = _description.frame_id;
+    _measuredSourcesMsg.header.frame_id = _description.frame_id;
 
     float max_range = _description.maxRange;
-    ///!< Must implement the functionality
-    for(unsigned int i = 0 ; i < co2_sources_.co2_sources.size() ; i++)
+    float sensor_x = _sensorTransform.getOrigin().x();
+    float sensor_y = _sensorTransform.getOrigin().y();
+
+    //!< Only the sources within range, from the cells around the sensor
+    sources->query(sensor_x, sensor_y, max_range, _foundSources);
+    for(unsigned int i = 0 ; i < _foundSources.size() ; i++)
     {
+      const stdr_msgs::CO2Source& source =
+        sources->getSource(_foundSources[i]);
+
       //!< Calculate distance
-      float sensor_x = _sensorTransform.getOrigin().x();
-      float sensor_y = _sensorTransform.getOrigin().y();
-      float dist = sqrt(
-        pow(sensor_x - co2_sources_.co2_sources[i].pose.x, 2) +
-        pow(sensor_y - co2_sources_.co2_sources[i].pose.y, 2)
-      );
-      if(dist > max_range)
+      float dx = sensor_x - source.pose.x;
+      float dy = sensor_y - source.pose.y;
+      float distSquared = dx * dx + dy * dy;
+      if(distSquared > 0.25)
       {
-        continue;
-      }
-      if(dist > 0.5)
-      {
-        measuredSourcesMsg.co2_ppm += co2_sources_.co2_sources[i].ppm *
-          pow(0.5, 2) / pow(dist, 2);
+        _measuredSourcesMsg.co2_ppm += source.ppm * 0.25 / distSquared;
       }
       else
       {
-        measuredSourcesMsg.co2_ppm += co2_sources_.co2_sources[i].ppm;
+        _measuredSourcesMsg.co2_ppm += source.ppm;
       }
     }
     
-    measuredSourcesMsg.header.stamp = ros::Time::now();
-    measuredSourcesMsg.header.frame_id = _namespace + "_" + _description.frame_id;
-    _publisher.publish( measuredSourcesMsg );
+    _measuredSourcesMsg.header.stamp = ros::Time::now();
+    _measuredSourcesMsg.header.frame_id = _frameId;
+    _hasMeasurement = true;
   }
   
   /**
-  @brief Receives the existent sources
+  @brief Publishes the measurement of the last update
+  @return void
   **/
-  void CO2Sensor::receiveCO2Sources(const stdr_msgs::CO2SourceVector& msg)
+  void CO2Sensor::publishLastMeasurement(void)
   {
-    co2_sources_ = msg;
+    _publisher.publish( _measuredSourcesMsg );
   }
 
 }  // namespace stdr_robot
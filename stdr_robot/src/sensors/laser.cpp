@@ -25,21 +25,52 @@ namespace stdr_robot {
 
   /**
   @brief Default constructor
-  @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+  @param map [const SharedMapConstPtr&] The shared map of the robot
+  @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
   @param msg [const stdr_msgs::LaserSensorMsg&] The laser description message
   @param name [const std::string&] The sensor frame id without the base
   @param n [ros::NodeHandle&] The ROS node handle
   @return void
   **/ 
-  Laser::Laser(const nav_msgs::OccupancyGrid& map,
+  Laser::Laser(const SharedMapConstPtr& map,
+      const RobotPoseConstPtr& robotPose,
       const stdr_msgs::LaserSensorMsg& msg, 
       const std::string& name,
       ros::NodeHandle& n)
   : 
-    Sensor(map, name, n, msg.pose, msg.frame_id, msg.frequency)
+    Sensor(map, robotPose, name, n, msg.pose, msg.frame_id, msg.frequency),
+    _rangeNoise(msg.noise, msg.maxRange)
   {
     _description = msg;
 
+    int divisions = 1;
+    if ( _description.numRays > 1 )
+    {
+      divisions = _description.numRays - 1;
+    }
+    for ( int laserScanIter = 0; laserScanIter < _description.numRays;
+      laserScanIter++ )
+    {
+      _beams.addBeam( _description.minAngle + laserScanIter *
+        ( _description.maxAngle - _description.minAngle ) / divisions );
+    }
+    _rayDistances.resize( _beams.size() );
+
+    sensor_msgs::LaserScan scan;
+    scan.header.frame_id = _frameId;
+    scan.angle_min = _description.minAngle;
+    scan.angle_max = _description.maxAngle;
+    scan.range_max = _description.maxRange;
+    scan.range_min = _description.minRange;
+    scan.angle_increment = 
+      ( _description.maxAngle - _description.minAngle ) / divisions;
+    scan.ranges.resize( _beams.size() );
+    for ( int i = 0; i < SCAN_BUFFERS; i++ )
+    {
+      _laserScans[i].reset( new sensor_msgs::LaserScan(scan) );
+    }
+    _currentScan = 0;
+
     _publisher = n.advertise<sensor_msgs::LaserScan>
       ( _namespace + "/" + msg.frame_id, 1 );
   }
@@ -50,75 +81,68 @@ namespace stdr_robot {
   **/ 
   void Laser::updateSensorCallback() 
   {
-    float angle;
-    int distance;
-    int xMap, yMap;
-    int divisions = 1;
-    sensor_msgs::LaserScan _laserScan;
+    float range;
 
-    if ( _description.numRays > 1 )
+    SharedMapConstPtr map = getMap();
+    if ( !map || map->getGrid().info.height == 0 || 
+      map->getGrid().info.width == 0 ) 
     {
-        divisions = _description.numRays - 1;
+      ROS_DEBUG("Outside limits\n");
+      return;
     }
-    
-    _laserScan.angle_min = _description.minAngle;
-    _laserScan.angle_max = _description.maxAngle;
-    _laserScan.range_max = _description.maxRange;
-    _laserScan.range_min = _description.minRange;
-    _laserScan.angle_increment = 
-      ( _description.maxAngle - _description.minAngle ) / divisions;
+    const float resolution = map->getGrid().info.resolution;
 
+    _beams.rotate(_sensorTransform);
 
-    if ( _map.info.height == 0 || _map.info.width == 0 ) 
+    if ( _beams.size() > 0 )
     {
-      ROS_DEBUG("Outside limits\n");
-      return;
+      map->getRayCaster().traceBatch(
+        _sensorTransform.getOrigin().x() / resolution,
+        _sensorTransform.getOrigin().y() / resolution,
+        _beams.getCosines(), _beams.getSines(), _beams.size(),
+        _description.maxRange / resolution, &_rayDistances[0]);
+    }
+
+    //!< Intra-process subscribers may still hold the previous scans
+    _currentScan = ( _currentScan + 1 ) % SCAN_BUFFERS;
+    if ( !_laserScans[_currentScan].unique() )
+    {
+      _laserScans[_currentScan].reset( new sensor_msgs::LaserScan(
+        *_laserScans[ ( _currentScan + 1 ) % SCAN_BUFFERS ]) );
+    }
+    sensor_msgs::LaserScan& scan = *_laserScans[_currentScan];
+
+    for ( int laserScanIter = 0; laserScanIter < _beams.size(); 
+      laserScanIter++ )
+    {
+      _rayDistances[laserScanIter] *= resolution;
     }
-    for ( int laserScanIter = 0; laserScanIter < _description.numRays; 
+    _rangeNoise.apply(_noise, &_rayDistances[0], _beams.size());
+
+    for ( int laserScanIter = 0; laserScanIter < _beams.size(); 
       laserScanIter++ )
     {
+      range = _rayDistances[laserScanIter];
 
-      angle = tf::getYaw(_sensorTransform.getRotation()) + 
-        _description.minAngle + laserScanIter * 
-          ( _description.maxAngle - _description.minAngle ) 
-            / divisions;
-      
-      distance = 1;
-
-      while ( distance <= _description.maxRange / _map.info.resolution )
-      {
-        xMap = _sensorTransform.getOrigin().x() / _map.info.resolution + 
-          cos( angle ) * distance;
-        
-        yMap = _sensorTransform.getOrigin().y() / _map.info.resolution + 
-          sin( angle ) * distance;
-        
-        if (yMap * _map.info.width + xMap > _map.info.height*_map.info.width ||
-            yMap * _map.info.width + xMap < 0)
-        {
-          distance = _description.maxRange / _map.info.resolution - 1;
-          break;
-        }
-        
-        if ( _map.data[ yMap * _map.info.width + xMap ] > 70 )
-        {
-          break;
-        }
-        
-        distance ++;
-      }
-
-      if ( distance * _map.info.resolution > _description.maxRange )
-        _laserScan.ranges.push_back( std::numeric_limits<float>::infinity() );
-      else if ( distance * _map.info.resolution < _description.minRange )
-        _laserScan.ranges.push_back(- std::numeric_limits<float>::infinity() );
+      if ( range > _description.maxRange )
+        scan.ranges[laserScanIter] = std::numeric_limits<float>::infinity();
+      else if ( range < _description.minRange )
+        scan.ranges[laserScanIter] = - std::numeric_limits<float>::infinity();
       else
-        _laserScan.ranges.push_back( distance * _map.info.resolution );
+        scan.ranges[laserScanIter] = range;
     }
     
-    _laserScan.header.stamp = ros::Time::now();
-    _laserScan.header.frame_id = _namespace + "_" + _description.frame_id;
-    _publisher.publish( _laserScan );
+    scan.header.stamp = ros::Time::now();
+    _hasMeasurement = true;
+  }
+
+  /**
+  @brief Publishes the measurement of the last update
+  @return void
+  **/
+  void Laser::publishLastMeasurement(void)
+  {
+    _publisher.publish( _laserScans[_currentScan] );
   }
 
 }  // namespace stdr_robot
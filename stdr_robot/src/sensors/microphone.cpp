@@ -25,29 +25,28 @@ namespace stdr_robot {
   
   /**
   @brief Default constructor
-  @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+  @param map [const SharedMapConstPtr&] The shared map of the robot
+  @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
   @param msg [const stdr_msgs::SoundSensorMsg&] The sensor description message
   @param name [const std::string&] The sensor frame id without the base
   @param n [ros::NodeHandle&] The ROS node handle
   @return void
   **/ 
   SoundSensor::SoundSensor(
-    const nav_msgs::OccupancyGrid& map,
+    const SharedMapConstPtr& map,
+    const RobotPoseConstPtr& robotPose,
     const stdr_msgs::SoundSensorMsg& msg, 
     const std::string& name,
     ros::NodeHandle& n)
-    : Sensor(map, name, n, msg.pose, msg.frame_id, msg.frequency)
+    : Sensor(map, robotPose, name, n, msg.pose, msg.frame_id, msg.frequency)
   {
     _description = msg;
 
     _publisher = n.advertise<stdr_msgs::SoundSensorMeasurementMsg>
       ( _namespace + "/" + msg.frame_id, 1 );
       
-    sound_sources_subscriber_ = n.subscribe(
-      "stdr_server/sound_sources_list", 
-      1, 
-      &SoundSensor::receiveSoundSources,
-      this);
+    //!< Subscribes the process to the sources, once
+    SourceStore::getInstance();
   }
   
   /**
@@ -65,66 +64,62 @@ namespace stdr_robot {
   **/ 
   void SoundSensor::updateSensorCallback() 
   {
-    if (sound_sources_.sound_sources.size() == 0) return;    
+    SoundSourceIndexConstPtr sources =
+      SourceStore::getInstance().getSoundSources();
+    if (!sources || sources->size() == 0) return;    
 
-    stdr_msgs::SoundSensorMeasurementMsg measuredSourcesMsg;
+    _measuredSourcesMsg = stdr_msgs::SoundSensorMeasurementMsg();
 
-    measuredSourcesMsg.header.frame_id = _description.frame_id;
-    measuredSourcesMsg.sound_dbs = 0; //!< 0 db for silence
+    _measuredSourcesMsg.header.frame_id = _description.frame_id;
+    _measuredSourcesMsg.sound_dbs = 0; //!< 0 db for silence
     
     float max_range = _description.maxRange;
     float sensor_th = tf::getYaw(_sensorTransform.getRotation());
     float min_angle = sensor_th - _description.angleSpan / 2.0;
     float max_angle = sensor_th + _description.angleSpan / 2.0;
+    float sensor_x = _sensorTransform.getOrigin().x();
+    float sensor_y = _sensorTransform.getOrigin().y();
     
-    //!< Must implement the functionality
-    for(unsigned int i = 0 ; i < sound_sources_.sound_sources.size() ; i++)
+    //!< Only the sources within max distance, from the cells around the sensor
+    sources->query(sensor_x, sensor_y, max_range, _foundSources);
+    for(unsigned int i = 0 ; i < _foundSources.size() ; i++)
     {
-      //!< Check for max distance
-      float sensor_x = _sensorTransform.getOrigin().x();
-      float sensor_y = _sensorTransform.getOrigin().y();
-      float dist = sqrt(
-        pow(sensor_x - sound_sources_.sound_sources[i].pose.x, 2) +
-        pow(sensor_y - sound_sources_.sound_sources[i].pose.y, 2)
-      );
-      if(dist > max_range)
-      {
-        continue;
-      }
+      const stdr_msgs::SoundSource& source =
+        sources->getSource(_foundSources[i]);
       
       //!< Check for correct angle
-      float ang = atan2(
-        sound_sources_.sound_sources[i].pose.y - sensor_y,
-        sound_sources_.sound_sources[i].pose.x - sensor_x);
+      float ang = atan2(source.pose.y - sensor_y, source.pose.x - sensor_x);
       
       if(!stdr_robot::angCheck(ang, min_angle, max_angle))
       {
         continue;
       }
       
-      if(dist > 0.5)
+      float dx = sensor_x - source.pose.x;
+      float dy = sensor_y - source.pose.y;
+      float distSquared = dx * dx + dy * dy;
+      if(distSquared > 0.25)
       {
-        measuredSourcesMsg.sound_dbs += sound_sources_.sound_sources[i].dbs *
-          pow(0.5, 2) / pow(dist, 2);
+        _measuredSourcesMsg.sound_dbs += source.dbs * 0.25 / distSquared;
       }
       else
       {
-        measuredSourcesMsg.sound_dbs += sound_sources_.sound_sources[i].dbs;
+        _measuredSourcesMsg.sound_dbs += source.dbs;
       }
     }
     
-    measuredSourcesMsg.header.stamp = ros::Time::now();
-    measuredSourcesMsg.header.frame_id = 
-      _namespace + "_" + _description.frame_id;
-    _publisher.publish( measuredSourcesMsg );
+    _measuredSourcesMsg.header.stamp = ros::Time::now();
+    _measuredSourcesMsg.header.frame_id = _frameId;
+    _hasMeasurement = true;
   }
   
   /**
-  @brief Receives the existent sources
+  @brief Publishes the measurement of the last update
+  @return void
   **/
-  void SoundSensor::receiveSoundSources(const stdr_msgs::SoundSourceVector& msg)
+  void SoundSensor::publishLastMeasurement(void)
   {
-    sound_sources_ = msg;
+    _publisher.publish( _measuredSourcesMsg );
   }
 
 }  // namespace stdr_robot
@@ -0,0 +1,112 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/sensors/range_noise.h>
+#include <ros/ros.h>
+#include <limits>
+
+namespace stdr_robot {
+
+  /**
+  @brief Default constructor
+  @param noise [const stdr_msgs::Noise&] The sensor noise description
+  @param maxRange [float] The max range of the sensor
+  @return void
+  **/
+  RangeNoise::RangeNoise(const stdr_msgs::Noise& noise, float maxRange)
+    :
+      _gaussian(noise.noise && noise.noiseStd > 0),
+      _mean(noise.noiseMean),
+      _std(noise.noiseStd),
+      _maxRange(maxRange)
+  {
+    ros::param::param<double>("~range_dropout_probability",
+      _dropoutProbability, 0.0);
+    ros::param::param<double>("~range_max_return_probability",
+      _maxReturnProbability, 0.0);
+  }
+
+  /**
+  @brief Constructor with explicit dropout probabilities
+  @param noise [const stdr_msgs::Noise&] The sensor noise description
+  @param maxRange [float] The max range of the sensor
+  @param dropoutProbability [double] Probability of a dropped return
+  @param maxReturnProbability [double] Probability of a max range return
+  @return void
+  **/
+  RangeNoise::RangeNoise(const stdr_msgs::Noise& noise, float maxRange,
+    double dropoutProbability, double maxReturnProbability)
+    :
+      _gaussian(noise.noise && noise.noiseStd > 0),
+      _mean(noise.noiseMean),
+      _std(noise.noiseStd),
+      _maxRange(maxRange),
+      _dropoutProbability(dropoutProbability),
+      _maxReturnProbability(maxReturnProbability)
+  {
+  }
+
+  /**
+  @brief Applies the noise to the ranges of one measurement. Dropped \
+  returns become NaN and max range returns +inf.
+  @param engine [NoiseEngine&] The noise engine of the sensor
+  @param ranges [float*] The ranges in meters
+  @param size [unsigned int] The number of ranges
+  @return void
+  **/
+  void RangeNoise::apply(NoiseEngine& engine, float* ranges,
+    unsigned int size)
+  {
+    if ( size == 0 )
+    {
+      return;
+    }
+
+    if ( _gaussian )
+    {
+      //!< All samples at once, then a branch free pass over the ranges
+      _samples.resize(size);
+      engine.fillNormal(&_samples[0], size, _mean, _std);
+      for ( unsigned int i = 0 ; i < size ; i++ )
+      {
+        ranges[i] += ranges[i] < _maxRange ? _samples[i] : 0.0f;
+      }
+    }
+
+    if ( _dropoutProbability > 0 || _maxReturnProbability > 0 )
+    {
+      const double maxReturn = _dropoutProbability + _maxReturnProbability;
+      for ( unsigned int i = 0 ; i < size ; i++ )
+      {
+        const double u = engine.uniform();
+        if ( u < _dropoutProbability )
+        {
+          ranges[i] = std::numeric_limits<float>::quiet_NaN();
+        }
+        else if ( u < maxReturn )
+        {
+          ranges[i] = std::numeric_limits<float>::infinity();
+        }
+      }
+    }
+  }
+
+}  // namespace stdr_robot
@@ -0,0 +1,254 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/sensors/ray_caster.h>
+#include <limits>
+
+namespace stdr_robot {
+
+  const double RayCaster::SQRT2 = 1.41421356237;
+  const double RayCaster::SKIP_TOLERANCE = 0.05;
+  const double RayCaster::MIN_SKIP = 2.0;
+
+  /**
+  @brief Default constructor
+  @param occupancy [const OccupancyBitmap&] The occupied cells of the map
+  @param pyramid [const OccupancyPyramid&] The occupancy pyramid of the map
+  @return void
+  **/
+  RayCaster::RayCaster(const OccupancyBitmap& occupancy,
+    const OccupancyPyramid& pyramid)
+    :
+      _occupancy(occupancy),
+      _pyramid(pyramid)
+  {
+    _layout.resize(0, 0);
+  }
+
+  /**
+  @brief Rebuilds the distance transform. Must be called every time \
+  the map changes.
+  @return void
+  **/
+  void RayCaster::updateMap(void)
+  {
+    const int width = _occupancy.getWidth();
+    const int height = _occupancy.getHeight();
+    _layout.resize(width, height);
+
+    std::vector<float> distances(width * height);
+    if ( distances.size() == 0 )
+    {
+      _distances.swap(distances);
+      return;
+    }
+
+    //!< Squared distances are bounded by the map diagonal
+    const float inf = std::numeric_limits<float>::max();
+    const int n = std::max(width, height);
+    std::vector<float> f(n), d(n), z(n + 1);
+    std::vector<int> v(n);
+
+    for ( int y = 0; y < height; y++ )
+    {
+      for ( int x = 0; x < width; x++ )
+      {
+        distances[y * width + x] = _occupancy(x, y) ? 0 : inf;
+      }
+    }
+
+    //!< Columns first
+    for ( int x = 0; x < width; x++ )
+    {
+      for ( int y = 0; y < height; y++ )
+      {
+        f[y] = distances[y * width + x];
+      }
+      distanceTransform1D(&f[0], height, &d[0], &v[0], &z[0]);
+      for ( int y = 0; y < height; y++ )
+      {
+        distances[y * width + x] = d[y];
+      }
+    }
+
+    //!< Then rows, on top of the column distances, stored tiled
+    std::vector<float> tiled(_layout.size(), 0);
+    for ( int y = 0; y < height; y++ )
+    {
+      distanceTransform1D(&distances[y * width], width,
+        &d[0], &v[0], &z[0]);
+      for ( int x = 0; x < width; x++ )
+      {
+        tiled[ _layout.index(x, y) ] = sqrt(d[x]);
+      }
+    }
+
+    _distances.swap(tiled);
+  }
+
+  /**
+  @brief Traces a ray through every cell it crosses, starting from a \
+  point in map cells
+  @param xMap [double] The ray origin x in cells
+  @param yMap [double] The ray origin y in cells
+  @param cosAngle [double] The cosine of the ray angle
+  @param sinAngle [double] The sine of the ray angle
+  @param maxDistance [double] The maximum ray distance in cells
+  @return float : The distance to the first occupied cell in cells, \
+  infinity if the ray leaves the map or exceeds its range
+  **/
+  float RayCaster::trace(double xMap, double yMap,
+    double cosAngle, double sinAngle, double maxDistance) const
+  {
+    if ( _occupancy.empty() )
+    {
+      return std::numeric_limits<float>::infinity();
+    }
+
+    if ( _distances.empty() )
+    {
+      return _pyramid.castRay(xMap, yMap, cosAngle, sinAngle, maxDistance);
+    }
+
+    GridRay ray;
+    ray.start(xMap, yMap, cosAngle, sinAngle, 0);
+
+    while ( ray.t <= maxDistance )
+    {
+      if ( ray.x < 0 || ray.y < 0 ||
+        ray.x >= _layout.width || ray.y >= _layout.height )
+      {
+        break;
+      }
+
+      float distance = _distances[ _layout.index(ray.x, ray.y) ];
+      if ( distance == 0 )
+      {
+        return ray.t;
+      }
+
+      //!< Every cell closer than the clearance minus a diagonal is free
+      double skip = distance - SQRT2 - SKIP_TOLERANCE;
+      if ( skip >= MIN_SKIP )
+      {
+        ray.start(xMap, yMap, cosAngle, sinAngle, ray.t + skip);
+      }
+      else
+      {
+        ray.next();
+      }
+    }
+    return std::numeric_limits<float>::infinity();
+  }
+
+  /**
+  @brief Traces a batch of rays sharing an origin. Uses the SIMD \
+  kernels of castRays when the distance transform is available.
+  @param xMap [double] The rays origin x in cells
+  @param yMap [double] The rays origin y in cells
+  @param cosAngles [const float*] The cosines of the ray angles
+  @param sinAngles [const float*] The sines of the ray angles
+  @param count [int] The number of rays
+  @param maxDistance [double] The maximum ray distance in cells
+  @param distances [float*] The distances to the first occupied cells \
+  in cells, infinity where nothing was hit
+  @return void
+  **/
+  void RayCaster::traceBatch(double xMap, double yMap,
+    const float* cosAngles, const float* sinAngles, int count,
+    double maxDistance, float* distances) const
+  {
+    if ( _distances.empty() )
+    {
+      for ( int i = 0; i < count; i++ )
+      {
+        distances[i] = trace(xMap, yMap, cosAngles[i], sinAngles[i],
+          maxDistance);
+      }
+      return;
+    }
+
+    DistanceGrid grid = { &_distances[0], _layout };
+    castRays(grid, xMap, yMap, cosAngles, sinAngles, count, maxDistance,
+      distances);
+  }
+
+  /**
+  @brief Computes the 1D squared distance transform of a sampled function. \
+  Lower envelope of parabolas, as in Felzenszwalb & Huttenlocher.
+  @param f [const float*] The sampled function
+  @param n [int] The number of samples
+  @param d [float*] The output squared distances
+  @param v [int*] Scratch buffer for parabola locations (n)
+  @param z [float*] Scratch buffer for parabola boundaries (n + 1)
+  @return void
+  **/
+  void RayCaster::distanceTransform1D(const float* f, int n, float* d,
+    int* v, float* z)
+  {
+    const float inf = std::numeric_limits<float>::max();
+    int k = -1;
+
+    for ( int q = 0; q < n; q++ )
+    {
+      if ( f[q] == inf )
+      {
+        continue;
+      }
+      float s = 0;
+      while ( k >= 0 )
+      {
+        s = ( ( f[q] + q * q ) - ( f[v[k]] + v[k] * v[k] ) ) /
+          ( 2.0 * ( q - v[k] ) );
+        if ( s > z[k] )
+        {
+          break;
+        }
+        k--;
+      }
+      k++;
+      v[k] = q;
+      z[k] = ( k == 0 ) ? -inf : s;
+      z[k + 1] = inf;
+    }
+
+    //!< No obstacle in this line
+    if ( k < 0 )
+    {
+      for ( int q = 0; q < n; q++ )
+      {
+        d[q] = inf;
+      }
+      return;
+    }
+
+    k = 0;
+    for ( int q = 0; q < n; q++ )
+    {
+      while ( z[k + 1] < q )
+      {
+        k++;
+      }
+      d[q] = ( q - v[k] ) * ( q - v[k] ) + f[v[k]];
+    }
+  }
+
+}  // namespace stdr_robot
@@ -0,0 +1,144 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+
+#include <stdr_robot/sensors/raycast.h>
+
+namespace stdr_robot {
+
+  namespace {
+
+    typedef void (*CastRaysKernel)(const DistanceGrid&, float, float,
+      const float*, const float*, int, float, float*);
+
+    /**
+    @brief Picks the widest castRays kernel supported by the cpu
+    @return CastRaysKernel
+    **/
+    CastRaysKernel selectKernel(void)
+    {
+#ifdef STDR_RAYCAST_SIMD
+      __builtin_cpu_init();
+      if ( __builtin_cpu_supports("avx2") )
+      {
+        return castRaysAVX2;
+      }
+      if ( __builtin_cpu_supports("sse4.1") )
+      {
+        return castRaysSSE4;
+      }
+#endif
+      return castRaysScalar;
+    }
+
+  }
+
+  /**
+  @brief Casts a batch of rays sharing an origin on a distance grid
+  @return void
+  **/
+  void castRays(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances)
+  {
+    static const CastRaysKernel kernel = selectKernel();
+    kernel(grid, originX, originY, dirX, dirY, count, maxDistance, distances);
+  }
+
+  /**
+  @brief Portable kernel of castRays, one ray at a time. Performs the exact \
+  same single precision operations as one lane of the SIMD kernels.
+  @return void
+  **/
+  void castRaysScalar(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances)
+  {
+    for ( int i = 0; i < count; i++ )
+    {
+      const float dx = dirX[i];
+      const float dy = dirY[i];
+      const int stepX = dx > 0 ? 1 : ( dx < 0 ? -1 : 0 );
+      const int stepY = dy > 0 ? 1 : ( dy < 0 ? -1 : 0 );
+      const float tDeltaX = 1.0f / fabsf(dx);
+      const float tDeltaY = 1.0f / fabsf(dy);
+
+      float t = 0;
+      bool restart = true;
+      float tMaxX, tMaxY;
+      int x, y;
+
+      distances[i] = INFINITY;
+      while ( true )
+      {
+        if ( restart )
+        {
+          const float px = originX + dx * t;
+          const float py = originY + dy * t;
+          const float fx = floorf(px);
+          const float fy = floorf(py);
+          const float fracX = dx > 0 ? ( fx + 1.0f ) - px :
+            ( dx < 0 ? px - fx : 1.0f );
+          const float fracY = dy > 0 ? ( fy + 1.0f ) - py :
+            ( dy < 0 ? py - fy : 1.0f );
+          x = fx;
+          y = fy;
+          tMaxX = t + fracX * tDeltaX;
+          tMaxY = t + fracY * tDeltaY;
+          restart = false;
+        }
+
+        if ( t > maxDistance || x < 0 || y < 0 ||
+          x >= grid.layout.width || y >= grid.layout.height )
+        {
+          break;
+        }
+
+        const float clearance = grid.distances[ grid.layout.index(x, y) ];
+        if ( clearance == 0 )
+        {
+          distances[i] = t;
+          break;
+        }
+
+        const float skip = clearance - RAYCAST_SKIP_OFFSET;
+        if ( skip >= RAYCAST_MIN_SKIP )
+        {
+          t = t + skip;
+          restart = true;
+        }
+        else if ( tMaxX < tMaxY )
+        {
+          t = tMaxX;
+          tMaxX = tMaxX + tDeltaX;
+          x += stepX;
+        }
+        else
+        {
+          t = tMaxY;
+          tMaxY = tMaxY + tDeltaY;
+          y += stepY;
+        }
+      }
+    }
+  }
+
+}  // namespace stdr_robot
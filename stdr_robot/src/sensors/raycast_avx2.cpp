@@ -0,0 +1,185 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+
+#include <stdr_robot/sensors/raycast.h>
+#include <immintrin.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief AVX2 kernel of castRays, 8 rays in lockstep. Lanes retire as \
+  their rays hit an obstacle, leave the map or run out of range. Built \
+  with -mavx2 and only called after a runtime cpu check.
+  @return void
+  **/
+  void castRaysAVX2(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances)
+  {
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 infinity = _mm256_set1_ps(INFINITY);
+    const __m256 skipOffset = _mm256_set1_ps(RAYCAST_SKIP_OFFSET);
+    const __m256 minSkip = _mm256_set1_ps(RAYCAST_MIN_SKIP);
+    const __m256 ox = _mm256_set1_ps(originX);
+    const __m256 oy = _mm256_set1_ps(originY);
+    const __m256 maxD = _mm256_set1_ps(maxDistance);
+    const __m256i zeroi = _mm256_setzero_si256();
+    const __m256i onei = _mm256_set1_epi32(1);
+    const __m256i tilesPerRow = _mm256_set1_epi32(grid.layout.tilesPerRow);
+    const __m256i tileMask = _mm256_set1_epi32(TiledLayout::TILE_SIZE - 1);
+    const __m256i lastX = _mm256_set1_epi32(grid.layout.width - 1);
+    const __m256i lastY = _mm256_set1_epi32(grid.layout.height - 1);
+    const __m256i laneIds = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for ( int first = 0; first < count; first += 8 )
+    {
+      const int lanes = count - first < 8 ? count - first : 8;
+      float bufX[8], bufY[8], out[8];
+      for ( int i = 0; i < 8; i++ )
+      {
+        bufX[i] = i < lanes ? dirX[first + i] : 1.0f;
+        bufY[i] = i < lanes ? dirY[first + i] : 0.0f;
+      }
+
+      const __m256 dx = _mm256_loadu_ps(bufX);
+      const __m256 dy = _mm256_loadu_ps(bufY);
+      const __m256 posX = _mm256_cmp_ps(dx, zero, _CMP_GT_OQ);
+      const __m256 negX = _mm256_cmp_ps(dx, zero, _CMP_LT_OQ);
+      const __m256 posY = _mm256_cmp_ps(dy, zero, _CMP_GT_OQ);
+      const __m256 negY = _mm256_cmp_ps(dy, zero, _CMP_LT_OQ);
+      const __m256i stepX = _mm256_sub_epi32(
+        _mm256_and_si256(_mm256_castps_si256(posX), onei),
+        _mm256_and_si256(_mm256_castps_si256(negX), onei));
+      const __m256i stepY = _mm256_sub_epi32(
+        _mm256_and_si256(_mm256_castps_si256(posY), onei),
+        _mm256_and_si256(_mm256_castps_si256(negY), onei));
+      const __m256 tDeltaX = _mm256_div_ps(one, _mm256_and_ps(dx, absMask));
+      const __m256 tDeltaY = _mm256_div_ps(one, _mm256_and_ps(dy, absMask));
+
+      __m256 active = _mm256_castsi256_ps(
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(lanes), laneIds));
+      __m256 restart = active;
+      __m256 result = infinity;
+      __m256 t = zero;
+      __m256 tMaxX = zero;
+      __m256 tMaxY = zero;
+      __m256i x = zeroi;
+      __m256i y = zeroi;
+
+      while ( _mm256_movemask_ps(active) )
+      {
+        //!< Lanes that jumped, or just started, re-enter the grid
+        if ( _mm256_movemask_ps(restart) )
+        {
+          const __m256 px = _mm256_add_ps(ox, _mm256_mul_ps(dx, t));
+          const __m256 py = _mm256_add_ps(oy, _mm256_mul_ps(dy, t));
+          const __m256 fx = _mm256_floor_ps(px);
+          const __m256 fy = _mm256_floor_ps(py);
+          const __m256 fracX = _mm256_blendv_ps(
+            _mm256_blendv_ps(one, _mm256_sub_ps(px, fx), negX),
+            _mm256_sub_ps(_mm256_add_ps(fx, one), px), posX);
+          const __m256 fracY = _mm256_blendv_ps(
+            _mm256_blendv_ps(one, _mm256_sub_ps(py, fy), negY),
+            _mm256_sub_ps(_mm256_add_ps(fy, one), py), posY);
+          const __m256i restarti = _mm256_castps_si256(restart);
+
+          x = _mm256_blendv_epi8(x, _mm256_cvttps_epi32(fx), restarti);
+          y = _mm256_blendv_epi8(y, _mm256_cvttps_epi32(fy), restarti);
+          tMaxX = _mm256_blendv_ps(tMaxX,
+            _mm256_add_ps(t, _mm256_mul_ps(fracX, tDeltaX)), restart);
+          tMaxY = _mm256_blendv_ps(tMaxY,
+            _mm256_add_ps(t, _mm256_mul_ps(fracY, tDeltaY)), restart);
+        }
+
+        //!< Retire the lanes that left the map or ran out of range
+        __m256i outside = _mm256_or_si256(
+          _mm256_or_si256(_mm256_cmpgt_epi32(zeroi, x),
+            _mm256_cmpgt_epi32(zeroi, y)),
+          _mm256_or_si256(_mm256_cmpgt_epi32(x, lastX),
+            _mm256_cmpgt_epi32(y, lastY)));
+        active = _mm256_andnot_ps(
+          _mm256_or_ps(_mm256_castsi256_ps(outside),
+            _mm256_cmp_ps(t, maxD, _CMP_GT_OQ)),
+          active);
+        if ( !_mm256_movemask_ps(active) )
+        {
+          break;
+        }
+
+        //!< TiledLayout::index, retired lanes read the first cell
+        const __m256i tile = _mm256_add_epi32(
+          _mm256_mullo_epi32(
+            _mm256_srai_epi32(y, TiledLayout::TILE_SHIFT), tilesPerRow),
+          _mm256_srai_epi32(x, TiledLayout::TILE_SHIFT));
+        const __m256i cell = _mm256_or_si256(
+          _mm256_slli_epi32(_mm256_and_si256(y, tileMask),
+            TiledLayout::TILE_SHIFT),
+          _mm256_and_si256(x, tileMask));
+        const __m256i index = _mm256_and_si256(
+          _mm256_or_si256(
+            _mm256_slli_epi32(tile, 2 * TiledLayout::TILE_SHIFT), cell),
+          _mm256_castps_si256(active));
+        const __m256 clearance =
+          _mm256_i32gather_ps(grid.distances, index, 4);
+
+        const __m256 hit = _mm256_and_ps(
+          _mm256_cmp_ps(clearance, zero, _CMP_EQ_OQ), active);
+        result = _mm256_blendv_ps(result, t, hit);
+        active = _mm256_andnot_ps(hit, active);
+
+        const __m256 skip = _mm256_sub_ps(clearance, skipOffset);
+        const __m256 jump = _mm256_and_ps(
+          _mm256_cmp_ps(skip, minSkip, _CMP_GE_OQ), active);
+        const __m256 walk = _mm256_andnot_ps(jump, active);
+
+        //!< One traversal step for the lanes close to obstacles
+        const __m256 alongX = _mm256_cmp_ps(tMaxX, tMaxY, _CMP_LT_OQ);
+        const __m256i alongXi = _mm256_castps_si256(alongX);
+        const __m256i walki = _mm256_castps_si256(walk);
+        const __m256 tNext = _mm256_blendv_ps(tMaxY, tMaxX, alongX);
+
+        tMaxX = _mm256_blendv_ps(tMaxX, _mm256_add_ps(tMaxX, tDeltaX),
+          _mm256_and_ps(walk, alongX));
+        tMaxY = _mm256_blendv_ps(tMaxY, _mm256_add_ps(tMaxY, tDeltaY),
+          _mm256_andnot_ps(alongX, walk));
+        x = _mm256_add_epi32(x,
+          _mm256_and_si256(stepX, _mm256_and_si256(alongXi, walki)));
+        y = _mm256_add_epi32(y,
+          _mm256_and_si256(stepY, _mm256_andnot_si256(alongXi, walki)));
+        t = _mm256_blendv_ps(t, tNext, walk);
+
+        //!< A jump over free space for the others
+        t = _mm256_blendv_ps(t, _mm256_add_ps(t, skip), jump);
+        restart = jump;
+      }
+
+      _mm256_storeu_ps(out, result);
+      for ( int i = 0; i < lanes; i++ )
+      {
+        distances[first + i] = out[i];
+      }
+    }
+  }
+
+}  // namespace stdr_robot
@@ -0,0 +1,188 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+
+#include <stdr_robot/sensors/raycast.h>
+#include <immintrin.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief SSE4.1 kernel of castRays, 4 rays in lockstep. Lanes retire as \
+  their rays hit an obstacle, leave the map or run out of range. Built \
+  with -msse4.1 and only called after a runtime cpu check.
+  @return void
+  **/
+  void castRaysSSE4(const DistanceGrid& grid, float originX, float originY,
+    const float* dirX, const float* dirY, int count, float maxDistance,
+    float* distances)
+  {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 infinity = _mm_set1_ps(INFINITY);
+    const __m128 skipOffset = _mm_set1_ps(RAYCAST_SKIP_OFFSET);
+    const __m128 minSkip = _mm_set1_ps(RAYCAST_MIN_SKIP);
+    const __m128 ox = _mm_set1_ps(originX);
+    const __m128 oy = _mm_set1_ps(originY);
+    const __m128 maxD = _mm_set1_ps(maxDistance);
+    const __m128i zeroi = _mm_setzero_si128();
+    const __m128i onei = _mm_set1_epi32(1);
+    const __m128i tilesPerRow = _mm_set1_epi32(grid.layout.tilesPerRow);
+    const __m128i tileMask = _mm_set1_epi32(TiledLayout::TILE_SIZE - 1);
+    const __m128i lastX = _mm_set1_epi32(grid.layout.width - 1);
+    const __m128i lastY = _mm_set1_epi32(grid.layout.height - 1);
+    const __m128i laneIds = _mm_setr_epi32(0, 1, 2, 3);
+
+    for ( int first = 0; first < count; first += 4 )
+    {
+      const int lanes = count - first < 4 ? count - first : 4;
+      float bufX[4], bufY[4], out[4];
+      for ( int i = 0; i < 4; i++ )
+      {
+        bufX[i] = i < lanes ? dirX[first + i] : 1.0f;
+        bufY[i] = i < lanes ? dirY[first + i] : 0.0f;
+      }
+
+      const __m128 dx = _mm_loadu_ps(bufX);
+      const __m128 dy = _mm_loadu_ps(bufY);
+      const __m128 posX = _mm_cmpgt_ps(dx, zero);
+      const __m128 negX = _mm_cmplt_ps(dx, zero);
+      const __m128 posY = _mm_cmpgt_ps(dy, zero);
+      const __m128 negY = _mm_cmplt_ps(dy, zero);
+      const __m128i stepX = _mm_sub_epi32(
+        _mm_and_si128(_mm_castps_si128(posX), onei),
+        _mm_and_si128(_mm_castps_si128(negX), onei));
+      const __m128i stepY = _mm_sub_epi32(
+        _mm_and_si128(_mm_castps_si128(posY), onei),
+        _mm_and_si128(_mm_castps_si128(negY), onei));
+      const __m128 tDeltaX = _mm_div_ps(one, _mm_and_ps(dx, absMask));
+      const __m128 tDeltaY = _mm_div_ps(one, _mm_and_ps(dy, absMask));
+
+      __m128 active = _mm_castsi128_ps(
+        _mm_cmpgt_epi32(_mm_set1_epi32(lanes), laneIds));
+      __m128 restart = active;
+      __m128 result = infinity;
+      __m128 t = zero;
+      __m128 tMaxX = zero;
+      __m128 tMaxY = zero;
+      __m128i x = zeroi;
+      __m128i y = zeroi;
+
+      while ( _mm_movemask_ps(active) )
+      {
+        //!< Lanes that jumped, or just started, re-enter the grid
+        if ( _mm_movemask_ps(restart) )
+        {
+          const __m128 px = _mm_add_ps(ox, _mm_mul_ps(dx, t));
+          const __m128 py = _mm_add_ps(oy, _mm_mul_ps(dy, t));
+          const __m128 fx = _mm_floor_ps(px);
+          const __m128 fy = _mm_floor_ps(py);
+          const __m128 fracX = _mm_blendv_ps(
+            _mm_blendv_ps(one, _mm_sub_ps(px, fx), negX),
+            _mm_sub_ps(_mm_add_ps(fx, one), px), posX);
+          const __m128 fracY = _mm_blendv_ps(
+            _mm_blendv_ps(one, _mm_sub_ps(py, fy), negY),
+            _mm_sub_ps(_mm_add_ps(fy, one), py), posY);
+          const __m128i restarti = _mm_castps_si128(restart);
+
+          x = _mm_blendv_epi8(x, _mm_cvttps_epi32(fx), restarti);
+          y = _mm_blendv_epi8(y, _mm_cvttps_epi32(fy), restarti);
+          tMaxX = _mm_blendv_ps(tMaxX,
+            _mm_add_ps(t, _mm_mul_ps(fracX, tDeltaX)), restart);
+          tMaxY = _mm_blendv_ps(tMaxY,
+            _mm_add_ps(t, _mm_mul_ps(fracY, tDeltaY)), restart);
+        }
+
+        //!< Retire the lanes that left the map or ran out of range
+        __m128i outside = _mm_or_si128(
+          _mm_or_si128(_mm_cmpgt_epi32(zeroi, x),
+            _mm_cmpgt_epi32(zeroi, y)),
+          _mm_or_si128(_mm_cmpgt_epi32(x, lastX),
+            _mm_cmpgt_epi32(y, lastY)));
+        active = _mm_andnot_ps(
+          _mm_or_ps(_mm_castsi128_ps(outside),
+            _mm_cmpgt_ps(t, maxD)),
+          active);
+        if ( !_mm_movemask_ps(active) )
+        {
+          break;
+        }
+
+        //!< TiledLayout::index, retired lanes read the first cell
+        const __m128i tile = _mm_add_epi32(
+          _mm_mullo_epi32(
+            _mm_srai_epi32(y, TiledLayout::TILE_SHIFT), tilesPerRow),
+          _mm_srai_epi32(x, TiledLayout::TILE_SHIFT));
+        const __m128i cell = _mm_or_si128(
+          _mm_slli_epi32(_mm_and_si128(y, tileMask),
+            TiledLayout::TILE_SHIFT),
+          _mm_and_si128(x, tileMask));
+        const __m128i index = _mm_and_si128(
+          _mm_or_si128(
+            _mm_slli_epi32(tile, 2 * TiledLayout::TILE_SHIFT), cell),
+          _mm_castps_si128(active));
+        int cells[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(cells), index);
+        const __m128 clearance = _mm_setr_ps(
+          grid.distances[cells[0]], grid.distances[cells[1]],
+          grid.distances[cells[2]], grid.distances[cells[3]]);
+
+        const __m128 hit = _mm_and_ps(
+          _mm_cmpeq_ps(clearance, zero), active);
+        result = _mm_blendv_ps(result, t, hit);
+        active = _mm_andnot_ps(hit, active);
+
+        const __m128 skip = _mm_sub_ps(clearance, skipOffset);
+        const __m128 jump = _mm_and_ps(
+          _mm_cmpge_ps(skip, minSkip), active);
+        const __m128 walk = _mm_andnot_ps(jump, active);
+
+        //!< One traversal step for the lanes close to obstacles
+        const __m128 alongX = _mm_cmplt_ps(tMaxX, tMaxY);
+        const __m128i alongXi = _mm_castps_si128(alongX);
+        const __m128i walki = _mm_castps_si128(walk);
+        const __m128 tNext = _mm_blendv_ps(tMaxY, tMaxX, alongX);
+
+        tMaxX = _mm_blendv_ps(tMaxX, _mm_add_ps(tMaxX, tDeltaX),
+          _mm_and_ps(walk, alongX));
+        tMaxY = _mm_blendv_ps(tMaxY, _mm_add_ps(tMaxY, tDeltaY),
+          _mm_andnot_ps(alongX, walk));
+        x = _mm_add_epi32(x,
+          _mm_and_si128(stepX, _mm_and_si128(alongXi, walki)));
+        y = _mm_add_epi32(y,
+          _mm_and_si128(stepY, _mm_andnot_si128(alongXi, walki)));
+        t = _mm_blendv_ps(t, tNext, walk);
+
+        //!< A jump over free space for the others
+        t = _mm_blendv_ps(t, _mm_add_ps(t, skip), jump);
+        restart = jump;
+      }
+
+      _mm_storeu_ps(out, result);
+      for ( int i = 0; i < lanes; i++ )
+      {
+        distances[first + i] = out[i];
+      }
+    }
+  }
+
+}  // namespace stdr_robot
@@ -25,29 +25,28 @@ namespace stdr_robot {
   
   /**
   @brief Default constructor
-  @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+  @param map [const SharedMapConstPtr&] The shared map of the robot
+  @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
   @param msg [const stdr_msgs::SonarSensorMsg&] The sonar description message
   @param name [const std::string&] The sensor frame id without the base
   @param n [ros::NodeHandle&] The ROS node handle
   @return void
   **/ 
-  RfidReader::RfidReader(const nav_msgs::OccupancyGrid& map,
+  RfidReader::RfidReader(const SharedMapConstPtr& map,
+      const RobotPoseConstPtr& robotPose,
       const stdr_msgs::RfidSensorMsg& msg, 
       const std::string& name,
       ros::NodeHandle& n)
   : 
-    Sensor(map, name, n, msg.pose, msg.frame_id, msg.frequency)
+    Sensor(map, robotPose, name, n, msg.pose, msg.frame_id, msg.frequency)
   {
     _description = msg;
 
     _publisher = n.advertise<stdr_msgs::RfidSensorMeasurementMsg>
       ( _namespace + "/" + msg.frame_id, 1 );
       
-    rfids_subscriber_ = n.subscribe(
-      "stdr_server/rfid_list", 
-      1, 
-      &RfidReader::receiveRfids,
-      this);
+    //!< Subscribes the process to the tags, once
+    SourceStore::getInstance();
   }
   
   /**
@@ -65,58 +64,52 @@ namespace stdr_robot {
   **/ 
   void RfidReader::updateSensorCallback() 
   {
-    if (rfid_tags_.rfid_tags.size() == 0) return;    
+    RfidTagIndexConstPtr tags = SourceStore::getInstance().getRfidTags();
+    if (!tags || tags->size() == 0) return;    
 
-    stdr_msgs::RfidSensorMeasurementMsg measuredTagsMsg;
+    _measuredTagsMsg = stdr_msgs::RfidSensorMeasurementMsg();
 
-    measuredTagsMsg.header.frame_id = _description.frame_id;
+    _measuredTagsMsg.header.frame_id = _description.frame_id;
 
     
     float max_range = _description.maxRange;
     float sensor_th = tf::getYaw(_sensorTransform.getRotation());
     float min_angle = sensor_th - _description.angleSpan / 2.0;
     float max_angle = sensor_th + _description.angleSpan / 2.0;
+    float sensor_x = _sensorTransform.getOrigin().x();
+    float sensor_y = _sensorTransform.getOrigin().y();
     
-    //!< Must implement the functionality
-    for(unsigned int i = 0 ; i < rfid_tags_.rfid_tags.size() ; i++)
+    //!< Only the tags within max distance, from the cells around the sensor
+    tags->query(sensor_x, sensor_y, max_range, _foundSources);
+    for(unsigned int i = 0 ; i < _foundSources.size() ; i++)
     {
-      //!< Check for max distance
-      float sensor_x = _sensorTransform.getOrigin().x();
-      float sensor_y = _sensorTransform.getOrigin().y();
-      float dist = sqrt(
-        pow(sensor_x - rfid_tags_.rfid_tags[i].pose.x, 2) +
-        pow(sensor_y - rfid_tags_.rfid_tags[i].pose.y, 2)
-      );
-      if(dist > max_range)
-      {
-        continue;
-      }
+      const stdr_msgs::RfidTag& tag = tags->getSource(_foundSources[i]);
       
       //!< Check for correct angle
-      float ang = atan2(rfid_tags_.rfid_tags[i].pose.y - sensor_y,
-        rfid_tags_.rfid_tags[i].pose.x - sensor_x);
+      float ang = atan2(tag.pose.y - sensor_y, tag.pose.x - sensor_x);
       
       if(!stdr_robot::angCheck(ang, min_angle, max_angle))
       {
         continue;
       }
       
-      measuredTagsMsg.rfid_tags_ids.push_back(rfid_tags_.rfid_tags[i].tag_id);
-      measuredTagsMsg.rfid_tags_msgs.push_back(rfid_tags_.rfid_tags[i].message);
-      measuredTagsMsg.rfid_tags_dbs.push_back(1.0); //!< Needs to change into a realistic measurement
+      _measuredTagsMsg.rfid_tags_ids.push_back(tag.tag_id);
+      _measuredTagsMsg.rfid_tags_msgs.push_back(tag.message);
+      _measuredTagsMsg.rfid_tags_dbs.push_back(1.0); //!< Needs to change into a realistic measurement
     }
     
-    measuredTagsMsg.header.stamp = ros::Time::now();
-    measuredTagsMsg.header.frame_id = _namespace + "_" + _description.frame_id;
-    _publisher.publish( measuredTagsMsg );
+    _measuredTagsMsg.header.stamp = ros::Time::now();
+    _measuredTagsMsg.header.frame_id = _frameId;
+    _hasMeasurement = true;
   }
   
   /**
-  @brief Receives the existent rfid tags
+  @brief Publishes the measurement of the last update
+  @return void
   **/
-  void RfidReader::receiveRfids(const stdr_msgs::RfidTagVector& msg)
+  void RfidReader::publishLastMeasurement(void)
   {
-    rfid_tags_ = msg;
+    _publisher.publish( _measuredTagsMsg );
   }
 
 }  // namespace stdr_robot
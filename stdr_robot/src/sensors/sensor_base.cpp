@@ -25,16 +25,18 @@ namespace stdr_robot {
 
   /**
   @brief Default constructor
-  @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+  @param map [const SharedMapConstPtr&] The shared map of the robot
+  @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
   @param name [const std::string&] The sensor frame id without the base
-  @param n [ros::NodeHandle& n] A ROS NodeHandle to create timers
+  @param n [ros::NodeHandle& n] A ROS NodeHandle of the robot
   @param sensorPose [const geometry_msgs::Pose2D&] The sensor's pose relative to robot
   @param sensorFrameId [const std::string&] The sensor's frame id
   @param updateFrequency [float] The sensor's update frequnecy
   @return void
   **/ 
   Sensor::Sensor(
-      const nav_msgs::OccupancyGrid& map,
+      const SharedMapConstPtr& map,
+      const RobotPoseConstPtr& robotPose,
       const std::string& name,
       ros::NodeHandle& n,
       const geometry_msgs::Pose2D& sensorPose,
@@ -42,51 +44,50 @@ namespace stdr_robot {
       float updateFrequency)
       : 
         _map(map), 
+        _robotPose(robotPose),
         _namespace(name),
         _sensorPose(sensorPose),
         _sensorFrameId(sensorFrameId),
+        _frameId(name + "_" + sensorFrameId),
         _updateFrequency(updateFrequency),
-        _gotTransform(false) 
+        _robotToSensor(tf::createQuaternionFromYaw(sensorPose.theta),
+          tf::Vector3(sensorPose.x, sensorPose.y, 0)),
+        _hasMeasurement(false),
+        _noise(_frameId)
   {
-    _timer = n.createTimer(
-      ros::Duration(1/updateFrequency), &Sensor::checkAndUpdateSensor, this);
-    _tfTimer = n.createTimer(
-      ros::Duration(1/(2*updateFrequency)), &Sensor::updateTransform, this);
   }
 
   
-   /**
-  @brief Checks if transform is available and calls updateSensorCallback()
-  @param ev [const ros::TimerEvent&] A ROS timer event
+  /**
+  @brief Publishes the measurement of the last updateSensorCallback(), \
+  if there is one
   @return void
   **/
-  void Sensor::checkAndUpdateSensor(const ros::TimerEvent& ev)
+  void Sensor::publishMeasurement(void)
   {
-    if (!_gotTransform) { //!< wait for transform 
+    if (!_hasMeasurement) {
       return;
     }
     
-    updateSensorCallback();
+    _hasMeasurement = false;
+    publishLastMeasurement();
   }
   
   /**
-  @brief Updates the sensor tf transform
-  @return void
+  @brief Computes the sensor transform from the last pose of the robot
+  @return bool : False until the robot has a pose
   **/ 
-  void Sensor::updateTransform(const ros::TimerEvent&)
+  bool Sensor::updateTransform(void)
   {
-    try {
-      _tfListener.waitForTransform("map_static",
-                                  _namespace + "_" + _sensorFrameId,
-                                  ros::Time(0),
-                                  ros::Duration(0.2));
-      _tfListener.lookupTransform("map_static",
-                                  _namespace + "_" + _sensorFrameId,
-                                  ros::Time(0), _sensorTransform);
-      _gotTransform = true;
-    }
-    catch (tf::TransformException ex) {
-      ROS_DEBUG("%s",ex.what());
+    RobotPoseConstPtr robotPose = boost::atomic_load(&_robotPose);
+    if ( !robotPose )
+    {
+      return false;
     }
+
+    tf::Transform mapToRobot(tf::createQuaternionFromYaw(robotPose->theta),
+      tf::Vector3(robotPose->x, robotPose->y, 0));
+    _sensorTransform = mapToRobot * _robotToSensor;
+    return true;
   }
 }  // namespace stdr_robot
@@ -0,0 +1,205 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+
+#include <stdr_robot/sensors/sensor_scheduler.h>
+#include <algorithm>
+#include <boost/bind.hpp>
+
+namespace stdr_robot {
+
+  const double SensorScheduler::BATCH_WINDOW = 0.001;
+  const double SensorScheduler::MAX_SLEEP = 0.01;
+
+  /**
+  @brief Returns the scheduler of the process, created on first use
+  @return SensorScheduler&
+  **/
+  SensorScheduler& SensorScheduler::getInstance(void)
+  {
+    static SensorScheduler scheduler;
+    return scheduler;
+  }
+
+  /**
+  @brief Default constructor
+  @return void
+  **/
+  SensorScheduler::SensorScheduler(void)
+  {
+    int threads;
+    ros::param::param<int>("~sensor_threads", threads,
+      boost::thread::hardware_concurrency());
+    if ( threads < 0 )
+    {
+      threads = 0;
+    }
+    ROS_INFO("Sensors are updated by %d threads", threads);
+
+    _pool.reset( new WorkStealingPool(threads) );
+    if ( !ros::Time::isSimTime() )
+    {
+      _thread = boost::thread(&SensorScheduler::spin, this);
+    }
+  }
+
+  /**
+  @brief Default destructor. Stops the scheduler thread.
+  @return void
+  **/
+  SensorScheduler::~SensorScheduler(void)
+  {
+    if ( _thread.joinable() )
+    {
+      _thread.interrupt();
+      _thread.join();
+    }
+  }
+
+  /**
+  @brief Starts updating a sensor at its update frequency
+  @param sensor [const SensorPtr&] The sensor
+  @return void
+  **/
+  void SensorScheduler::addSensor(const SensorPtr& sensor)
+  {
+    if ( sensor->getUpdateFrequency() <= 0 )
+    {
+      ROS_WARN("Sensor %s has no update frequency, it will not be updated",
+        sensor->getFrameId().c_str());
+      return;
+    }
+
+    ScheduledSensor scheduled;
+    scheduled.sensor = sensor;
+    scheduled.frameId = sensor->getFrameId();
+    scheduled.period = ros::Duration(1 / sensor->getUpdateFrequency());
+    scheduled.nextUpdate = ros::Time::now() + scheduled.period;
+
+    boost::mutex::scoped_lock lock(_mutex);
+    std::vector<ScheduledSensor>::iterator it = _sensors.begin();
+    while ( it != _sensors.end() && it->frameId < scheduled.frameId )
+    {
+      it++;
+    }
+    _sensors.insert(it, scheduled);
+  }
+
+  /**
+  @brief Stops updating a sensor. Blocks while the sensor is being \
+  updated, so the sensor can be destroyed right after.
+  @param sensor [const SensorPtr&] The sensor
+  @return void
+  **/
+  void SensorScheduler::removeSensor(const SensorPtr& sensor)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    for ( unsigned int i = 0; i < _sensors.size(); i++ )
+    {
+      if ( _sensors[i].sensor == sensor )
+      {
+        _sensors.erase(_sensors.begin() + i);
+        return;
+      }
+    }
+  }
+
+  /**
+  @brief The scheduler thread loop
+  @return void
+  **/
+  void SensorScheduler::spin(void)
+  {
+    try
+    {
+      while ( ros::ok() )
+      {
+        ros::Time nextUpdate = tick( ros::Time::now() );
+
+        double sleep = std::min( MAX_SLEEP,
+          ( nextUpdate - ros::Time::now() ).toSec() );
+        if ( sleep > 0 )
+        {
+          boost::this_thread::sleep( boost::posix_time::microseconds(
+            static_cast<long>(sleep * 1e6) ) );
+        }
+        else
+        {
+          boost::this_thread::interruption_point();
+        }
+      }
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+  }
+
+  /**
+  @brief Traces the sensors that are due and publishes their measurements
+  @param now [const ros::Time&] The current time
+  @return ros::Time : The time of the next update
+  **/
+  ros::Time SensorScheduler::tick(const ros::Time& now)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+
+    const ros::Time due = now + ros::Duration(BATCH_WINDOW);
+    ros::Time nextUpdate = now + ros::Duration(MAX_SLEEP);
+
+    _dueSensors.clear();
+    _tasks.clear();
+    for ( unsigned int i = 0; i < _sensors.size(); i++ )
+    {
+      ScheduledSensor& scheduled = _sensors[i];
+      if ( scheduled.nextUpdate <= due )
+      {
+        scheduled.nextUpdate += scheduled.period;
+        //!< Do not try to catch up after a stall
+        if ( scheduled.nextUpdate <= now )
+        {
+          scheduled.nextUpdate = now + scheduled.period;
+        }
+
+        if ( scheduled.sensor->updateTransform() )
+        {
+          _dueSensors.push_back( scheduled.sensor.get() );
+          _tasks.push_back( boost::bind(
+            &Sensor::updateSensorCallback, scheduled.sensor.get()) );
+        }
+      }
+      if ( scheduled.nextUpdate < nextUpdate )
+      {
+        nextUpdate = scheduled.nextUpdate;
+      }
+    }
+
+    _pool->run(_tasks);
+
+    //!< Deterministic order, whatever thread traced each sensor
+    for ( unsigned int i = 0; i < _dueSensors.size(); i++ )
+    {
+      _dueSensors[i]->publishMeasurement();
+    }
+
+    return nextUpdate;
+  }
+
+}  // namespace stdr_robot
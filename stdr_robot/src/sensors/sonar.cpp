@@ -25,21 +25,34 @@ namespace stdr_robot {
 
   /**
   @brief Default constructor
-  @param map [const nav_msgs::OccupancyGrid&] An occupancy grid map
+  @param map [const SharedMapConstPtr&] The shared map of the robot
+  @param robotPose [const RobotPoseConstPtr&] The pose snapshot of the robot
   @param msg [const stdr_msgs::SonarSensorMsg&] The sonar description message
   @param name [const std::string&] The sensor frame id without the base
   @param n [ros::NodeHandle&] The ROS node handle
   @return void
   **/ 
-  Sonar::Sonar(const nav_msgs::OccupancyGrid& map,
+  Sonar::Sonar(const SharedMapConstPtr& map,
+      const RobotPoseConstPtr& robotPose,
       const stdr_msgs::SonarSensorMsg& msg, 
       const std::string& name,
       ros::NodeHandle& n)
   : 
-    Sensor(map, name, n, msg.pose, msg.frame_id, msg.frequency)
+    Sensor(map, robotPose, name, n, msg.pose, msg.frame_id, msg.frequency),
+    _rangeNoise(msg.noise, msg.maxRange)
   {
     _description = msg;
 
+    float angleStep = 3.14159 / 180.0;
+    float angleMin = - ( _description.coneAngle / 2.0 );
+    float angleMax = _description.coneAngle / 2.0;
+    for ( float sonarIter = angleMin; sonarIter < angleMax;
+      sonarIter += angleStep )
+    {
+      _beams.addBeam(sonarIter);
+    }
+    _rayDistances.resize( _beams.size() );
+
     _publisher = n.advertise<sensor_msgs::Range>
       ( _namespace + "/" + msg.frame_id, 1 );
   }
@@ -59,79 +72,68 @@ namespace stdr_robot {
   **/ 
   void Sonar::updateSensorCallback() 
   {
-    float angle;
-    int distance;
-    int xMap, yMap;
-    sensor_msgs::Range sonarRangeMsg;
+    float range;
+    _sonarRangeMsg = sensor_msgs::Range();
 
-    sonarRangeMsg.max_range = _description.maxRange;
-    sonarRangeMsg.min_range = _description.minRange;
-    sonarRangeMsg.radiation_type = 0;
-    sonarRangeMsg.field_of_view = _description.coneAngle;
+    _sonarRangeMsg.max_range = _description.maxRange;
+    _sonarRangeMsg.min_range = _description.minRange;
+    _sonarRangeMsg.radiation_type = 0;
+    _sonarRangeMsg.field_of_view = _description.coneAngle;
 
-    if ( _map.info.height == 0 || _map.info.width == 0 )
+    SharedMapConstPtr map = getMap();
+    if ( !map || map->getGrid().info.height == 0 || 
+      map->getGrid().info.width == 0 )
     {
       ROS_DEBUG("Outside limits\n");
       return;
     }
+    const float resolution = map->getGrid().info.resolution;
 
-    sonarRangeMsg.range = _description.maxRange;
+    _sonarRangeMsg.range = _description.maxRange;
 
-    float angleStep = 3.14159 / 180.0;
-    float angleMin = - ( _description.coneAngle / 2.0 ); 
-    float angleMax = _description.coneAngle / 2.0 ; 
-    ////float angleStep = _description.coneAngle * 180.0 / 3.14159;
-    //float angleMin = -( _description.coneAngle * 180.0 / 3.14159 / 2.0 ); 
-    //float angleMax = _description.coneAngle * 180.0 / 3.14159 / 2.0 ; 
+    _beams.rotate(_sensorTransform);
 
-    for ( float sonarIter = angleMin; sonarIter < angleMax; 
-      sonarIter += angleStep )
+    if ( _beams.size() > 0 )
     {
+      map->getRayCaster().traceBatch(
+        _sensorTransform.getOrigin().x() / resolution,
+        _sensorTransform.getOrigin().y() / resolution,
+        _beams.getCosines(), _beams.getSines(), _beams.size(),
+        _description.maxRange / resolution, &_rayDistances[0]);
+    }
 
-      distance = 1;
-
-      while ( distance <= _description.maxRange / _map.info.resolution )
-      {
-        xMap = _sensorTransform.getOrigin().x() / _map.info.resolution + 
-          cos( sonarIter + tf::getYaw(_sensorTransform.getRotation()) ) 
-            * distance;
-        yMap = _sensorTransform.getOrigin().y() / _map.info.resolution + 
-          sin( sonarIter + tf::getYaw(_sensorTransform.getRotation()) ) 
-            * distance;
-        
-        if (yMap * _map.info.width + xMap > _map.info.height*_map.info.width ||
-            yMap * _map.info.width + xMap < 0)
-        {
-          distance = _description.maxRange / _map.info.resolution - 1;
-          break;
-        }
-        
-        //!< Found obstacle
-        if ( _map.data[ yMap * _map.info.width + xMap ] > 70 )
-        {
-          break;
-        }
-        distance ++;
-      }
+    for ( int sonarIter = 0; sonarIter < _beams.size(); sonarIter++ )
+    {
+      range = resolution * _rayDistances[sonarIter];
 
-      if ( distance * _map.info.resolution < sonarRangeMsg.range )
+      if ( range < _sonarRangeMsg.range )
       {
-        sonarRangeMsg.range = distance * _map.info.resolution;
+        _sonarRangeMsg.range = range;
       }
     }
+    _rangeNoise.apply(_noise, &_sonarRangeMsg.range, 1);
     
-    if ( sonarRangeMsg.range < _description.minRange )
+    if ( _sonarRangeMsg.range < _description.minRange )
     {
-      sonarRangeMsg.range = -std::numeric_limits<float>::infinity();
+      _sonarRangeMsg.range = -std::numeric_limits<float>::infinity();
     }
-    else if ( sonarRangeMsg.range >= _description.maxRange )
+    else if ( _sonarRangeMsg.range >= _description.maxRange )
     {
-      sonarRangeMsg.range = std::numeric_limits<float>::infinity();
+      _sonarRangeMsg.range = std::numeric_limits<float>::infinity();
     }
 
-    sonarRangeMsg.header.stamp = ros::Time::now();
-    sonarRangeMsg.header.frame_id = _namespace + "_" + _description.frame_id;
-    _publisher.publish( sonarRangeMsg );
+    _sonarRangeMsg.header.stamp = ros::Time::now();
+    _sonarRangeMsg.header.frame_id = _frameId;
+    _hasMeasurement = true;
+  }
+
+  /**
+  @brief Publishes the measurement of the last update
+  @return void
+  **/
+  void Sonar::publishLastMeasurement(void)
+  {
+    _publisher.publish( _sonarRangeMsg );
   }
 
 }  // namespace stdr_robot
@@ -0,0 +1,161 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/sensors/source_store.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief Returns the source store of the process, created on first use
+  @return SourceStore&
+  **/
+  SourceStore& SourceStore::getInstance(void)
+  {
+    static SourceStore store;
+    return store;
+  }
+
+  /**
+  @brief Default constructor
+  @return void
+  **/
+  SourceStore::SourceStore(void)
+  {
+    double rebuildPeriod;
+    ros::param::param<double>("~source_cell_size", _cellSize, 2.0);
+    if ( !( _cellSize > 0 ) )
+    {
+      ROS_WARN("~source_cell_size must be positive, using 2.0");
+      _cellSize = 2.0;
+    }
+    ros::param::param<double>("~source_rebuild_period", rebuildPeriod, 0.1);
+
+    _rfidTagsSubscriber = _nodeHandle.subscribe("stdr_server/rfid_delta",
+      SOURCE_DELTA_QUEUE, &SourceStore::receiveRfidTags, this);
+    _co2SourcesSubscriber = _nodeHandle.subscribe(
+      "stdr_server/co2_sources_delta", SOURCE_DELTA_QUEUE,
+      &SourceStore::receiveCO2Sources, this);
+    _thermalSourcesSubscriber = _nodeHandle.subscribe(
+      "stdr_server/thermal_sources_delta", SOURCE_DELTA_QUEUE,
+      &SourceStore::receiveThermalSources, this);
+    _soundSourcesSubscriber = _nodeHandle.subscribe(
+      "stdr_server/sound_sources_delta", SOURCE_DELTA_QUEUE,
+      &SourceStore::receiveSoundSources, this);
+
+    _rebuildTimer = _nodeHandle.createTimer(ros::Duration(rebuildPeriod),
+      &SourceStore::rebuildIndexes, this);
+  }
+
+  /**
+  @brief Applies a change of the rfid tags
+  @param msg [const stdr_msgs::RfidTagDeltaConstPtr&] The change
+  @return void
+  **/
+  void SourceStore::receiveRfidTags(
+    const stdr_msgs::RfidTagDeltaConstPtr& msg)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (!_rfidTags.apply(*msg))
+    {
+      //!< Changes were dropped, connect again to get a snapshot
+      ROS_WARN("Lost rfid tag changes, requesting a snapshot");
+      _rfidTagsSubscriber.shutdown();
+      _rfidTagsSubscriber = _nodeHandle.subscribe(
+        "stdr_server/rfid_delta", SOURCE_DELTA_QUEUE,
+        &SourceStore::receiveRfidTags, this);
+    }
+  }
+
+  /**
+  @brief Applies a change of the co2 sources
+  @param msg [const stdr_msgs::CO2SourceDeltaConstPtr&] The change
+  @return void
+  **/
+  void SourceStore::receiveCO2Sources(
+    const stdr_msgs::CO2SourceDeltaConstPtr& msg)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (!_co2Sources.apply(*msg))
+    {
+      //!< Changes were dropped, connect again to get a snapshot
+      ROS_WARN("Lost co2 source changes, requesting a snapshot");
+      _co2SourcesSubscriber.shutdown();
+      _co2SourcesSubscriber = _nodeHandle.subscribe(
+        "stdr_server/co2_sources_delta", SOURCE_DELTA_QUEUE,
+        &SourceStore::receiveCO2Sources, this);
+    }
+  }
+
+  /**
+  @brief Applies a change of the thermal sources
+  @param msg [const stdr_msgs::ThermalSourceDeltaConstPtr&] The change
+  @return void
+  **/
+  void SourceStore::receiveThermalSources(
+    const stdr_msgs::ThermalSourceDeltaConstPtr& msg)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (!_thermalSources.apply(*msg))
+    {
+      //!< Changes were dropped, connect again to get a snapshot
+      ROS_WARN("Lost thermal source changes, requesting a snapshot");
+      _thermalSourcesSubscriber.shutdown();
+      _thermalSourcesSubscriber = _nodeHandle.subscribe(
+        "stdr_server/thermal_sources_delta", SOURCE_DELTA_QUEUE,
+        &SourceStore::receiveThermalSources, this);
+    }
+  }
+
+  /**
+  @brief Applies a change of the sound sources
+  @param msg [const stdr_msgs::SoundSourceDeltaConstPtr&] The change
+  @return void
+  **/
+  void SourceStore::receiveSoundSources(
+    const stdr_msgs::SoundSourceDeltaConstPtr& msg)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    if (!_soundSources.apply(*msg))
+    {
+      //!< Changes were dropped, connect again to get a snapshot
+      ROS_WARN("Lost sound source changes, requesting a snapshot");
+      _soundSourcesSubscriber.shutdown();
+      _soundSourcesSubscriber = _nodeHandle.subscribe(
+        "stdr_server/sound_sources_delta", SOURCE_DELTA_QUEUE,
+        &SourceStore::receiveSoundSources, this);
+    }
+  }
+
+  /**
+  @brief Rebuilds the indexes of the changed lists
+  @param event [const ros::TimerEvent&] The timer event
+  @return void
+  **/
+  void SourceStore::rebuildIndexes(const ros::TimerEvent& event)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    _rfidTags.rebuild(_cellSize);
+    _co2Sources.rebuild(_cellSize);
+    _thermalSources.rebuild(_cellSize);
+    _soundSources.rebuild(_cellSize);
+  }
+
+}  // namespace stdr_robot
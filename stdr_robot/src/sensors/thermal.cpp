@@ -27,22 +27,20 @@ namespace stdr_robot {
   @brief Default constructor
   **/ 
   ThermalSensor::ThermalSensor(
-    const nav_msgs::OccupancyGrid& map,
+    const SharedMapConstPtr& map,
+    const RobotPoseConstPtr& robotPose,
     const stdr_msgs::ThermalSensorMsg& msg, 
     const std::string& name,
     ros::NodeHandle& n)
-    : Sensor(map, name, n, msg.pose, msg.frame_id, msg.frequency)
+    : Sensor(map, robotPose, name, n, msg.pose, msg.frame_id, msg.frequency)
   {
     _description = msg;
 
     _publisher = n.advertise<stdr_msgs::ThermalSensorMeasurementMsg>
       ( _namespace + "/" + msg.frame_id, 1 );
       
-    thermal_sources_subscriber_ = n.subscribe(
-      "stdr_server/thermal_sources_list", 
-      1, 
-      &ThermalSensor::receiveThermalSources,
-      this);
+    //!< Subscribes the process to the sources, once
+    SourceStore::getInstance();
   }
   
   /**
@@ -60,38 +58,32 @@ namespace stdr_robot {
   **/ 
   void ThermalSensor::updateSensorCallback() 
   {
-    if (thermal_sources_.thermal_sources.size() == 0) return;    
+    ThermalSourceIndexConstPtr sources =
+      SourceStore::getInstance().getThermalSources();
+    if (!sources || sources->size() == 0) return;    
 
-    stdr_msgs::ThermalSensorMeasurementMsg measuredSourcesMsg;
+    _measuredSourcesMsg = stdr_msgs::ThermalSensorMeasurementMsg();
 
-    measuredSourcesMsg.header.frame_id = _description.frame_id;
+    _measuredSourcesMsg.header.frame_id = _description.frame_id;
 
     
     float max_range = _description.maxRange;
     float sensor_th = tf::getYaw(_sensorTransform.getRotation());
     float min_angle = sensor_th - _description.angleSpan / 2.0;
     float max_angle = sensor_th + _description.angleSpan / 2.0;
+    float sensor_x = _sensorTransform.getOrigin().x();
+    float sensor_y = _sensorTransform.getOrigin().y();
     
-    measuredSourcesMsg.thermal_source_degrees.push_back(0);
-    //!< Must implement the functionality
-    for(unsigned int i = 0 ; i < thermal_sources_.thermal_sources.size() ; i++)
+    _measuredSourcesMsg.thermal_source_degrees.push_back(0);
+    //!< Only the sources within max distance, from the cells around the sensor
+    sources->query(sensor_x, sensor_y, max_range, _foundSources);
+    for(unsigned int i = 0 ; i < _foundSources.size() ; i++)
     {
-      //!< Check for max distance
-      float sensor_x = _sensorTransform.getOrigin().x();
-      float sensor_y = _sensorTransform.getOrigin().y();
-      float dist = sqrt(
-        pow(sensor_x - thermal_sources_.thermal_sources[i].pose.x, 2) +
-        pow(sensor_y - thermal_sources_.thermal_sources[i].pose.y, 2)
-      );
-      if(dist > max_range)
-      {
-        continue;
-      }
+      const stdr_msgs::ThermalSource& source =
+        sources->getSource(_foundSources[i]);
       
       //!< Check for correct angle
-      float ang = atan2( 
-        thermal_sources_.thermal_sources[i].pose.y - sensor_y,
-        thermal_sources_.thermal_sources[i].pose.x - sensor_x);
+      float ang = atan2(source.pose.y - sensor_y, source.pose.x - sensor_x);
       
       if(!stdr_robot::angCheck(ang, min_angle, max_angle))
       {
@@ -99,26 +91,24 @@ namespace stdr_robot {
       }
       
       // Returns the larger temperature found in its range
-      if( thermal_sources_.thermal_sources[i].degrees >
-        measuredSourcesMsg.thermal_source_degrees[0])
+      if( source.degrees > _measuredSourcesMsg.thermal_source_degrees[0])
       {
-        measuredSourcesMsg.thermal_source_degrees[0] = 
-          thermal_sources_.thermal_sources[i].degrees;
+        _measuredSourcesMsg.thermal_source_degrees[0] = source.degrees;
       }
     }
     
-    measuredSourcesMsg.header.stamp = ros::Time::now();
-    measuredSourcesMsg.header.frame_id = _namespace + "_" + _description.frame_id;
-    _publisher.publish( measuredSourcesMsg );
+    _measuredSourcesMsg.header.stamp = ros::Time::now();
+    _measuredSourcesMsg.header.frame_id = _frameId;
+    _hasMeasurement = true;
   }
   
   /**
-  @brief Receives the existent sources
+  @brief Publishes the measurement of the last update
+  @return void
   **/
-  void ThermalSensor::receiveThermalSources(
-    const stdr_msgs::ThermalSourceVector& msg)
+  void ThermalSensor::publishLastMeasurement(void)
   {
-    thermal_sources_ = msg;
+    _publisher.publish( _measuredSourcesMsg );
   }
 
 }  // namespace stdr_robot
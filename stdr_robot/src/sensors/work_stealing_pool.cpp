@@ -0,0 +1,185 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+
+#include <stdr_robot/sensors/work_stealing_pool.h>
+#include <boost/bind.hpp>
+
+namespace stdr_robot {
+
+  /**
+  @brief Default constructor
+  @param threads [unsigned int] The number of worker threads. With zero \
+  threads the tasks run on the calling thread.
+  @return void
+  **/
+  WorkStealingPool::WorkStealingPool(unsigned int threads)
+    :
+      _pending(0),
+      _generation(0),
+      _stop(false)
+  {
+    for ( unsigned int i = 0; i < threads; i++ )
+    {
+      _queues.push_back( boost::shared_ptr<TaskQueue>(new TaskQueue) );
+    }
+    for ( unsigned int i = 0; i < threads; i++ )
+    {
+      _threads.create_thread(
+        boost::bind(&WorkStealingPool::workerLoop, this, i) );
+    }
+  }
+
+  /**
+  @brief Default destructor. Joins the worker threads.
+  @return void
+  **/
+  WorkStealingPool::~WorkStealingPool(void)
+  {
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      _stop = true;
+    }
+    _batchStarted.notify_all();
+    _threads.join_all();
+  }
+
+  /**
+  @brief Runs a batch of tasks and blocks until all of them finish
+  @param tasks [const std::vector<Task>&] The tasks
+  @return void
+  **/
+  void WorkStealingPool::run(const std::vector<Task>& tasks)
+  {
+    if ( tasks.empty() )
+    {
+      return;
+    }
+
+    if ( _queues.empty() )
+    {
+      for ( size_t i = 0; i < tasks.size(); i++ )
+      {
+        tasks[i]();
+      }
+      return;
+    }
+
+    boost::mutex::scoped_lock lock(_mutex);
+    _pending = tasks.size();
+
+    //!< Contiguous chunks keep the tasks of a robot on the same worker
+    const size_t chunk = ( tasks.size() + _queues.size() - 1 ) / _queues.size();
+    for ( size_t i = 0; i < tasks.size(); i++ )
+    {
+      TaskQueue& queue = *_queues[ i / chunk ];
+      boost::mutex::scoped_lock queueLock(queue.mutex);
+      queue.tasks.push_back( TaskRef(&tasks, i) );
+    }
+
+    _generation++;
+    _batchStarted.notify_all();
+
+    while ( _pending > 0 )
+    {
+      _batchFinished.wait(lock);
+    }
+  }
+
+  /**
+  @brief Pops a task from the front of the worker's own queue, or \
+  steals one from the back of another queue
+  @param worker [unsigned int] The worker index
+  @param task [TaskRef&] The task found
+  @return bool : False when every queue is empty
+  **/
+  bool WorkStealingPool::nextTask(unsigned int worker, TaskRef& task)
+  {
+    {
+      TaskQueue& own = *_queues[worker];
+      boost::mutex::scoped_lock lock(own.mutex);
+      if ( !own.tasks.empty() )
+      {
+        task = own.tasks.front();
+        own.tasks.pop_front();
+        return true;
+      }
+    }
+
+    for ( unsigned int i = 1; i < _queues.size(); i++ )
+    {
+      TaskQueue& victim = *_queues[ ( worker + i ) % _queues.size() ];
+      boost::mutex::scoped_lock lock(victim.mutex);
+      if ( !victim.tasks.empty() )
+      {
+        task = victim.tasks.back();
+        victim.tasks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+  @brief The worker thread loop
+  @param worker [unsigned int] The worker index
+  @return void
+  **/
+  void WorkStealingPool::workerLoop(unsigned int worker)
+  {
+    unsigned long generation = 0;
+
+    while ( true )
+    {
+      {
+        boost::mutex::scoped_lock lock(_mutex);
+        while ( !_stop && generation == _generation )
+        {
+          _batchStarted.wait(lock);
+        }
+        if ( _stop )
+        {
+          return;
+        }
+        generation = _generation;
+      }
+
+      TaskRef task;
+      size_t done = 0;
+      while ( nextTask(worker, task) )
+      {
+        ( *task.first )[task.second]();
+        done++;
+      }
+
+      if ( done > 0 )
+      {
+        boost::mutex::scoped_lock lock(_mutex);
+        _pending -= done;
+        if ( _pending == 0 )
+        {
+          _batchFinished.notify_all();
+        }
+      }
+    }
+  }
+
+}  // namespace stdr_robot
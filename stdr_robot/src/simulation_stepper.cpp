@@ -0,0 +1,153 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/simulation_stepper.h>
+#include <stdr_robot/stdr_robot.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief Returns the stepper of the process, created on first use
+  @return SimulationStepper&
+  **/
+  SimulationStepper& SimulationStepper::getInstance(void)
+  {
+    static SimulationStepper stepper;
+    return stepper;
+  }
+
+  /**
+  @brief Default constructor
+  @return void
+  **/
+  SimulationStepper::SimulationStepper(void)
+  {
+    ros::NodeHandle n;
+    n.setCallbackQueue(&_queue);
+
+    _stepDonePublisher = n.advertise<rosgraph_msgs::Clock>(
+      "stdr_server/step_done", 100);
+    _clockSubscriber = n.subscribe(
+      "/clock", 100, &SimulationStepper::clockCallback, this,
+      ros::TransportHints().tcpNoDelay());
+
+    _thread = boost::thread(&SimulationStepper::spin, this);
+  }
+
+  /**
+  @brief Default destructor. Stops the stepper thread.
+  @return void
+  **/
+  SimulationStepper::~SimulationStepper(void)
+  {
+    _thread.interrupt();
+    _thread.join();
+  }
+
+  /**
+  @brief Starts stepping a robot
+  @param name [const std::string&] The robot name, defines the step order
+  @param robot [Robot*] The robot
+  @return void
+  **/
+  void SimulationStepper::addRobot(const std::string& name, Robot* robot)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    std::vector<std::pair<std::string, Robot*> >::iterator it =
+      _robots.begin();
+    while ( it != _robots.end() && it->first < name )
+    {
+      it++;
+    }
+    _robots.insert(it, std::make_pair(name, robot));
+  }
+
+  /**
+  @brief Stops stepping a robot. Blocks while a step is in progress, \
+  so the robot can be destroyed right after.
+  @param robot [Robot*] The robot
+  @return void
+  **/
+  void SimulationStepper::removeRobot(Robot* robot)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    for ( unsigned int i = 0; i < _robots.size(); i++ )
+    {
+      if ( _robots[i].second == robot )
+      {
+        _robots.erase(_robots.begin() + i);
+        return;
+      }
+    }
+  }
+
+  /**
+  @brief The stepper thread loop
+  @return void
+  **/
+  void SimulationStepper::spin(void)
+  {
+    try
+    {
+      while ( ros::ok() )
+      {
+        _queue.callAvailable( ros::WallDuration(0.01) );
+        boost::this_thread::interruption_point();
+      }
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+  }
+
+  /**
+  @brief Callback of the /clock ticks, steps the simulation
+  @param msg [const rosgraph_msgs::ClockConstPtr&] The tick
+  @return void
+  **/
+  void SimulationStepper::clockCallback(
+    const rosgraph_msgs::ClockConstPtr& msg)
+  {
+    const ros::Time& now = msg->clock;
+    ros::Duration dt(0);
+    if ( !_lastTime.isZero() && now > _lastTime )
+    {
+      dt = now - _lastTime;
+    }
+    _lastTime = now;
+
+    {
+      boost::mutex::scoped_lock lock(_mutex);
+      _fleet.integrate(dt.toSec());
+      for ( unsigned int i = 0; i < _robots.size(); i++ )
+      {
+        _robots[i].second->step(now);
+      }
+    }
+
+    //!< Sensors see the poses of this tick
+    SensorScheduler::getInstance().tick(now);
+    TransformPublisher::getInstance().tick(now);
+
+    _stepDonePublisher.publish(*msg);
+  }
+
+}  // namespace stdr_robot
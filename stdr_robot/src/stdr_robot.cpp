@@ -22,6 +22,7 @@
 #include <stdr_robot/stdr_robot.h>
 #include <nodelet/NodeletUnload.h>
 #include <pluginlib/class_list_macros.h>
+#include <algorithm>
 
 PLUGINLIB_EXPORT_CLASS(stdr_robot::Robot, nodelet::Nodelet)
 
@@ -32,10 +33,36 @@ namespace stdr_robot
   @return void
   **/
   Robot::Robot(void)
+    : _fleet(NULL)
+    , _pooled(false)
   {
 
   }
 
+  /**
+  @brief Creates a robot of a RobotPool, without the nodelet load and \
+  register handshake. The pool steps the robot and gives it the map.
+  @param name [const std::string&] The robot frame_id
+  @param description [const stdr_msgs::RobotMsg&] The robot description
+  @param map [const SharedMapConstPtr&] The current map, null if none
+  @param fleet [FleetState&] The fleet of the pool. In lockstep the \
+  robot joins the fleet of the SimulationStepper instead.
+  @param n [ros::NodeHandle&] The node handle of the pool
+  @return void
+  **/
+  Robot::Robot(const std::string& name,
+    const stdr_msgs::RobotMsg& description,
+    const SharedMapConstPtr& map, FleetState& fleet, ros::NodeHandle& n)
+    : _name(name)
+    , _map(map)
+    , _fleet(&fleet)
+    , _pooled(true)
+  {
+    ros::NodeHandle pn(n, name);
+    advertise(n, pn);
+    loadDescription(description, n);
+  }
+
   /**
   @brief Initializes the robot and gets the environment occupancy grid map
   @return void
@@ -43,8 +70,11 @@ namespace stdr_robot
   void Robot::onInit()
   {
     ros::NodeHandle n = getMTNodeHandle();
+    ros::NodeHandle pn = getPrivateNodeHandle();
+    _name = getName();
 
-    _odomPublisher = n.advertise<nav_msgs::Odometry>(getName() + "/odom", 10);
+    advertise(n, pn);
+    _mapSubscriber = n.subscribe("map", 1, &Robot::mapCallback, this);
 
     _registerClientPtr.reset(
       new RegisterRobotClient(n, "stdr_server/register_robot", true) );
@@ -52,17 +82,9 @@ namespace stdr_robot
     _registerClientPtr->waitForServer();
 
     stdr_msgs::RegisterRobotGoal goal;
-    goal.name = getName();
+    goal.name = _name;
     _registerClientPtr->sendGoal(goal,
       boost::bind(&Robot::initializeRobot, this, _1, _2));
-
-    _mapSubscriber = n.subscribe("map", 1, &Robot::mapCallback, this);
-    _moveRobotService = n.advertiseService(
-      getName() + "/replace", &Robot::moveRobotCallback, this);
-
-    //we should not start the timer, until we hame a motion controller
-    _tfTimer = n.createTimer(
-      ros::Duration(0.1), &Robot::publishTransforms, this, false, false);
   }
 
   /**
@@ -81,98 +103,179 @@ namespace stdr_robot
       return;
     }
 
-    NODELET_INFO("Loaded new robot, %s", getName().c_str());
+    NODELET_INFO("Loaded new robot, %s", _name.c_str());
     ros::NodeHandle n = getMTNodeHandle();
+    loadDescription(result->description, n);
+  }
+
+  /**
+  @brief Advertises the robot topics and services and reads its rates
+  @param n [ros::NodeHandle&] The node handle of the robot topics
+  @param pn [ros::NodeHandle&] The node handle of the robot parameters
+  @return void
+  **/
+  void Robot::advertise(ros::NodeHandle& n, ros::NodeHandle& pn)
+  {
+    _odomPublisher = n.advertise<nav_msgs::Odometry>(_name + "/odom", 10);
+
+    _moveRobotService = n.advertiseService(
+      _name + "/replace", &Robot::moveRobotCallback, this);
 
-    _currentPose = result->description.initialPose;
+    ros::param::param<bool>("~collision_slide", _slideOnCollision, false);
+
+    //!< The manager sets the rates of all its robots, a robot may
+    //!< override them in its own namespace
+    double collisionRate, publishRate;
+    ros::param::param<double>("~collision_rate", collisionRate, 10.0);
+    ros::param::param<double>("~publish_rate", publishRate, 10.0);
+    pn.param<double>("collision_rate", collisionRate, collisionRate);
+    pn.param<double>("publish_rate", publishRate, publishRate);
+    _publishPeriod = ros::Duration(1.0 / std::max(publishRate, 0.1));
+
+    //!< A pool steps its robots in one loop
+    if ( !_pooled )
+    {
+      //we should not start the timer, until we hame a motion controller
+      _updateTimer = n.createTimer(
+        ros::Duration(1.0 / std::max(collisionRate, 1.0)),
+        &Robot::updateCallback, this, false, false);
+    }
+  }
+
+  /**
+  @brief Creates the sensors and motion controller of the description \
+  and starts stepping the robot
+  @param description [const stdr_msgs::RobotMsg&] The robot description
+  @param n [ros::NodeHandle&] The node handle of the robot topics
+  @return void
+  **/
+  void Robot::loadDescription(const stdr_msgs::RobotMsg& description,
+    ros::NodeHandle& n)
+  {
+    _currentPose = description.initialPose;
 
     _previousPose = _currentPose;
+    boost::atomic_store(&_robotPose,
+      RobotPoseConstPtr(new geometry_msgs::Pose2D(_previousPose)));
 
     for ( unsigned int laserIter = 0;
-      laserIter < result->description.laserSensors.size(); laserIter++ )
+      laserIter < description.laserSensors.size(); laserIter++ )
     {
       _sensors.push_back( SensorPtr(
-        new Laser( _map,
-          result->description.laserSensors[laserIter], getName(), n ) ) );
+        new Laser( _map, _robotPose,
+          description.laserSensors[laserIter], _name, n ) ) );
     }
     for ( unsigned int sonarIter = 0;
-      sonarIter < result->description.sonarSensors.size(); sonarIter++ )
+      sonarIter < description.sonarSensors.size(); sonarIter++ )
     {
       _sensors.push_back( SensorPtr(
-        new Sonar( _map,
-          result->description.sonarSensors[sonarIter], getName(), n ) ) );
+        new Sonar( _map, _robotPose,
+          description.sonarSensors[sonarIter], _name, n ) ) );
     }
     for ( unsigned int rfidReaderIter = 0;
-      rfidReaderIter < result->description.rfidSensors.size(); 
+      rfidReaderIter < description.rfidSensors.size(); 
         rfidReaderIter++ )
     {
       _sensors.push_back( SensorPtr(
-        new RfidReader( _map,
-          result->description.rfidSensors[rfidReaderIter], getName(), n ) ) );
+        new RfidReader( _map, _robotPose,
+          description.rfidSensors[rfidReaderIter], _name, n ) ) );
     }
     for ( unsigned int co2SensorIter = 0;
-      co2SensorIter < result->description.co2Sensors.size(); 
+      co2SensorIter < description.co2Sensors.size(); 
         co2SensorIter++ )
     {
       _sensors.push_back( SensorPtr(
-        new CO2Sensor( _map,
-          result->description.co2Sensors[co2SensorIter], getName(), n ) ) );
+        new CO2Sensor( _map, _robotPose,
+          description.co2Sensors[co2SensorIter], _name, n ) ) );
     }
     for ( unsigned int thermalSensorIter = 0;
-      thermalSensorIter < result->description.thermalSensors.size(); 
+      thermalSensorIter < description.thermalSensors.size(); 
         thermalSensorIter++ )
     {
       _sensors.push_back( SensorPtr(
-        new ThermalSensor( _map,
-          result->description.thermalSensors[thermalSensorIter], getName(), n ) ) );
+        new ThermalSensor( _map, _robotPose,
+          description.thermalSensors[thermalSensorIter], _name, n ) ) );
     }
     for ( unsigned int soundSensorIter = 0;
-      soundSensorIter < result->description.soundSensors.size(); 
+      soundSensorIter < description.soundSensors.size(); 
         soundSensorIter++ )
     {
       _sensors.push_back( SensorPtr(
-        new SoundSensor( _map,
-          result->description.soundSensors[soundSensorIter], getName(), n ) ) );
+        new SoundSensor( _map, _robotPose,
+          description.soundSensors[soundSensorIter], _name, n ) ) );
     }
 
-    if( result->description.footprint.points.size() == 0 ) {
-      float radius = result->description.footprint.radius;
-      for(unsigned int i = 0 ; i < 360 ; i++)
-      {
-        float x = cos(i * 3.14159265359 / 180.0) * radius;
-        float y = sin(i * 3.14159265359 / 180.0) * radius;
-        _footprint.push_back( std::pair<float,float>(x,y));
-      }
-    } else {
-      for( unsigned int i = 0 ;
-          i < result->description.footprint.points.size() ; 
-          i++ ) {
-        geometry_msgs::Point p = result->description.footprint.points[i];
-        _footprint.push_back( std::pair<float,float>(p.x, p.y));
-      }
+    for ( unsigned int i = 0; i < _sensors.size(); i++ )
+    {
+      SensorScheduler::getInstance().addSensor(_sensors[i]);
+    }
+
+    //!< The sensors are fixed on the robot, their tf is sent once
+    std::vector<geometry_msgs::TransformStamped> sensorTransforms(
+      _sensors.size() );
+    for ( unsigned int i = 0; i < _sensors.size(); i++ )
+    {
+      geometry_msgs::Pose2D sensorPose = _sensors[i]->getSensorPose();
+      geometry_msgs::TransformStamped& transform = sensorTransforms[i];
+      transform.header.stamp = ros::Time::now();
+      transform.header.frame_id = _name;
+      transform.child_frame_id = _sensors[i]->getFrameId();
+      transform.transform.translation.x = sensorPose.x;
+      transform.transform.translation.y = sensorPose.y;
+      transform.transform.translation.z = 0;
+      transform.transform.rotation =
+        tf::createQuaternionMsgFromYaw(sensorPose.theta);
     }
+    TransformPublisher::getInstance().addRobot(
+      _name, _robotPose, sensorTransforms);
 
-    std::string motion_model = result->description.kinematicModel.type;
-    stdr_msgs::KinematicMsg p = result->description.kinematicModel;
+    _collisionChecker.reset(
+      new CollisionChecker(description.footprint) );
+
+    //!< In lockstep all robots of the process move in one fleet, a robot
+    //!< on its own timer moves alone
+    if ( ros::Time::isSimTime() )
+    {
+      _fleet = &SimulationStepper::getInstance().getFleet();
+    }
+    else if ( !_pooled )
+    {
+      _ownFleet.reset( new FleetState );
+      _fleet = _ownFleet.get();
+    }
+
+    std::string motion_model = description.kinematicModel.type;
+    stdr_msgs::KinematicMsg p = description.kinematicModel;
 
     if(motion_model == "ideal")
     {
       _motionControllerPtr.reset(
-        new IdealMotionController(_currentPose, _tfBroadcaster, n, getName(), p));
+        new IdealMotionController(_currentPose, *_fleet, n,
+          _name, p));
     }
     else if(motion_model == "omni")
     {
       _motionControllerPtr.reset(
-        new OmniMotionController(_currentPose, _tfBroadcaster, n, getName(), p));
+        new OmniMotionController(_currentPose, *_fleet, n,
+          _name, p));
     }
     else
     {
       // If no motion model is specified or an invalid type declared use ideal
       _motionControllerPtr.reset(
-        new IdealMotionController(_currentPose, _tfBroadcaster, n, getName(), p));
+        new IdealMotionController(_currentPose, *_fleet, n,
+          _name, p));
     }
 
-    _tfTimer.start();
+    if ( ros::Time::isSimTime() )
+    {
+      SimulationStepper::getInstance().addRobot(_name, this);
+    }
+    else if ( !_pooled )
+    {
+      _lastUpdate = ros::Time::now();
+      _updateTimer.start();
+    }
   }
 
   /**
@@ -182,7 +285,17 @@ namespace stdr_robot
   **/
   void Robot::mapCallback(const nav_msgs::OccupancyGridConstPtr& msg)
   {
-    _map = *msg;
+    setMap(MapStore::getInstance().getMap(msg));
+  }
+
+  /**
+  @brief Sets the map of the robot and its sensors
+  @param map [const SharedMapConstPtr&] The map shared by the robots
+  @return void
+  **/
+  void Robot::setMap(const SharedMapConstPtr& map)
+  {
+    boost::atomic_store(&_map, map);
   }
 
   /**
@@ -194,53 +307,26 @@ namespace stdr_robot
   bool Robot::moveRobotCallback(stdr_msgs::MoveRobot::Request& req,
                 stdr_msgs::MoveRobot::Response& res)
   {
-    if( collisionExistsNoPath(req.newPose) ||
-        checkUnknownOccupancy(req.newPose) )
+    SharedMapConstPtr sharedMap = boost::atomic_load(&_map);
+    if( sharedMap &&
+        ( _collisionChecker->collisionExistsNoPath(*sharedMap, req.newPose) ||
+          checkUnknownOccupancy(req.newPose) ) )
     {
       return false;
     }
     
+    //!< Not in the middle of a step, which would overwrite the new pose
+    boost::mutex::scoped_lock lock(_poseMutex);
     _currentPose = req.newPose;
 
     _previousPose = _currentPose;
+    boost::atomic_store(&_robotPose,
+      RobotPoseConstPtr(new geometry_msgs::Pose2D(_previousPose)));
 
     _motionControllerPtr->setPose(_previousPose);
     return true;
   }
 
-  /**
-  @brief Checks the robot collision -2b changed-
-  @return True on collision
-  **/
-  bool Robot::collisionExistsNoPath(
-    const geometry_msgs::Pose2D& newPose)
-  {
-    if(_map.info.width == 0 || _map.info.height == 0)
-    {
-      return false;
-    }
-
-    int xMap = newPose.x / _map.info.resolution;
-    int yMap = newPose.y / _map.info.resolution;
-
-    for(unsigned int i = 0 ; i < _footprint.size() ; i++)
-    {
-      double x = _footprint[i].first * cos(newPose.theta) -
-                 _footprint[i].second * sin(newPose.theta);
-      double y = _footprint[i].first * sin(newPose.theta) +
-                 _footprint[i].second * cos(newPose.theta);
-                 
-      int xx = xMap + (int)(x / _map.info.resolution);
-      int yy = yMap + (int)(y / _map.info.resolution);
-
-      if(_map.data[ yy * _map.info.width + xx ] > 70)
-      {
-        return true;
-      }
-    }
-    return false;
-  }
-
   /**
   @brief Checks the robot's reposition into unknown area
   @param newPose [const geometry_msgs::Pose2D] The pose for the robot to be moved to
@@ -249,15 +335,23 @@ namespace stdr_robot
   bool Robot::checkUnknownOccupancy(
     const geometry_msgs::Pose2D& newPose)
   {
-    if(_map.info.width == 0 || _map.info.height == 0)
+    SharedMapConstPtr sharedMap = boost::atomic_load(&_map);
+    if( !sharedMap )
     {
       return false;
     }
+    const nav_msgs::OccupancyGrid& map = sharedMap->getGrid();
+    const OccupancyBitmap& occupancy = sharedMap->getOccupancy();
 
-    int xMap = newPose.x / _map.info.resolution;
-    int yMap = newPose.y / _map.info.resolution;
+    if(map.info.width == 0 || map.info.height == 0)
+    {
+      return false;
+    }
 
-    if( _map.data[ yMap * _map.info.width + xMap ] == -1 )
+    int xMap = newPose.x / map.info.resolution;
+    int yMap = newPose.y / map.info.resolution;
+
+    if( occupancy.isUnknown(xMap, yMap) )
     {
       return true;
     }
@@ -266,176 +360,106 @@ namespace stdr_robot
   }
   
   /**
-  @brief Returns the points between two points
-  @param x1 : The x coord of the first point
-  @param y1 : The y coord of the first point
-  @param x2 : The x coord of the second point
-  @param y2 : The y coord of the second point
-  @return The points inbetween
+  @brief Advances the robot by one tick of its collision timer, or of \
+  the lockstep simulation, after its fleet has moved
+  @param now [const ros::Time&] The time of the tick
+  @return void
   **/
-  std::vector<std::pair<int,int> > Robot::getPointsBetween(
-    int x1, int y1, int x2, int y2) 
+  void Robot::step(const ros::Time& now)
   {
-    std::vector<std::pair<int,int> > points;
-    
-    float angle = atan2(y2 - y1, x2 - x1);
-    float dist = sqrt( pow(x2 - x1, 2) + pow(y2 - y1, 2));
-    
-    int d = 0;
+    boost::mutex::scoped_lock lock(_poseMutex);
+    updatePose();
+
+    //!< The sensors read their pose from here, tf is only published
+    boost::atomic_store(&_robotPose,
+      RobotPoseConstPtr(new geometry_msgs::Pose2D(_previousPose)));
 
-    while(d < dist)
+    if ( now >= _nextOdomPublish )
     {
-      int x = x1 + d * cos(angle);
-      int y = y1 + d * sin(angle);
-      points.push_back(std::pair<int,int>(x,y));
-      d++;
+      publishOdometry(now);
+      //!< Keeps the publishing rate, unless a whole period was missed
+      _nextOdomPublish += _publishPeriod;
+      if ( _nextOdomPublish <= now )
+      {
+        _nextOdomPublish = now + _publishPeriod;
+      }
     }
-    
-    return points;
   }
 
   /**
-  @brief Checks the robot collision -2b changed-
-  @return True on collision
+  @brief Accepts the pose of the motion controller up to the first \
+  contact of its motion. With sliding on, the rest of the motion along \
+  the contact is kept.
+  @return void
   **/
-  bool Robot::collisionExists(
-    const geometry_msgs::Pose2D& newPose,
-    const geometry_msgs::Pose2D& previousPose)
+  void Robot::updatePose(void)
   {
-    if(_map.info.width == 0 || _map.info.height == 0)
-      return false;
-
-    int xMapPrev, xMap, yMapPrev, yMap;
-    bool movingForward, movingUpward;
-
-    //Check robot's previous direction to prevent getting stuck when colliding
-    movingForward = _previousMovementXAxis? false: true;
-    if ( fabs(previousPose.x - newPose.x) > 0.001)
+    geometry_msgs::Pose2D pose = _motionControllerPtr->getPose();
+    SharedMapConstPtr sharedMap = boost::atomic_load(&_map);
+    if( !sharedMap )
     {
-      movingForward = (previousPose.x > newPose.x)? false: true;
-      _previousMovementXAxis = movingForward;
+      _previousPose = pose;
+      return;
     }
-    movingUpward = _previousMovementYAxis? false: true;
-    if ( fabs(previousPose.y - newPose.y) > 0.001)
+
+    Contact contact = _collisionChecker->sweep(*sharedMap, pose, _previousPose);
+    if( contact.time >= 1 )
     {
-      movingUpward = (previousPose.y > newPose.y)? false: true;
-      _previousMovementYAxis = movingUpward;
+      _previousPose = pose;
+      return;
     }
 
-    xMapPrev = movingForward? (int)( previousPose.x / _map.info.resolution ):
-                              ceil( previousPose.x / _map.info.resolution );
-    xMap = movingForward? ceil( newPose.x / _map.info.resolution ):
-                          (int)( newPose.x / _map.info.resolution );
+    geometry_msgs::Pose2D contactPose =
+      CollisionChecker::interpolate(_previousPose, pose, contact.time);
 
-    yMapPrev = movingUpward? (int)( previousPose.y / _map.info.resolution ):
-                              ceil( previousPose.y / _map.info.resolution );
-    yMap = movingUpward? ceil( newPose.y / _map.info.resolution ):
-                        (int)( newPose.y / _map.info.resolution );
-
-    float angle = atan2(yMap - yMapPrev, xMap - xMapPrev);
-    int x = xMapPrev;
-    int y = yMapPrev;
-    int d = 2;
-
-    while(pow(xMap - x,2) + pow(yMap - y,2) > 1)
+    if( _slideOnCollision )
     {
-      x = xMapPrev +
-        ( movingForward? ceil( cos(angle) * d ): (int)( cos(angle) * d ) );
-      y = yMapPrev +
-        ( movingUpward? ceil( sin(angle) * d ): (int)( sin(angle) * d ) );
-      //Check all footprint points
-      for(unsigned int i = 0 ; i < _footprint.size() ; i++)
-      {
-        int index_1 = i;
-        int index_2 = (i + 1) % _footprint.size();
-        
-        // Get two consecutive footprint points
-        double footprint_x_1 = _footprint[index_1].first * cos(newPose.theta) -
-                   _footprint[index_1].second * sin(newPose.theta);
-        double footprint_y_1 = _footprint[index_1].first * sin(newPose.theta) +
-                   _footprint[index_1].second * cos(newPose.theta);
-
-        int xx1 = x + footprint_x_1 / _map.info.resolution;
-        int yy1 = y + footprint_y_1 / _map.info.resolution;
-        
-        double footprint_x_2 = _footprint[index_2].first * cos(newPose.theta) -
-                   _footprint[index_2].second * sin(newPose.theta);
-        double footprint_y_2 = _footprint[index_2].first * sin(newPose.theta) +
-                   _footprint[index_2].second * cos(newPose.theta);
-
-        int xx2 = x + footprint_x_2 / _map.info.resolution;
-        int yy2 = y + footprint_y_2 / _map.info.resolution;
-        
-        //Here check all the points between the vertexes
-        std::vector<std::pair<int,int> > pts = 
-          getPointsBetween(xx1,yy1,xx2,yy2);
-        
-        for(unsigned int j = 0 ; j < pts.size() ; j++)
-        {
-          static int OF = 1;
-          if(
-            _map.data[ (pts[j].second - OF) * 
-              _map.info.width + pts[j].first - OF ] > 70 ||
-            _map.data[ (pts[j].second - OF) * 
-              _map.info.width + pts[j].first ] > 70 ||
-            _map.data[ (pts[j].second - OF) *  
-              _map.info.width + pts[j].first + OF ] > 70 ||
-            _map.data[ (pts[j].second) * 
-              _map.info.width + pts[j].first - OF ] > 70 ||
-            _map.data[ (pts[j].second) * 
-              _map.info.width + pts[j].first + OF ] > 70 ||
-            _map.data[ (pts[j].second + OF) * 
-              _map.info.width + pts[j].first - OF ] > 70 ||
-            _map.data[ (pts[j].second + OF) * 
-              _map.info.width + pts[j].first ] > 70 ||
-            _map.data[ (pts[j].second + OF) * 
-              _map.info.width + pts[j].first + OF ] > 70
-          )
-          {
-            return true;
-          }
-        }
-      }
-      if ( (movingForward && xMap < x) || (movingUpward && yMap < y) ||
-          (!movingForward && xMap > x) || (!movingUpward && yMap > y) )
+      //!< Keeps the part of the remaining motion along the contact
+      double dx = pose.x - contactPose.x;
+      double dy = pose.y - contactPose.y;
+      const double into = dx * contact.normalX + dy * contact.normalY;
+      if( into < 0 )
       {
-        break;
+        dx -= into * contact.normalX;
+        dy -= into * contact.normalY;
       }
-      d++;
+      geometry_msgs::Pose2D slidPose = pose;
+      slidPose.x = contactPose.x + dx;
+      slidPose.y = contactPose.y + dy;
+      const Contact slide =
+        _collisionChecker->sweep(*sharedMap, slidPose, contactPose);
+      contactPose =
+        CollisionChecker::interpolate(contactPose, slidPose, slide.time);
     }
-    return false;
+
+    _previousPose = contactPose;
+    _motionControllerPtr->setPose(contactPose);
   }
 
   /**
-  @brief Publishes the tf transforms every with 10Hz
+  @brief Steps the robot on its collision timer
+  @param event [const ros::TimerEvent&] A ROS timer event
   @return void
   **/
-  void Robot::publishTransforms(const ros::TimerEvent&)
+  void Robot::updateCallback(const ros::TimerEvent& event)
   {
-    geometry_msgs::Pose2D pose = _motionControllerPtr->getPose();
-    if( ! collisionExists(pose, _previousPose) )
-    {
-      _previousPose = pose;
-    }
-    else
-    {
-      _motionControllerPtr->setPose(_previousPose);
-    }
-    //!< Robot tf
-    tf::Vector3 translation(_previousPose.x, _previousPose.y, 0);
-    tf::Quaternion rotation;
-    rotation.setRPY(0, 0, _previousPose.theta);
-
-    tf::Transform mapToRobot(rotation, translation);
-
-    _tfBroadcaster.sendTransform(tf::StampedTransform(
-      mapToRobot, ros::Time::now(), "map_static", getName()));
+    const ros::Time now = ros::Time::now();
+    _motionControllerPtr->advance(now - _lastUpdate);
+    step(now);
+    _lastUpdate = now;
+  }
 
-    //!< Odometry
+  /**
+  @brief Publishes the odometry. The TransformPublisher sends the tf.
+  @param now [const ros::Time&] The stamp of the odometry
+  @return void
+  **/
+  void Robot::publishOdometry(const ros::Time& now)
+  {
     nav_msgs::Odometry odom;
-    odom.header.stamp = ros::Time::now();
+    odom.header.stamp = now;
     odom.header.frame_id = "map_static";
-    odom.child_frame_id = getName();
+    odom.child_frame_id = _name;
     odom.pose.pose.position.x = _previousPose.x;
     odom.pose.pose.position.y = _previousPose.y;
     odom.pose.pose.orientation = tf::createQuaternionMsgFromYaw(
@@ -443,24 +467,6 @@ namespace stdr_robot
     odom.twist.twist = _motionControllerPtr->getVelocity();
 
     _odomPublisher.publish(odom);
-
-    //!< Sensors tf
-    for (int i = 0; i < _sensors.size(); i++) {
-      geometry_msgs::Pose2D sensorPose = _sensors[i]->getSensorPose();
-
-      tf::Vector3 trans(sensorPose.x, sensorPose.y, 0);
-      tf::Quaternion rot;
-      rot.setRPY(0, 0, sensorPose.theta);
-
-      tf::Transform robotToSensor(rot, trans);
-
-      _tfBroadcaster.sendTransform(
-        tf::StampedTransform(
-          robotToSensor,
-          ros::Time::now(),
-          getName(),
-          _sensors[i]->getFrameId()));
-    }
   }
 
   /**
@@ -470,6 +476,15 @@ namespace stdr_robot
   Robot::~Robot()
   {
     //!< Cleanup
+    TransformPublisher::getInstance().removeRobot(_name);
+    if ( ros::Time::isSimTime() )
+    {
+      SimulationStepper::getInstance().removeRobot(this);
+    }
+    for ( unsigned int i = 0; i < _sensors.size(); i++ )
+    {
+      SensorScheduler::getInstance().removeSensor(_sensors[i]);
+    }
   }
 
 }  // namespace stdr_robot
@@ -0,0 +1,183 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/transform_publisher.h>
+#include <algorithm>
+#include <tf/transform_datatypes.h>
+
+namespace stdr_robot {
+
+  /**
+  @brief Returns the transform publisher of the process, created on first use
+  @return TransformPublisher&
+  **/
+  TransformPublisher& TransformPublisher::getInstance(void)
+  {
+    static TransformPublisher publisher;
+    return publisher;
+  }
+
+  /**
+  @brief Default constructor
+  @return void
+  **/
+  TransformPublisher::TransformPublisher(void)
+    : _staticChanged(false)
+  {
+    double publishRate;
+    ros::param::param<double>("~publish_rate", publishRate, 10.0);
+    _publishPeriod = ros::Duration(1.0 / std::max(publishRate, 0.1));
+
+    _tfPublisher = _nodeHandle.advertise<tf2_msgs::TFMessage>("/tf", 100);
+    _staticPublisher = _nodeHandle.advertise<tf2_msgs::TFMessage>(
+      "/tf_static", 1, true);
+
+    if ( !ros::Time::isSimTime() )
+    {
+      _timer = _nodeHandle.createTimer(_publishPeriod,
+        &TransformPublisher::timerCallback, this);
+    }
+  }
+
+  /**
+  @brief Starts publishing the transforms of a robot
+  @param frameId [const std::string&] The robot frame id
+  @param pose [const RobotPoseConstPtr&] The pose snapshot of the robot
+  @param sensors [const std::vector<geometry_msgs::TransformStamped>&] \
+  The transforms from the robot to its sensors
+  @return void
+  **/
+  void TransformPublisher::addRobot(const std::string& frameId,
+    const RobotPoseConstPtr& pose,
+    const std::vector<geometry_msgs::TransformStamped>& sensors)
+  {
+    PublishedRobot robot;
+    robot.frameId = frameId;
+    robot.pose = &pose;
+    robot.sensors = sensors;
+
+    boost::mutex::scoped_lock lock(_mutex);
+    _robots.push_back(robot);
+    _staticChanged = true;
+  }
+
+  /**
+  @brief Stops publishing the transforms of a robot. Blocks while a \
+  tick is in progress, so the robot can be destroyed right after.
+  @param frameId [const std::string&] The robot frame id
+  @return void
+  **/
+  void TransformPublisher::removeRobot(const std::string& frameId)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    for ( unsigned int i = 0; i < _robots.size(); i++ )
+    {
+      if ( _robots[i].frameId == frameId )
+      {
+        _robots.erase(_robots.begin() + i);
+        _staticChanged = true;
+        return;
+      }
+    }
+  }
+
+  /**
+  @brief Ticks on the publish timer, when not in lockstep
+  @param event [const ros::TimerEvent&] The timer event
+  @return void
+  **/
+  void TransformPublisher::timerCallback(const ros::TimerEvent& event)
+  {
+    tick( ros::Time::now() );
+  }
+
+  /**
+  @brief Publishes the sensor transforms if robots were added or removed, \
+  and the robot transforms if they are due
+  @param now [const ros::Time&] The current time, stamp of the transforms
+  @return void
+  **/
+  void TransformPublisher::tick(const ros::Time& now)
+  {
+    boost::mutex::scoped_lock lock(_mutex);
+    //!< Robots spawned together share one message of sensor transforms
+    if ( _staticChanged )
+    {
+      publishStatic();
+      _staticChanged = false;
+    }
+
+    if ( now < _nextPublish )
+    {
+      return;
+    }
+    //!< Keeps the publishing rate, unless a whole period was missed
+    _nextPublish += _publishPeriod;
+    if ( _nextPublish <= now )
+    {
+      _nextPublish = now + _publishPeriod;
+    }
+
+    _message.transforms.resize( _robots.size() );
+    unsigned int published = 0;
+    for ( unsigned int i = 0; i < _robots.size(); i++ )
+    {
+      RobotPoseConstPtr pose = boost::atomic_load( _robots[i].pose );
+      if ( !pose )
+      {
+        continue;
+      }
+
+      geometry_msgs::TransformStamped& transform =
+        _message.transforms[published++];
+      transform.header.stamp = now;
+      transform.header.frame_id = "map_static";
+      transform.child_frame_id = _robots[i].frameId;
+      transform.transform.translation.x = pose->x;
+      transform.transform.translation.y = pose->y;
+      transform.transform.translation.z = 0;
+      transform.transform.rotation =
+        tf::createQuaternionMsgFromYaw(pose->theta);
+    }
+    _message.transforms.resize(published);
+
+    if ( published > 0 )
+    {
+      _tfPublisher.publish(_message);
+    }
+  }
+
+  /**
+  @brief Publishes the sensor transforms of all robots. Call locked.
+  @return void
+  **/
+  void TransformPublisher::publishStatic(void)
+  {
+    tf2_msgs::TFMessage message;
+    for ( unsigned int i = 0; i < _robots.size(); i++ )
+    {
+      message.transforms.insert( message.transforms.end(),
+        _robots[i].sensors.begin(), _robots[i].sensors.end() );
+    }
+    _staticPublisher.publish(message);
+  }
+
+}  // namespace stdr_robot
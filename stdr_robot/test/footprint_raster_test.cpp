@@ -0,0 +1,219 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/footprint_raster.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace stdr_robot;
+
+namespace {
+
+  /**
+  @brief Returns a uniform random number in [0, 1)
+  @return float
+  **/
+  float uniform(void)
+  {
+    return rand() / ( RAND_MAX + 1.0f );
+  }
+
+  /**
+  @brief Returns a random occupancy grid map
+  @param width [int] The map width in cells
+  @param height [int] The map height in cells
+  @param resolution [float] The map resolution
+  @param density [float] The probability of an occupied cell
+  @return nav_msgs::OccupancyGrid
+  **/
+  nav_msgs::OccupancyGrid randomGrid(int width, int height,
+    float resolution, float density)
+  {
+    nav_msgs::OccupancyGrid grid;
+    grid.info.width = width;
+    grid.info.height = height;
+    grid.info.resolution = resolution;
+    grid.data.resize(width * height);
+    for ( int i = 0; i < width * height; i++ )
+    {
+      grid.data[i] = uniform() < density ? 100 : 0;
+    }
+    return grid;
+  }
+
+  /**
+  @brief Returns a random footprint: a polygon of a few vertices or a \
+  circle as CollisionChecker builds it
+  @return FootprintRaster::Footprint
+  **/
+  FootprintRaster::Footprint randomFootprint(void)
+  {
+    FootprintRaster::Footprint footprint;
+    if ( rand() % 4 == 0 )
+    {
+      const float radius = 0.05f + 0.5f * uniform();
+      for ( unsigned int i = 0; i < 360; i++ )
+      {
+        footprint.push_back( std::pair<float,float>(
+          cos(i * M_PI / 180.0) * radius, sin(i * M_PI / 180.0) * radius ) );
+      }
+      return footprint;
+    }
+
+    const int vertices = 3 + rand() % 6;
+    for ( int i = 0; i < vertices; i++ )
+    {
+      const float angle = 2 * M_PI * ( i + uniform() ) / vertices;
+      const float radius = 0.05f + 0.6f * uniform();
+      footprint.push_back( std::pair<float,float>(
+        cos(angle) * radius, sin(angle) * radius ) );
+    }
+    return footprint;
+  }
+
+  /**
+  @brief The per pose check the raster replaces: rotates the footprint \
+  to the exact heading, walks every edge one cell at a time and probes \
+  each point with its 8 neighbours
+  @param occupancy [const OccupancyBitmap&] The map occupancy
+  @param footprint [const FootprintRaster::Footprint&] The footprint
+  @param resolution [float] The map resolution
+  @param x [int] The cell of the robot center
+  @param y [int] The cell of the robot center
+  @param theta [float] The robot orientation
+  @return bool : True on collision
+  **/
+  bool exactCollision(const OccupancyBitmap& occupancy,
+    const FootprintRaster::Footprint& footprint, float resolution,
+    int x, int y, float theta)
+  {
+    for ( unsigned int i = 0; i < footprint.size(); i++ )
+    {
+      const std::pair<float,float>& v1 = footprint[i];
+      const std::pair<float,float>& v2 =
+        footprint[ ( i + 1 ) % footprint.size() ];
+
+      const int x1 = x + static_cast<int>( floor(
+        ( v1.first * cos(theta) - v1.second * sin(theta) ) / resolution ) );
+      const int y1 = y + static_cast<int>( floor(
+        ( v1.first * sin(theta) + v1.second * cos(theta) ) / resolution ) );
+      const int x2 = x + static_cast<int>( floor(
+        ( v2.first * cos(theta) - v2.second * sin(theta) ) / resolution ) );
+      const int y2 = y + static_cast<int>( floor(
+        ( v2.first * sin(theta) + v2.second * cos(theta) ) / resolution ) );
+
+      float angle = atan2(y2 - y1, x2 - x1);
+      float dist = sqrt( pow(x2 - x1, 2) + pow(y2 - y1, 2) );
+      for ( int d = 0; d < dist; d++ )
+      {
+        const int px = x1 + static_cast<int>( floor( d * cos(angle) ) );
+        const int py = y1 + static_cast<int>( floor( d * sin(angle) ) );
+        for ( int dy = -1; dy <= 1; dy++ )
+        {
+          for ( int dx = -1; dx <= 1; dx++ )
+          {
+            if ( occupancy.isOccupied(px + dx, py + dy) )
+            {
+              return true;
+            }
+          }
+        }
+      }
+    }
+    return false;
+  }
+
+}
+
+TEST(FootprintRaster, NeverMissesAnExactCollision)
+{
+  srand(42);
+  int exactHits = 0;
+  for ( int map = 0; map < 20; map++ )
+  {
+    //!< A single obstacle cell in the middle, so that every hit comes
+    //!< from one probed cell and edge cases are not hidden by others
+    const float resolution = 0.02f + 0.08f * uniform();
+    const int size = 101;
+    nav_msgs::OccupancyGrid grid = randomGrid(size, size, resolution, 0);
+    grid.data[ size / 2 * size + size / 2 ] = 100;
+    const OccupancyBitmap occupancy(grid, 70);
+
+    for ( int robot = 0; robot < 20; robot++ )
+    {
+      const FootprintRaster::Footprint footprint = randomFootprint();
+      const FootprintRaster raster(footprint, resolution);
+
+      float radius = 0;
+      for ( unsigned int i = 0; i < footprint.size(); i++ )
+      {
+        radius = std::max( radius, static_cast<float>( sqrt(
+          footprint[i].first * footprint[i].first +
+          footprint[i].second * footprint[i].second ) / resolution ) );
+      }
+      const int reach = std::min( size / 2, static_cast<int>(radius) + 2 );
+
+      for ( int pose = 0; pose < 2000; pose++ )
+      {
+        const int x = size / 2 - reach + rand() % ( 2 * reach + 1 );
+        const int y = size / 2 - reach + rand() % ( 2 * reach + 1 );
+        //!< Orientations are not normalized by the motion controllers
+        const float theta = ( uniform() - 0.5f ) * 8 * M_PI;
+
+        if ( exactCollision(occupancy, footprint, resolution, x, y, theta) )
+        {
+          exactHits++;
+          EXPECT_TRUE( raster.collides(occupancy, x, y, theta) ) <<
+            "map " << map << " robot " << robot << " pose " << pose;
+        }
+      }
+    }
+  }
+  //!< Enough poses touch the obstacle to cover the bin edges
+  EXPECT_GT(exactHits, 10000);
+}
+
+TEST(FootprintRaster, FreeInAnEmptyMap)
+{
+  srand(7);
+  const float resolution = 0.05f;
+  const nav_msgs::OccupancyGrid grid = randomGrid(100, 100, resolution, 0);
+  const OccupancyBitmap occupancy(grid, 70);
+
+  for ( int robot = 0; robot < 20; robot++ )
+  {
+    const FootprintRaster raster(randomFootprint(), resolution);
+    for ( int heading = 0; heading < 64; heading++ )
+    {
+      EXPECT_FALSE( raster.collides(occupancy, 50, 50,
+        2 * M_PI * heading / 64) ) << "robot " << robot;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/sensors/raycast.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace stdr_robot;
+
+namespace {
+
+  /**
+  @class RandomMap
+  @brief A random occupancy grid and its brute force distance grid
+  **/
+  class RandomMap {
+
+    public:
+
+      /**
+      @brief Default constructor
+      @param width [int] The map width in cells
+      @param height [int] The map height in cells
+      @param density [float] The probability of an occupied cell
+      @return void
+      **/
+      RandomMap(int width, int height, float density)
+      {
+        _grid.layout.resize(width, height);
+        _distances.assign(_grid.layout.size(), 0);
+
+        std::vector<int> occupied;
+        for ( int y = 0; y < height; y++ )
+        {
+          for ( int x = 0; x < width; x++ )
+          {
+            if ( uniform() < density )
+            {
+              occupied.push_back(x);
+              occupied.push_back(y);
+            }
+          }
+        }
+
+        for ( int y = 0; y < height; y++ )
+        {
+          for ( int x = 0; x < width; x++ )
+          {
+            float best = occupied.empty() ? width + height : INFINITY;
+            for ( unsigned int i = 0; i < occupied.size(); i += 2 )
+            {
+              const float dx = x - occupied[i];
+              const float dy = y - occupied[i + 1];
+              best = std::min(best, sqrtf(dx * dx + dy * dy));
+            }
+            _distances[ _grid.layout.index(x, y) ] = best;
+          }
+        }
+        _grid.distances = &_distances[0];
+      }
+
+      /**
+      @brief Returns the distance grid
+      @return const DistanceGrid&
+      **/
+      inline const DistanceGrid& getGrid(void) const
+      {
+        return _grid;
+      }
+
+      /**
+      @brief Returns a uniform random number in [0, 1)
+      @return float
+      **/
+      static float uniform(void)
+      {
+        return rand() / ( RAND_MAX + 1.0f );
+      }
+
+    private:
+
+      //!< The distances in layout order
+      std::vector<float> _distances;
+      //!< The grid of the kernels
+      DistanceGrid _grid;
+  };
+
+  typedef void (*CastRaysKernel)(const DistanceGrid&, float, float,
+    const float*, const float*, int, float, float*);
+
+  /**
+  @brief Casts random beams on random maps through a kernel and the \
+  scalar kernel and requires the same ranges
+  @param kernel [CastRaysKernel] The kernel under test
+  @return void
+  **/
+  void expectScalarParity(CastRaysKernel kernel)
+  {
+    srand(42);
+    for ( int map = 0; map < 20; map++ )
+    {
+      //!< Sizes off the tile size and the lane count on purpose
+      const int width = 5 + rand() % 120;
+      const int height = 5 + rand() % 120;
+      const RandomMap randomMap(width, height,
+        0.002f + 0.2f * RandomMap::uniform());
+
+      for ( int batch = 0; batch < 20; batch++ )
+      {
+        const int count = 1 + rand() % 37;
+        std::vector<float> dirX(count), dirY(count);
+        for ( int i = 0; i < count; i++ )
+        {
+          //!< Axis aligned beams as well, they have no step on one axis
+          const float angle = i % 8 == 0 ?
+            ( rand() % 4 ) * M_PI / 2 : RandomMap::uniform() * 2 * M_PI;
+          dirX[i] = cosf(angle);
+          dirY[i] = sinf(angle);
+        }
+        const float originX = RandomMap::uniform() * width;
+        const float originY = RandomMap::uniform() * height;
+        const float maxDistance = 1 + RandomMap::uniform() * 150;
+
+        std::vector<float> expected(count), actual(count);
+        castRaysScalar(randomMap.getGrid(), originX, originY,
+          &dirX[0], &dirY[0], count, maxDistance, &expected[0]);
+        kernel(randomMap.getGrid(), originX, originY,
+          &dirX[0], &dirY[0], count, maxDistance, &actual[0]);
+
+        //!< Every lane performs the scalar operations in the same order,
+        //!< so the ranges match to the bit
+        for ( int i = 0; i < count; i++ )
+        {
+          EXPECT_EQ(expected[i], actual[i]) << "map " << map <<
+            " batch " << batch << " beam " << i;
+        }
+      }
+    }
+  }
+
+}
+
+#ifdef STDR_RAYCAST_SIMD
+
+TEST(CastRays, SSE4MatchesScalar)
+{
+  __builtin_cpu_init();
+  if ( !__builtin_cpu_supports("sse4.1") )
+  {
+    std::cout << "SSE4.1 not supported, skipped" << std::endl;
+    return;
+  }
+  expectScalarParity(castRaysSSE4);
+}
+
+TEST(CastRays, AVX2MatchesScalar)
+{
+  __builtin_cpu_init();
+  if ( !__builtin_cpu_supports("avx2") )
+  {
+    std::cout << "AVX2 not supported, skipped" << std::endl;
+    return;
+  }
+  expectScalarParity(castRaysAVX2);
+}
+
+#endif
+
+TEST(CastRays, DispatchMatchesScalar)
+{
+  expectScalarParity(castRays);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
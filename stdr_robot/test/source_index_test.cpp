@@ -0,0 +1,173 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_robot/sensors/source_index.h>
+#include <gtest/gtest.h>
+#include <cstdlib>
+#include <vector>
+
+using namespace stdr_robot;
+
+namespace {
+
+  /**
+  @struct Pose
+  @brief The position of a test source
+  **/
+  struct Pose {
+    float x;
+    float y;
+  };
+
+  /**
+  @struct TestSource
+  @brief A point source with an id
+  **/
+  struct TestSource {
+    Pose pose;
+    int id;
+  };
+
+  /**
+  @brief Returns a uniform random number in [0, 1)
+  @return float
+  **/
+  float uniform(void)
+  {
+    return rand() / ( RAND_MAX + 1.0f );
+  }
+
+  /**
+  @brief Returns random sources inside a box
+  @param count [int] The number of sources
+  @param minX [float] The box corner
+  @param minY [float] The box corner
+  @param size [float] The box side
+  @return std::vector<TestSource>
+  **/
+  std::vector<TestSource> randomSources(int count,
+    float minX, float minY, float size)
+  {
+    std::vector<TestSource> sources(count);
+    for ( int i = 0; i < count; i++ )
+    {
+      sources[i].pose.x = minX + uniform() * size;
+      sources[i].pose.y = minY + uniform() * size;
+      sources[i].id = i;
+    }
+    return sources;
+  }
+
+  /**
+  @brief Checks a query against a linear scan of the sources
+  @param index [const SourceIndex<TestSource>&] The index
+  @param sources [const std::vector<TestSource>&] The indexed sources
+  @param x [float] The query point
+  @param y [float] The query point
+  @param range [float] The query range
+  @return void
+  **/
+  void expectQuery(const SourceIndex<TestSource>& index,
+    const std::vector<TestSource>& sources, float x, float y, float range)
+  {
+    std::vector<unsigned int> found;
+    index.query(x, y, range, found);
+
+    std::vector<int> expected, actual;
+    for ( unsigned int i = 0; i < sources.size(); i++ )
+    {
+      const float dx = sources[i].pose.x - x;
+      const float dy = sources[i].pose.y - y;
+      if ( dx * dx + dy * dy <= range * range )
+      {
+        expected.push_back(sources[i].id);
+      }
+    }
+    for ( unsigned int i = 0; i < found.size(); i++ )
+    {
+      actual.push_back(index.getSource(found[i]).id);
+    }
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(expected, actual) << "query " << x << " " << y <<
+      " range " << range;
+  }
+
+}
+
+TEST(SourceIndex, QueriesInsideMatchALinearScan)
+{
+  srand(3);
+  const std::vector<TestSource> sources = randomSources(500, 10, 20, 30);
+  const SourceIndex<TestSource> index(sources, 2.0f);
+  for ( int query = 0; query < 500; query++ )
+  {
+    expectQuery(index, sources, 5 + uniform() * 40, 15 + uniform() * 40,
+      uniform() * 8);
+  }
+}
+
+TEST(SourceIndex, QueriesBesideTheSources)
+{
+  srand(5);
+  //!< The sources cover [10, 40] x [20, 50]
+  const std::vector<TestSource> sources = randomSources(200, 10, 20, 30);
+  const SourceIndex<TestSource> index(sources, 2.0f);
+
+  //!< Left, right, below and above, overlapping the sources in the other
+  //!< axis, then touching the edge of the box
+  const float ranges[] = {1.0f, 3.0f, 5.0f};
+  for ( int r = 0; r < 3; r++ )
+  {
+    for ( float along = 20; along <= 50; along += 2.5f )
+    {
+      expectQuery(index, sources, 10 - ranges[r] - 0.5f, along, ranges[r]);
+      expectQuery(index, sources, 40 + ranges[r] + 0.5f, along, ranges[r]);
+      expectQuery(index, sources, along - 10, 20 - ranges[r] - 0.5f,
+        ranges[r]);
+      expectQuery(index, sources, along - 10, 50 + ranges[r] + 0.5f,
+        ranges[r]);
+      expectQuery(index, sources, 10 - ranges[r] + 0.5f, along, ranges[r]);
+      expectQuery(index, sources, 40 + ranges[r] - 0.5f, along, ranges[r]);
+    }
+  }
+}
+
+TEST(SourceIndex, QueriesFarOutside)
+{
+  srand(9);
+  const std::vector<TestSource> sources = randomSources(200, 10, 20, 30);
+  const SourceIndex<TestSource> index(sources, 2.0f);
+
+  expectQuery(index, sources, -1e6f, 30, 10);
+  expectQuery(index, sources, 1e6f, 30, 10);
+  expectQuery(index, sources, 20, -1e6f, 10);
+  expectQuery(index, sources, 20, 1e6f, 10);
+  expectQuery(index, sources, 1e6f, 1e6f, 1e3f);
+
+  //!< A range covering everything from far away
+  expectQuery(index, sources, 1e4f, 1e4f, 1e5f);
+}
+
+int main(int argc, char** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
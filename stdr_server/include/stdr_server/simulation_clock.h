@@ -0,0 +1,110 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#ifndef SIMULATION_CLOCK_H
+#define SIMULATION_CLOCK_H
+
+#include <ros/ros.h>
+#include <ros/callback_queue.h>
+#include <rosgraph_msgs/Clock.h>
+#include <boost/thread/thread.hpp>
+
+/**
+@namespace stdr_server
+@brief The main namespace for STDR Server
+**/
+namespace stdr_server {
+
+  /**
+  @class SimulationClock
+  @brief Drives the simulation when /use_sim_time is set. Advances the \
+  simulated time by ~time_step, publishes it on /clock and waits until \
+  every robot manager reports the step done before the next one. Runs at \
+  most ~real_time_factor times faster than real time, or as fast as the \
+  robot managers step when the factor is not positive.
+  **/
+  class SimulationClock {
+
+    public:
+
+      /**
+      @brief Default constructor. Starts the clock thread.
+      @param n [ros::NodeHandle&] The ROS node handle
+      @return void
+      **/
+      explicit SimulationClock(ros::NodeHandle& n);
+
+      /**
+      @brief Default destructor. Stops the clock thread.
+      @return void
+      **/
+      ~SimulationClock(void);
+
+    private:
+
+      /**
+      @brief The clock thread loop
+      @return void
+      **/
+      void spin(void);
+
+      /**
+      @brief Publishes a tick and waits for the robot managers to step
+      @param time [const ros::Time&] The time of the tick
+      @return void
+      **/
+      void step(const ros::Time& time);
+
+      /**
+      @brief Callback of the robot managers reporting a step done
+      @param msg [const rosgraph_msgs::ClockConstPtr&] The stepped time
+      @return void
+      **/
+      void stepDoneCallback(const rosgraph_msgs::ClockConstPtr& msg);
+
+    private:
+
+      //!< Wall time to wait for a robot manager that stopped responding
+      static const double STEP_TIMEOUT;
+
+      //!< Simulated time advanced on every tick
+      ros::Duration _timeStep;
+      //!< Simulated seconds per wall second at most, unbounded if not positive
+      double _realTimeFactor;
+
+      //!< The time of the tick being stepped
+      ros::Time _stepTime;
+      //!< Robot managers that stepped the current tick
+      unsigned int _stepsDone;
+
+      //!< Callback queue of the step reports, served by the clock thread
+      ros::CallbackQueue _queue;
+      //!< ROS publisher of the simulated time
+      ros::Publisher _clockPublisher;
+      //!< ROS subscriber for the step reports of the robot managers
+      ros::Subscriber _stepDoneSubscriber;
+      //!< The clock thread
+      boost::thread _thread;
+  };
+
+}
+
+#endif
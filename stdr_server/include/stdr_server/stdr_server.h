@@ -27,32 +27,44 @@
 
 #include <ros/ros.h>
 #include <actionlib/server/simple_action_server.h>
+#include <actionlib/server/action_server.h>
 #include <stdr_server/map_server.h>
+#include <stdr_server/simulation_clock.h>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread_time.hpp>
+#include <set>
 #include <stdr_msgs/LoadMap.h>
 #include <stdr_msgs/LoadExternalMap.h>
 #include <stdr_msgs/RegisterGui.h>
 #include <stdr_msgs/RegisterRobotAction.h>
 #include <stdr_msgs/SpawnRobotAction.h>
+#include <stdr_msgs/SpawnRobotsAction.h>
 #include <stdr_msgs/DeleteRobotAction.h>
+#include <stdr_msgs/LoadPooledRobots.h>
 #include <stdr_msgs/RobotIndexedMsg.h>
 #include <stdr_msgs/RobotIndexedVectorMsg.h>
 
 #include <visualization_msgs/Marker.h>
 #include <visualization_msgs/MarkerArray.h>
 
+#include <stdr_msgs/source_delta.h>
 #include <stdr_msgs/RfidTagVector.h>
+#include <stdr_msgs/RfidTagDelta.h>
 #include <stdr_msgs/AddRfidTag.h>
 #include <stdr_msgs/DeleteRfidTag.h>
 
 #include <stdr_msgs/CO2SourceVector.h>
+#include <stdr_msgs/CO2SourceDelta.h>
 #include <stdr_msgs/AddCO2Source.h>
 #include <stdr_msgs/DeleteCO2Source.h>
 
 #include <stdr_msgs/ThermalSourceVector.h>
+#include <stdr_msgs/ThermalSourceDelta.h>
 #include <stdr_msgs/AddThermalSource.h>
 #include <stdr_msgs/DeleteThermalSource.h>
 
 #include <stdr_msgs/SoundSourceVector.h>
+#include <stdr_msgs/SoundSourceDelta.h>
 #include <stdr_msgs/AddSoundSource.h>
 #include <stdr_msgs/DeleteSoundSource.h>
 
@@ -70,7 +82,11 @@ namespace stdr_server {
   typedef actionlib::SimpleActionServer<stdr_msgs::SpawnRobotAction> 
     SpawnRobotServer;
   
-  typedef actionlib::SimpleActionServer<stdr_msgs::RegisterRobotAction> 
+  typedef actionlib::SimpleActionServer<stdr_msgs::SpawnRobotsAction> 
+    SpawnRobotsServer;
+  
+  //!< Robots register concurrently, a simple server would preempt them
+  typedef actionlib::ActionServer<stdr_msgs::RegisterRobotAction> 
     RegisterRobotServer;
   
   typedef actionlib::SimpleActionServer<stdr_msgs::DeleteRobotAction> 
@@ -138,6 +154,15 @@ namespace stdr_server {
       **/
       void spawnRobotCallback(const stdr_msgs::SpawnRobotGoalConstPtr& goal);
       
+      /**
+      @brief Action callback for spawning many robots at once. The nodelets \
+      are loaded back to back and register meanwhile, active_robots is \
+      published once all of them are registered.
+      @param goal [const stdr_msgs::SpawnRobotsGoalConstPtr&] The action goal
+      @return void
+      **/
+      void spawnRobotsCallback(const stdr_msgs::SpawnRobotsGoalConstPtr& goal);
+      
       /**
       @brief Action callback for robot deletion
       @param goal [const stdr_msgs::DeleteRobotGoalConstPtr&] The action goal
@@ -148,11 +173,10 @@ namespace stdr_server {
         
       /**
       @brief Action callback for robot registering
-      @param goal [const stdr_msgs::RegisterRobotGoalConstPtr&] The action goal
+      @param goal [RegisterRobotServer::GoalHandle] The action goal
       @return void
       **/
-      void registerRobotCallback(
-        const stdr_msgs::RegisterRobotGoalConstPtr& goal);
+      void registerRobotCallback(RegisterRobotServer::GoalHandle goal);
       
     private:
       
@@ -162,6 +186,12 @@ namespace stdr_server {
       **/
       void activateActionServers(void);
       
+      /**
+      @brief Publishes all robots to the active_robots topic
+      @return void
+      **/
+      void publishActiveRobots(void);
+      
       /**
       @brief Adds new robot to simulator
       @param description [stdr_msgs::RobotMsg] The new robot description
@@ -171,6 +201,13 @@ namespace stdr_server {
       bool addNewRobot(stdr_msgs::RobotMsg description, 
         stdr_msgs::SpawnRobotResult* result);
         
+      /**
+      @brief Names the robots and hands them to the robot pool in one call
+      @param robots [std::vector<stdr_msgs::RobotIndexedMsg>*] The robots, named on return
+      @return bool : True if the pool loaded all of them
+      **/
+      bool loadPooledRobots(std::vector<stdr_msgs::RobotIndexedMsg>* robots);
+        
       /**
       @brief Deletes a robot from simulator
       @param name [std::string] The robot frame_id
@@ -179,6 +216,20 @@ namespace stdr_server {
       **/
       bool deleteRobot(std::string name, stdr_msgs::DeleteRobotResult* result);
       
+      /**
+      @brief Unloads a robot nodelet, or a robot of the robot pool
+      @param name [const std::string&] The robot frame_id
+      @return bool : True if the robot was unloaded
+      **/
+      bool unloadRobot(const std::string& name);
+      
+      /**
+      @brief Returns the time until which a spawn action waits for its \
+      robots to register
+      @return boost::system_time
+      **/
+      boost::system_time getRegisterDeadline(void) const;
+      
       /**
       @brief Service callback for adding new rfid tag to the environment
       @param req [stdr_msgs::AddRfidTag::Request &] The request
@@ -295,10 +346,99 @@ namespace stdr_server {
       visualization_msgs::Marker toMarker(const stdr_msgs::RfidTag& msg,bool added);
    
       /**
-      @brief Republishes existing sources to RVIZ after a successful deletion.
-      @return [void]
+      @brief Returns the whole rfid tag list
+      @return stdr_msgs::RfidTagVector
+      **/
+      stdr_msgs::RfidTagVector getRfidTagList(void);
+      
+      /**
+      @brief Sends the whole rfid tag list to a new list subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendRfidTagList(const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Returns the whole CO2 source list
+      @return stdr_msgs::CO2SourceVector
+      **/
+      stdr_msgs::CO2SourceVector getCO2SourceList(void);
+      
+      /**
+      @brief Sends the whole CO2 source list to a new list subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendCO2SourceList(const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Returns the whole thermal source list
+      @return stdr_msgs::ThermalSourceVector
+      **/
+      stdr_msgs::ThermalSourceVector getThermalSourceList(void);
+      
+      /**
+      @brief Sends the whole thermal source list to a new list subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendThermalSourceList(const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Returns the whole sound source list
+      @return stdr_msgs::SoundSourceVector
+      **/
+      stdr_msgs::SoundSourceVector getSoundSourceList(void);
+      
+      /**
+      @brief Sends the whole sound source list to a new list subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendSoundSourceList(const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Republishes the changed source lists to their subscribers
+      @param ev [const ros::TimerEvent&] A ROS timer event
+      @return void
+      **/
+      void publishSourceLists(const ros::TimerEvent& ev);
+      
+      /**
+      @brief Sends all existing sources as markers to a new Rviz subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendSourceMarkers(const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Sends the rfid tag list as a snapshot to a new subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendRfidTagSnapshot(const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Sends the CO2 source list as a snapshot to a new subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendCO2SourceSnapshot(const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Sends the thermal source list as a snapshot to a new subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
+      **/
+      void sendThermalSourceSnapshot(
+        const ros::SingleSubscriberPublisher& pub);
+      
+      /**
+      @brief Sends the sound source list as a snapshot to a new subscriber
+      @param pub [const ros::SingleSubscriberPublisher&] The new subscriber
+      @return void
       **/
-      void republishSources();
+      void sendSoundSourceSnapshot(const ros::SingleSubscriberPublisher& pub);
       
       /**
       @brief Creates a marker message corresponding to every element of msg that is 
@@ -313,6 +453,8 @@ namespace stdr_server {
       ros::NodeHandle _nh;
       //!< A pointer to a MapServe object
       MapServerPtr _mapServer;
+      //!< Drives /clock when /use_sim_time is set, NULL otherwise
+      boost::scoped_ptr<SimulationClock> _clock;
       
       //!< ROS publisher for the ensemble of robots
       ros::Publisher _robotsPublisher;
@@ -321,6 +463,12 @@ namespace stdr_server {
       ros::ServiceClient _spawnRobotClient;
       //!< Action client for robot unloading
       ros::ServiceClient _unloadRobotClient;
+      //!< Service client for loading robots in the robot pool
+      ros::ServiceClient _loadPooledRobotsClient;
+      //!< True when robots live in one RobotPool nodelet
+      bool _robotPool;
+      //!< Seconds a spawned robot has to register before it is unloaded
+      double _registerTimeout;
       //!< Service server for loading maps from files
       ros::ServiceServer _loadMapService;
       //!< Service server for loading maps from GUI
@@ -332,6 +480,8 @@ namespace stdr_server {
       RegisterRobotServer _registerRobotServer;
       //!< Action server for spawning robots
       SpawnRobotServer _spawnRobotServer;
+      //!< Action server for spawning many robots at once
+      SpawnRobotsServer _spawnRobotsServer;
       //!< Action server for deleting robots
       DeleteRobotServer _deleteRobotServer;
       
@@ -339,6 +489,8 @@ namespace stdr_server {
       RobotMap _robotMap;
       //!< Index that shows the next robot id
       int _id;
+      //!< Robots loaded whose RegisterRobotAction has not come yet
+      std::set<std::string> _unregisteredRobots;
       
       //!< An std::map that contains the rfid tags existent in the environment
       RfidTagMap _rfidTagMap;
@@ -357,35 +509,61 @@ namespace stdr_server {
       
       //!< A general Rviz publisher for all source types
       ros::Publisher _sourceVectorPublisherRviz;
+      //!< Republishes the changed source lists
+      ros::Timer _sourceListTimer;
       
       //!< The addRfidTag srv server
       ros::ServiceServer _addRfidTagServiceServer;
       //!< The deleteRfidTag srv server
       ros::ServiceServer _deleteRfidTagServiceServer;
-      //!< The rfid tag list publisher
+      //!< The rfid tag list publisher, for external clients
       ros::Publisher _rfidTagVectorPublisher;
+      //!< True if the rfid tag list changed since it was last published
+      bool _rfidTagListChanged;
+      //!< The rfid tag list change publisher
+      ros::Publisher _rfidTagDeltaPublisher;
+      //!< Number of the last rfid tag list change
+      uint64_t _rfidTagSequence;
       
       
       //!< The addCO2Source srv server
       ros::ServiceServer _addCO2SourceServiceServer;
       //!< The deleteCO2Source srv server
       ros::ServiceServer _deleteCO2SourceServiceServer;
-      //!< The CO2 source list publisher towards the GUI.
+      //!< The CO2 source list publisher, for external clients
       ros::Publisher _CO2SourceVectorPublisher;
+      //!< True if the CO2 source list changed since it was last published
+      bool _CO2SourceListChanged;
+      //!< The CO2 source list change publisher
+      ros::Publisher _CO2SourceDeltaPublisher;
+      //!< Number of the last CO2 source list change
+      uint64_t _CO2SourceSequence;
       
       //!< The addThermalSource srv server
       ros::ServiceServer _addThermalSourceServiceServer;
       //!< The deleteThermalSource srv server
       ros::ServiceServer _deleteThermalSourceServiceServer;
-      //!< The thermal source list publisher
+      //!< The thermal source list publisher, for external clients
       ros::Publisher _thermalSourceVectorPublisher;
+      //!< True if the thermal source list changed since it was last published
+      bool _thermalSourceListChanged;
+      //!< The thermal source list change publisher
+      ros::Publisher _thermalSourceDeltaPublisher;
+      //!< Number of the last thermal source list change
+      uint64_t _thermalSourceSequence;
       
       //!< The addSoundSource srv server
       ros::ServiceServer _addSoundSourceServiceServer;
       //!< The deleteSoundSource srv server
       ros::ServiceServer _deleteSoundSourceServiceServer;
-      //!< The sound source list publisher
+      //!< The sound source list publisher, for external clients
       ros::Publisher _soundSourceVectorPublisher;
+      //!< True if the sound source list changed since it was last published
+      bool _soundSourceListChanged;
+      //!< The sound source list change publisher
+      ros::Publisher _soundSourceDeltaPublisher;
+      //!< Number of the last sound source list change
+      uint64_t _soundSourceSequence;
   };
 }
 
@@ -0,0 +1,174 @@
+/******************************************************************************
+   STDR Simulator - Simple Two DImensional Robot Simulator
+   Copyright (C) 2013 STDR Simulator
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA
+
+   Authors :
+   * Manos Tsardoulias, etsardou@gmail.com
+   * Aris Thallas, aris.thallas@gmail.com
+   * Chris Zalidis, zalidis@gmail.com
+******************************************************************************/
+
+#include <stdr_server/simulation_clock.h>
+
+namespace stdr_server {
+
+  const double SimulationClock::STEP_TIMEOUT = 1.0;
+
+  /**
+  @brief Default constructor. Starts the clock thread.
+  @param n [ros::NodeHandle&] The ROS node handle
+  @return void
+  **/
+  SimulationClock::SimulationClock(ros::NodeHandle& n)
+    :
+      _stepsDone(0)
+  {
+    double timeStep;
+    ros::param::param<double>("~time_step", timeStep, 0.01);
+    ros::param::param<double>("~real_time_factor", _realTimeFactor, 1.0);
+    if ( timeStep <= 0 )
+    {
+      ROS_WARN("Invalid time_step %f, using 0.01", timeStep);
+      timeStep = 0.01;
+    }
+    _timeStep = ros::Duration(timeStep);
+
+    if ( _realTimeFactor > 0 )
+    {
+      ROS_INFO("Simulation clock steps %f s, %f times real time",
+        timeStep, _realTimeFactor);
+    }
+    else
+    {
+      ROS_INFO("Simulation clock steps %f s, as fast as possible", timeStep);
+    }
+
+    ros::NodeHandle clockHandle(n);
+    clockHandle.setCallbackQueue(&_queue);
+
+    _clockPublisher = clockHandle.advertise<rosgraph_msgs::Clock>(
+      "/clock", 1);
+    _stepDoneSubscriber = clockHandle.subscribe(
+      "stdr_server/step_done", 100, &SimulationClock::stepDoneCallback, this);
+
+    _thread = boost::thread(&SimulationClock::spin, this);
+  }
+
+  /**
+  @brief Default destructor. Stops the clock thread.
+  @return void
+  **/
+  SimulationClock::~SimulationClock(void)
+  {
+    _thread.interrupt();
+    _thread.join();
+  }
+
+  /**
+  @brief The clock thread loop
+  @return void
+  **/
+  void SimulationClock::spin(void)
+  {
+    ros::Time time(0);
+    ros::WallTime wallStart = ros::WallTime::now();
+
+    try
+    {
+      while ( ros::ok() )
+      {
+        time += _timeStep;
+        step(time);
+
+        //!< Until a robot manager listens, time runs at real time
+        double factor = _realTimeFactor;
+        if ( factor <= 0 && _stepDoneSubscriber.getNumPublishers() == 0 )
+        {
+          factor = 1.0;
+        }
+
+        if ( factor > 0 )
+        {
+          ros::WallTime wallDue = wallStart +
+            ros::WallDuration(time.toSec() / factor);
+          ros::WallDuration sleep = wallDue - ros::WallTime::now();
+          if ( sleep > ros::WallDuration(0) )
+          {
+            boost::this_thread::sleep( boost::posix_time::microseconds(
+              static_cast<long>(sleep.toSec() * 1e6) ) );
+          }
+          else
+          {
+            //!< Do not try to catch up after a stall
+            wallStart = ros::WallTime::now() -
+              ros::WallDuration(time.toSec() / factor);
+          }
+        }
+        boost::this_thread::interruption_point();
+      }
+    }
+    catch (boost::thread_interrupted&)
+    {
+    }
+  }
+
+  /**
+  @brief Publishes a tick and waits for the robot managers to step
+  @param time [const ros::Time&] The time of the tick
+  @return void
+  **/
+  void SimulationClock::step(const ros::Time& time)
+  {
+    _stepTime = time;
+    _stepsDone = 0;
+
+    //!< Robot managers connecting later join from the next tick
+    const unsigned int managers = _stepDoneSubscriber.getNumPublishers();
+
+    rosgraph_msgs::Clock clock;
+    clock.clock = time;
+    _clockPublisher.publish(clock);
+
+    ros::WallTime timeout = ros::WallTime::now() +
+      ros::WallDuration(STEP_TIMEOUT);
+    while ( _stepsDone < managers && ros::ok() )
+    {
+      _queue.callAvailable( ros::WallDuration(0.001) );
+      if ( ros::WallTime::now() > timeout )
+      {
+        ROS_WARN_THROTTLE(5.0,
+          "Robot managers did not step %f in time, moving on",
+          time.toSec());
+        break;
+      }
+      boost::this_thread::interruption_point();
+    }
+  }
+
+  /**
+  @brief Callback of the robot managers reporting a step done
+  @param msg [const rosgraph_msgs::ClockConstPtr&] The stepped time
+  @return void
+  **/
+  void SimulationClock::stepDoneCallback(
+    const rosgraph_msgs::ClockConstPtr& msg)
+  {
+    //!< Late reports of timed out ticks are ignored
+    if ( msg->clock == _stepTime )
+    {
+      _stepsDone++;
+    }
+  }
+
+}  // namespace stdr_server
@@ -31,6 +31,9 @@ namespace stdr_server {
     :_spawnRobotServer(_nh, "stdr_server/spawn_robot", 
       boost::bind(&Server::spawnRobotCallback, this, _1), false)
       
+    ,_spawnRobotsServer(_nh, "stdr_server/spawn_robots", 
+      boost::bind(&Server::spawnRobotsCallback, this, _1), false)
+      
     ,_registerRobotServer(_nh, "stdr_server/register_robot", 
       boost::bind(&Server::registerRobotCallback, this, _1), false)
     
@@ -47,6 +50,18 @@ namespace stdr_server {
       exit(-1);
     }
     
+    //!< Robots live in one RobotPool nodelet instead of a nodelet each
+    ros::param::param<bool>("~robot_pool", _robotPool, false);
+    
+    //!< A robot that does not register in time fails its spawn action
+    ros::param::param<double>("~robot_register_timeout", 
+      _registerTimeout, 10.0);
+    
+    //!< With simulated time the server is the /clock master
+    if (ros::Time::isSimTime()) {
+      _clock.reset(new SimulationClock(_nh));
+    }
+    
     if (argc == 2) {
       std::string fname(argv[1]);
       _mapServer.reset(new MapServer(fname));
@@ -62,34 +77,59 @@ namespace stdr_server {
       "/stdr_server/load_static_map_external", 
         &Server::loadExternalMapCallback, this);
     
-    while (!ros::service::waitForService("robot_manager/load_nodelet", 
+    if (_robotPool) {
+      while (!ros::service::waitForService("robot_pool/load_robots", 
+          ros::Duration(.1)) && ros::ok()) 
+      {
+        ROS_WARN("Trying to register to robot_pool/load_robots...");
+      }
+      
+      _loadPooledRobotsClient = _nh.serviceClient<stdr_msgs::LoadPooledRobots>
+        ("robot_pool/load_robots", true);
+      
+      while (!ros::service::waitForService("robot_pool/unload_robot", 
         ros::Duration(.1)) && ros::ok()) 
-    {
-      ROS_WARN("Trying to register to robot_manager/load_nodelet...");
+      {
+        ROS_WARN("Trying to register to robot_pool/unload_robot...");
+      }
+      
+      _unloadRobotClient = 
+        _nh.serviceClient<nodelet::NodeletUnload>("robot_pool/unload_robot");
     }
-    
-    _spawnRobotClient = _nh.serviceClient<nodelet::NodeletLoad>
-      ("robot_manager/load_nodelet", true);
-    
-    while (!ros::service::waitForService("robot_manager/unload_nodelet", 
-      ros::Duration(.1)) && ros::ok()) 
-    {
-      ROS_WARN("Trying to register to robot_manager/unload_nodelet...");
+    else {
+      while (!ros::service::waitForService("robot_manager/load_nodelet", 
+          ros::Duration(.1)) && ros::ok()) 
+      {
+        ROS_WARN("Trying to register to robot_manager/load_nodelet...");
+      }
+      
+      _spawnRobotClient = _nh.serviceClient<nodelet::NodeletLoad>
+        ("robot_manager/load_nodelet", true);
+      
+      while (!ros::service::waitForService("robot_manager/unload_nodelet", 
+        ros::Duration(.1)) && ros::ok()) 
+      {
+        ROS_WARN("Trying to register to robot_manager/unload_nodelet...");
+      }
+      
+      _unloadRobotClient = 
+        _nh.serviceClient<nodelet::NodeletUnload>("robot_manager/unload_nodelet");
     }
     
-    _unloadRobotClient = 
-      _nh.serviceClient<nodelet::NodeletUnload>("robot_manager/unload_nodelet");
-    
     _robotsPublisher = 
       _nh.advertise<stdr_msgs::RobotIndexedVectorMsg>
         ("stdr_server/active_robots", 10, true);
     
-    //!< Rviz publisher
+    //!< Rviz publisher, every new subscriber gets all sources as markers
     _sourceVectorPublisherRviz = _nh.advertise<visualization_msgs::MarkerArray>(
-      "stdr_server/sources_visualization_markers", 1, true);
+      "stdr_server/sources_visualization_markers", SOURCE_DELTA_QUEUE, 
+      boost::bind(&Server::sendSourceMarkers, this, _1));
       
     //!< Rfid tags    
         
+    _rfidTagSequence = 0;
+    _rfidTagListChanged = false;
+    
     _addRfidTagServiceServer = _nh.advertiseService("stdr_server/add_rfid_tag",
       &Server::addRfidTagCallback, this);
       
@@ -97,11 +137,22 @@ namespace stdr_server {
       _nh.advertiseService("stdr_server/delete_rfid_tag",
       &Server::deleteRfidTagCallback, this);
       
+    //!< The whole list, for external clients. Every new subscriber gets
+    //!< it, the others when it changes.
     _rfidTagVectorPublisher = _nh.advertise<stdr_msgs::RfidTagVector>(
-      "stdr_server/rfid_list", 1, true);
+      "stdr_server/rfid_list", 1, 
+      boost::bind(&Server::sendRfidTagList, this, _1));
+      
+    //!< Changes only, every new subscriber gets a snapshot first
+    _rfidTagDeltaPublisher = _nh.advertise<stdr_msgs::RfidTagDelta>(
+      "stdr_server/rfid_delta", SOURCE_DELTA_QUEUE, 
+      boost::bind(&Server::sendRfidTagSnapshot, this, _1));
       
     //!< CO2 sources    
         
+    _CO2SourceSequence = 0;
+    _CO2SourceListChanged = false;
+    
     _addCO2SourceServiceServer = _nh.advertiseService(
       "stdr_server/add_co2_source",
       &Server::addCO2SourceCallback, this);
@@ -110,11 +161,22 @@ namespace stdr_server {
       _nh.advertiseService("stdr_server/delete_co2_source",
       &Server::deleteCO2SourceCallback, this);
       
+    //!< The whole list, for external clients. Every new subscriber gets
+    //!< it, the others when it changes.
     _CO2SourceVectorPublisher = _nh.advertise<stdr_msgs::CO2SourceVector>(
-      "stdr_server/co2_sources_list", 1, true);
+      "stdr_server/co2_sources_list", 1, 
+      boost::bind(&Server::sendCO2SourceList, this, _1));
+      
+    //!< Changes only, every new subscriber gets a snapshot first
+    _CO2SourceDeltaPublisher = _nh.advertise<stdr_msgs::CO2SourceDelta>(
+      "stdr_server/co2_sources_delta", SOURCE_DELTA_QUEUE, 
+      boost::bind(&Server::sendCO2SourceSnapshot, this, _1));
       
     //!< Thermal sources    
         
+    _thermalSourceSequence = 0;
+    _thermalSourceListChanged = false;
+    
     _addThermalSourceServiceServer = _nh.advertiseService(
       "stdr_server/add_thermal_source",
       &Server::addThermalSourceCallback, this);
@@ -123,12 +185,23 @@ namespace stdr_server {
       _nh.advertiseService("stdr_server/delete_thermal_source",
       &Server::deleteThermalSourceCallback, this);
       
+    //!< The whole list, for external clients. Every new subscriber gets
+    //!< it, the others when it changes.
     _thermalSourceVectorPublisher = 
       _nh.advertise<stdr_msgs::ThermalSourceVector>(
-      "stdr_server/thermal_sources_list", 1, true);
-    
+      "stdr_server/thermal_sources_list", 1, 
+      boost::bind(&Server::sendThermalSourceList, this, _1));
+      
+    //!< Changes only, every new subscriber gets a snapshot first
+    _thermalSourceDeltaPublisher = _nh.advertise<stdr_msgs::ThermalSourceDelta>(
+      "stdr_server/thermal_sources_delta", SOURCE_DELTA_QUEUE, 
+      boost::bind(&Server::sendThermalSourceSnapshot, this, _1));
+      
     //!< Sound sources    
         
+    _soundSourceSequence = 0;
+    _soundSourceListChanged = false;
+    
     _addSoundSourceServiceServer = _nh.advertiseService(
       "stdr_server/add_sound_source",
       &Server::addSoundSourceCallback, this);
@@ -137,8 +210,22 @@ namespace stdr_server {
       _nh.advertiseService("stdr_server/delete_sound_source",
       &Server::deleteSoundSourceCallback, this);
       
+    //!< The whole list, for external clients. Every new subscriber gets
+    //!< it, the others when it changes.
     _soundSourceVectorPublisher = _nh.advertise<stdr_msgs::SoundSourceVector>(
-      "stdr_server/sound_sources_list", 1, true);
+      "stdr_server/sound_sources_list", 1, 
+      boost::bind(&Server::sendSoundSourceList, this, _1));
+      
+    //!< Changes only, every new subscriber gets a snapshot first
+    _soundSourceDeltaPublisher = _nh.advertise<stdr_msgs::SoundSourceDelta>(
+      "stdr_server/sound_sources_delta", SOURCE_DELTA_QUEUE, 
+      boost::bind(&Server::sendSoundSourceSnapshot, this, _1));
+      
+    //!< The changes of many add or delete calls go out in one list
+    double sourceListPeriod;
+    ros::param::param<double>("~source_list_period", sourceListPeriod, 0.5);
+    _sourceListTimer = _nh.createTimer(ros::Duration(sourceListPeriod), 
+      &Server::publishSourceLists, this);
   }
   
   /**
@@ -161,22 +248,18 @@ namespace stdr_server {
     _rfidTagMap.insert(std::pair<std::string, stdr_msgs::RfidTag>(
       new_rfid.tag_id, new_rfid));
     
-    //!< Publish the new RFID tag list
-    stdr_msgs::RfidTagVector rfidTagList;
-    visualization_msgs::MarkerArray RFIDMarkerArray;
+    //!< Publish the change to the sensors, our custom GUI and Rviz
+    stdr_msgs::RfidTagDelta delta;
+    delta.sequence = ++_rfidTagSequence;
+    delta.snapshot = false;
+    delta.added.push_back(new_rfid);
+    _rfidTagDeltaPublisher.publish(delta);
+    _rfidTagListChanged = true;
     
-    for(RfidTagMapIt it = _rfidTagMap.begin() ; it != _rfidTagMap.end() ; it++)
-    {
-      rfidTagList.rfid_tags.push_back(it->second);
-      RFIDMarkerArray.markers.push_back(toMarker(it->second,true)); 
-    }
-    _rfidTagVectorPublisher.publish(rfidTagList);
-
+    visualization_msgs::MarkerArray RFIDMarkerArray;
+    RFIDMarkerArray.markers.push_back(toMarker(new_rfid,true));
     _sourceVectorPublisherRviz.publish(RFIDMarkerArray);
-
-    //!< Republish existing sources as markers
-    republishSources();
-
+    
     //!< Return success
     res.success = true;
     return true;
@@ -202,22 +285,17 @@ namespace stdr_server {
     _CO2SourceMap.insert(std::pair<std::string, stdr_msgs::CO2Source>(
       new_source.id, new_source));
     
-    //!< Publish the new source list to both our custom GUI and Rviz.
-    stdr_msgs::CO2SourceVector CO2SourceList;
-    visualization_msgs::MarkerArray C02MarkerArray;
-    
-    for(CO2SourceMapIt it = _CO2SourceMap.begin() 
-      ; it != _CO2SourceMap.end() ; it++)
-    {
-      CO2SourceList.co2_sources.push_back(it->second);
-      C02MarkerArray.markers.push_back(toMarker(it->second,true));    
-    }
-    _CO2SourceVectorPublisher.publish(CO2SourceList);
-    _sourceVectorPublisherRviz.publish(C02MarkerArray); 
+    //!< Publish the change to the sensors, our custom GUI and Rviz
+    stdr_msgs::CO2SourceDelta delta;
+    delta.sequence = ++_CO2SourceSequence;
+    delta.snapshot = false;
+    delta.added.push_back(new_source);
+    _CO2SourceDeltaPublisher.publish(delta);
+    _CO2SourceListChanged = true;
     
-
-    //!< Republish existing sources as markers
-    republishSources();
+    visualization_msgs::MarkerArray C02MarkerArray;
+    C02MarkerArray.markers.push_back(toMarker(new_source,true));
+    _sourceVectorPublisherRviz.publish(C02MarkerArray);
     
     //!< Return success
     res.success = true;
@@ -244,23 +322,18 @@ namespace stdr_server {
     _thermalSourceMap.insert(std::pair<std::string, stdr_msgs::ThermalSource>(
       new_source.id, new_source));
     
-    //!< Publish the new source list
-    stdr_msgs::ThermalSourceVector thermalSourceList;
-    visualization_msgs::MarkerArray thermalMarkerArray;
+    //!< Publish the change to the sensors, our custom GUI and Rviz
+    stdr_msgs::ThermalSourceDelta delta;
+    delta.sequence = ++_thermalSourceSequence;
+    delta.snapshot = false;
+    delta.added.push_back(new_source);
+    _thermalSourceDeltaPublisher.publish(delta);
+    _thermalSourceListChanged = true;
     
-    for(ThermalSourceMapIt it = _thermalSourceMap.begin() 
-      ; it != _thermalSourceMap.end() ; it++)
-    {
-      thermalSourceList.thermal_sources.push_back(it->second);
-      thermalMarkerArray.markers.push_back(toMarker(it->second,true));
-    }
-    _thermalSourceVectorPublisher.publish(thermalSourceList);
+    visualization_msgs::MarkerArray thermalMarkerArray;
+    thermalMarkerArray.markers.push_back(toMarker(new_source,true));
     _sourceVectorPublisherRviz.publish(thermalMarkerArray);
     
-    
-    //!< Republish existing sources as markers
-    republishSources();
-    
     //!< Return success
     res.success = true;
     return true;
@@ -286,22 +359,17 @@ namespace stdr_server {
     _soundSourceMap.insert(std::pair<std::string, stdr_msgs::SoundSource>(
       new_source.id, new_source));
     
-    //!< Publish the new source list
-    stdr_msgs::SoundSourceVector soundSourceList;
-    visualization_msgs::MarkerArray soundMarkerArray;
+    //!< Publish the change to the sensors, our custom GUI and Rviz
+    stdr_msgs::SoundSourceDelta delta;
+    delta.sequence = ++_soundSourceSequence;
+    delta.snapshot = false;
+    delta.added.push_back(new_source);
+    _soundSourceDeltaPublisher.publish(delta);
+    _soundSourceListChanged = true;
     
-    for(SoundSourceMapIt it = _soundSourceMap.begin() 
-      ; it != _soundSourceMap.end() ; it++)
-    {
-      soundSourceList.sound_sources.push_back(it->second);
-      soundMarkerArray.markers.push_back(toMarker(it->second,true));
-    }
-    _soundSourceVectorPublisher.publish(soundSourceList); 
+    visualization_msgs::MarkerArray soundMarkerArray;
+    soundMarkerArray.markers.push_back(toMarker(new_source,true));
     _sourceVectorPublisherRviz.publish(soundMarkerArray);
-
-    
-    //!< Republish existing sources as markers
-    republishSources();
     
     //!< Return success
     res.success = true;
@@ -326,17 +394,13 @@ namespace stdr_server {
 
       _rfidTagMap.erase(name);
       
-      //!< Publish the new RFID tag list
-      stdr_msgs::RfidTagVector rfidTagList;
-      
-      for(RfidTagMapIt it = _rfidTagMap.begin() ; 
-        it != _rfidTagMap.end() ; it++)
-      {
-        rfidTagList.rfid_tags.push_back(it->second);
-      }
-      _rfidTagVectorPublisher.publish(rfidTagList);        
-      //!< Republish existing sources to RVIZ.
-      republishSources();         
+      //!< Publish the change
+      stdr_msgs::RfidTagDelta delta;
+      delta.sequence = ++_rfidTagSequence;
+      delta.snapshot = false;
+      delta.removed.push_back(name);
+      _rfidTagDeltaPublisher.publish(delta);
+      _rfidTagListChanged = true;
     }
     else  //!< Tag does not exist
     {
@@ -363,19 +427,14 @@ namespace stdr_server {
 
       _CO2SourceMap.erase(name);
       
-      //!< Publish the new sources list
-      stdr_msgs::CO2SourceVector CO2SourceList;
-      
-      for(CO2SourceMapIt it = _CO2SourceMap.begin() ; 
-        it != _CO2SourceMap.end() ; it++)
-      {
-        CO2SourceList.co2_sources.push_back(it->second);
-      }
-      _CO2SourceVectorPublisher.publish(CO2SourceList);
-      //!< Republish existing sources to RVIZ.
-      republishSources();        
+      //!< Publish the change
+      stdr_msgs::CO2SourceDelta delta;
+      delta.sequence = ++_CO2SourceSequence;
+      delta.snapshot = false;
+      delta.removed.push_back(name);
+      _CO2SourceDeltaPublisher.publish(delta);
+      _CO2SourceListChanged = true;
     }
-
     else  //!< Source does not exist
     {
       return false;
@@ -401,17 +460,13 @@ namespace stdr_server {
 
       _thermalSourceMap.erase(name);
       
-      //!< Publish the new sources list
-      stdr_msgs::ThermalSourceVector thermalSourceList;
-      
-      for(ThermalSourceMapIt it = _thermalSourceMap.begin() ; 
-        it != _thermalSourceMap.end() ; it++)
-      {
-        thermalSourceList.thermal_sources.push_back(it->second);
-      }
-      _thermalSourceVectorPublisher.publish(thermalSourceList);
-      //!< Republish existing sources to RVIZ.
-      republishSources();          
+      //!< Publish the change
+      stdr_msgs::ThermalSourceDelta delta;
+      delta.sequence = ++_thermalSourceSequence;
+      delta.snapshot = false;
+      delta.removed.push_back(name);
+      _thermalSourceDeltaPublisher.publish(delta);
+      _thermalSourceListChanged = true;
     }
     else  //!< Source does not exist
     {
@@ -438,19 +493,13 @@ namespace stdr_server {
 
       _soundSourceMap.erase(name);
       
-      //!< Publish the new sources list
-      stdr_msgs::SoundSourceVector soundSourceList;
-
-      
-      for(SoundSourceMapIt it = _soundSourceMap.begin() ; 
-        it != _soundSourceMap.end() ; it++)
-      {
-        soundSourceList.sound_sources.push_back(it->second);
-        
-      }
-      _soundSourceVectorPublisher.publish(soundSourceList);
-      //!< Republish existing sources to RVIZ.
-      republishSources();   
+      //!< Publish the change
+      stdr_msgs::SoundSourceDelta delta;
+      delta.sequence = ++_soundSourceSequence;
+      delta.snapshot = false;
+      delta.removed.push_back(name);
+      _soundSourceDeltaPublisher.publish(delta);
+      _soundSourceListChanged = true;
     }
     else  //!< Source does not exist
     {
@@ -523,19 +572,144 @@ namespace stdr_server {
     if (addNewRobot(goal->description, &result)) {
       _spawnRobotServer.setSucceeded(result);
       
-      //!< publish to active_robots topic
-      stdr_msgs::RobotIndexedVectorMsg msg;
-      for (RobotMap::iterator it = _robotMap.begin(); 
-        it != _robotMap.end(); ++it) 
+      publishActiveRobots();
+      return;
+    }
+
+    _spawnRobotServer.setAborted(result);
+  }
+
+  /**
+  @brief Action callback for spawning many robots at once. The nodelets \
+  are loaded back to back and register meanwhile, active_robots is \
+  published once all of them are registered.
+  @param goal [const stdr_msgs::SpawnRobotsGoalConstPtr&] The action goal
+  @return void
+  **/
+  void Server::spawnRobotsCallback(
+    const stdr_msgs::SpawnRobotsGoalConstPtr& goal) 
+  {
+    stdr_msgs::SpawnRobotsResult result;
+    
+    std::string f_id;
+    for (unsigned int i = 0; i < goal->descriptions.size(); i++)
+    {
+      if(hasDublicateFrameIds(goal->descriptions[i], f_id))
+      {
+        result.message = std::string("Double frame_id :") + f_id;
+        _spawnRobotsServer.setAborted(result);
+        return;
+      }
+    }
+    
+    //!< The pool loads all robots in one call, they need not register
+    if (_robotPool) {
+      std::vector<stdr_msgs::RobotIndexedMsg> robots(
+        goal->descriptions.size());
+      for (unsigned int i = 0; i < robots.size(); i++)
       {
-        msg.robots.push_back( it->second );
+        robots[i].robot = goal->descriptions[i];
+        if(robots[i].robot.kinematicModel.type == "")
+          robots[i].robot.kinematicModel.type = "ideal";
       }
       
-      _robotsPublisher.publish(msg);
+      if (loadPooledRobots(&robots)) {
+        result.indexedDescriptions = robots;
+        publishActiveRobots();
+        _spawnRobotsServer.setSucceeded(result);
+        return;
+      }
+      
+      result.message = "Could not load the robots in robot_pool";
+      _spawnRobotsServer.setAborted(result);
       return;
     }
-
-    _spawnRobotServer.setAborted();
+    
+    for (unsigned int i = 0; i < goal->descriptions.size(); i++)
+    {
+      stdr_msgs::RobotIndexedMsg namedRobot;
+      namedRobot.robot = goal->descriptions[i];
+      if(namedRobot.robot.kinematicModel.type == "")
+        namedRobot.robot.kinematicModel.type = "ideal";
+      
+      {
+        boost::unique_lock<boost::mutex> lock(_mut);
+        namedRobot.name = "robot" + boost::lexical_cast<std::string>(_id++);
+        _robotMap.insert( std::make_pair(namedRobot.name, namedRobot) );
+        _unregisteredRobots.insert(namedRobot.name);
+      }
+      
+      nodelet::NodeletLoad srv;
+      srv.request.name = namedRobot.name;
+      srv.request.type = "stdr_robot/Robot";
+      
+      //!< The lock is not held, the loaded robots register meanwhile
+      if (_spawnRobotClient.call(srv) && srv.response.success) {
+        result.indexedDescriptions.push_back(namedRobot);
+        continue;
+      }
+      
+      boost::unique_lock<boost::mutex> lock(_mut);
+      _robotMap.erase(namedRobot.name);
+      _unregisteredRobots.erase(namedRobot.name);
+      result.message = "Could not load " + namedRobot.name;
+      break;
+    }
+    
+    std::vector<std::string> lateRobots;
+    {
+      //!< wait until all loaded robots call RobotRegisterAction
+      const boost::system_time deadline = getRegisterDeadline();
+      boost::unique_lock<boost::mutex> lock(_mut);
+      for (unsigned int i = 0; i < result.indexedDescriptions.size(); i++)
+      {
+        while (_unregisteredRobots.count(
+          result.indexedDescriptions[i].name) > 0)
+        {
+          if (!cond.timed_wait(lock, deadline)) {
+            break;
+          }
+        }
+      }
+      
+      //!< Robots still unregistered are dropped from the result
+      std::vector<stdr_msgs::RobotIndexedMsg> registered;
+      for (unsigned int i = 0; i < result.indexedDescriptions.size(); i++)
+      {
+        const std::string& name = result.indexedDescriptions[i].name;
+        if (_unregisteredRobots.count(name) > 0) {
+          _robotMap.erase(name);
+          _unregisteredRobots.erase(name);
+          lateRobots.push_back(name);
+        }
+        else {
+          registered.push_back(result.indexedDescriptions[i]);
+        }
+      }
+      result.indexedDescriptions = registered;
+    }
+    
+    if (!lateRobots.empty()) {
+      if (!result.message.empty()) {
+        result.message += ". ";
+      }
+      result.message += "Robots did not register in time:";
+      for (unsigned int i = 0; i < lateRobots.size(); i++)
+      {
+        unloadRobot(lateRobots[i]);
+        result.message += " " + lateRobots[i];
+      }
+      ROS_WARN("%s", result.message.c_str());
+    }
+    
+    publishActiveRobots();
+    
+    if (result.message.empty()) {
+      _spawnRobotsServer.setSucceeded(result);
+      return;
+    }
+    
+    _spawnRobotsServer.setAborted(result);
   }
 
   /**
@@ -551,14 +725,7 @@ namespace stdr_server {
     
     if (deleteRobot(goal->name, &result)) {
       
-      // publish to active_robots topic
-      stdr_msgs::RobotIndexedVectorMsg msg;
-      for (RobotMap::iterator it = _robotMap.begin(); 
-        it != _robotMap.end(); ++it) 
-      {
-        msg.robots.push_back( it->second );
-      }
-      _robotsPublisher.publish(msg);
+      publishActiveRobots();
       _deleteRobotServer.setSucceeded(result);
       return;
     }
@@ -568,19 +735,27 @@ namespace stdr_server {
   
   /**
   @brief Action callback for robot registering
-  @param goal [const stdr_msgs::RegisterRobotGoalConstPtr&] The action goal
+  @param goal [RegisterRobotServer::GoalHandle] The action goal
   @return void
   **/
-  void Server::registerRobotCallback(
-    const stdr_msgs::RegisterRobotGoalConstPtr& goal) 
+  void Server::registerRobotCallback(RegisterRobotServer::GoalHandle goal) 
   {
     
     boost::unique_lock<boost::mutex> lock(_mut);
     stdr_msgs::RegisterRobotResult result;
-    result.description = _robotMap[goal->name].robot;
-    _registerRobotServer.setSucceeded(result);
-    //!< notify spawn action, to reply to spawnner
-    cond.notify_one();
+    goal.setAccepted();
+    
+    RobotMap::iterator it = _robotMap.find(goal.getGoal()->name);
+    if (it == _robotMap.end()) {
+      goal.setAborted(result);
+      return;
+    }
+    
+    result.description = it->second.robot;
+    goal.setSucceeded(result);
+    //!< notify spawn actions, to reply to spawnners
+    _unregisteredRobots.erase(it->first);
+    cond.notify_all();
   }
 
   /**
@@ -590,10 +765,29 @@ namespace stdr_server {
   void Server::activateActionServers(void) 
   {
     _spawnRobotServer.start();
+    _spawnRobotsServer.start();
     _registerRobotServer.start();
     _deleteRobotServer.start();
   }
 
+  /**
+  @brief Publishes all robots to the active_robots topic
+  @return void
+  **/
+  void Server::publishActiveRobots(void) 
+  {
+    boost::unique_lock<boost::mutex> lock(_mut);
+    
+    stdr_msgs::RobotIndexedVectorMsg msg;
+    for (RobotMap::iterator it = _robotMap.begin(); 
+      it != _robotMap.end(); ++it) 
+    {
+      msg.robots.push_back( it->second );
+    }
+    
+    _robotsPublisher.publish(msg);
+  }
+
   /**
   @brief Adds new robot to simulator
   @param description [stdr_msgs::RobotMsg] The new robot description
@@ -612,27 +806,94 @@ namespace stdr_server {
 
     namedRobot.robot = description;
     
+    if (_robotPool) {
+      std::vector<stdr_msgs::RobotIndexedMsg> robots(1, namedRobot);
+      if (!loadPooledRobots(&robots)) {
+        return false;
+      }
+      
+      result->indexedDescription = robots[0];
+      return true;
+    }
+    
+    boost::unique_lock<boost::mutex> lock(_mut);
+    
     namedRobot.name = "robot" + boost::lexical_cast<std::string>(_id++);
     
     _robotMap.insert( std::make_pair(namedRobot.name, namedRobot) );
+    _unregisteredRobots.insert(namedRobot.name);
     
     nodelet::NodeletLoad srv;
     srv.request.name = namedRobot.name;
     srv.request.type = "stdr_robot/Robot";
-    
-    boost::unique_lock<boost::mutex> lock(_mut);
       
-    if (_spawnRobotClient.call(srv)) {
+    if (_spawnRobotClient.call(srv) && srv.response.success) {
       //!< wait until robot calls RobotRegisterAction
-      cond.wait(lock);
+      const boost::system_time deadline = getRegisterDeadline();
+      while (_unregisteredRobots.count(namedRobot.name) > 0) {
+        if (!cond.timed_wait(lock, deadline)) {
+          break;
+        }
+      }
       
-      result->indexedDescription = namedRobot;
+      if (_unregisteredRobots.count(namedRobot.name) == 0) {
+        result->indexedDescription = namedRobot;
+        
+        lock.unlock();
+        return true;
+      }
       
+      _robotMap.erase(namedRobot.name);
+      _unregisteredRobots.erase(namedRobot.name);
       lock.unlock();
-      return true;
+      
+      unloadRobot(namedRobot.name);
+      result->message = namedRobot.name + " did not register in time";
+      ROS_WARN("%s", result->message.c_str());
+      return false;
     }
     
+    _robotMap.erase(namedRobot.name);
+    _unregisteredRobots.erase(namedRobot.name);
     lock.unlock();
+    result->message = "Could not load " + namedRobot.name;
+    return false;
+  }
+
+  /**
+  @brief Names the robots and hands them to the robot pool in one call
+  @param robots [std::vector<stdr_msgs::RobotIndexedMsg>*] The robots, named on return
+  @return bool : True if the pool loaded all of them
+  **/
+  bool Server::loadPooledRobots(
+    std::vector<stdr_msgs::RobotIndexedMsg>* robots) 
+  {
+    
+    {
+      boost::unique_lock<boost::mutex> lock(_mut);
+      for (unsigned int i = 0; i < robots->size(); i++)
+      {
+        stdr_msgs::RobotIndexedMsg& namedRobot = (*robots)[i];
+        namedRobot.name = "robot" + boost::lexical_cast<std::string>(_id++);
+        _robotMap.insert( std::make_pair(namedRobot.name, namedRobot) );
+      }
+    }
+    
+    stdr_msgs::LoadPooledRobots srv;
+    srv.request.robots = *robots;
+    
+    if (_loadPooledRobotsClient.call(srv) && srv.response.success) {
+      return true;
+    }
+    
+    ROS_WARN("Could not load robots in robot_pool. %s", 
+      srv.response.message.c_str());
+    
+    boost::unique_lock<boost::mutex> lock(_mut);
+    for (unsigned int i = 0; i < robots->size(); i++)
+    {
+      _robotMap.erase((*robots)[i].name);
+    }
     return false;
   }
 
@@ -646,26 +907,19 @@ namespace stdr_server {
     std::string name, 
     stdr_msgs::DeleteRobotResult* result) 
   {
+    //!< Held until the robot is erased, spawn and register callbacks
+    //!< change the map meanwhile
+    boost::unique_lock<boost::mutex> lock(_mut);
     
     RobotMap::iterator it = _robotMap.find(name);
     
     if (it != _robotMap.end()) {
       
-      nodelet::NodeletUnload srv;
-      srv.request.name =  name;
-      
-      if (_unloadRobotClient.call(srv)) {
-        
-        if (srv.response.success) {
-          _robotMap.erase(it);
-        }
-        
-        result->success = srv.response.success;
-        return srv.response.success;
+      result->success = unloadRobot(name);
+      if (result->success) {
+        _robotMap.erase(it);
       }
-      
-      result->success = false;
-      return false;
+      return result->success;
     }
     
     ROS_WARN("Requested to delete robot, with name %s does not exist.", 
@@ -675,6 +929,35 @@ namespace stdr_server {
     return false;
   }
   
+  /**
+  @brief Unloads a robot nodelet, or a robot of the robot pool
+  @param name [const std::string&] The robot frame_id
+  @return bool : True if the robot was unloaded
+  **/
+  bool Server::unloadRobot(const std::string& name) 
+  {
+    nodelet::NodeletUnload srv;
+    srv.request.name = name;
+    
+    if (_unloadRobotClient.call(srv) && srv.response.success) {
+      return true;
+    }
+    
+    ROS_WARN("Could not unload robot %s", name.c_str());
+    return false;
+  }
+  
+  /**
+  @brief Returns the time until which a spawn action waits for its \
+  robots to register
+  @return boost::system_time
+  **/
+  boost::system_time Server::getRegisterDeadline(void) const
+  {
+    return boost::get_system_time() + boost::posix_time::milliseconds(
+      static_cast<long>(_registerTimeout * 1000));
+  }
+  
   bool Server::hasDublicateFrameIds(const stdr_msgs::RobotMsg& robot,
     std::string &f_id)
   {
@@ -838,13 +1121,142 @@ namespace stdr_server {
     return marker;
   }
   
-  void Server::republishSources()
+  /**
+  @brief Returns the whole rfid tag list
+  **/
+  stdr_msgs::RfidTagVector Server::getRfidTagList(void)
+  {
+    stdr_msgs::RfidTagVector list;
+    list.rfid_tags.reserve(_rfidTagMap.size());
+    for(RfidTagMapIt it = _rfidTagMap.begin() 
+      ; it != _rfidTagMap.end() ; it++)
+    {
+      list.rfid_tags.push_back(it->second);
+    }
+    return list;
+  }
+  
+  /**
+  @brief Sends the whole rfid tag list to a new list subscriber
+  **/
+  void Server::sendRfidTagList(const ros::SingleSubscriberPublisher& pub)
+  {
+    pub.publish(getRfidTagList());
+  }
+  
+  /**
+  @brief Returns the whole CO2 source list
+  **/
+  stdr_msgs::CO2SourceVector Server::getCO2SourceList(void)
+  {
+    stdr_msgs::CO2SourceVector list;
+    list.co2_sources.reserve(_CO2SourceMap.size());
+    for(CO2SourceMapIt it = _CO2SourceMap.begin() 
+      ; it != _CO2SourceMap.end() ; it++)
+    {
+      list.co2_sources.push_back(it->second);
+    }
+    return list;
+  }
+  
+  /**
+  @brief Sends the whole CO2 source list to a new list subscriber
+  **/
+  void Server::sendCO2SourceList(const ros::SingleSubscriberPublisher& pub)
+  {
+    pub.publish(getCO2SourceList());
+  }
+  
+  /**
+  @brief Returns the whole thermal source list
+  **/
+  stdr_msgs::ThermalSourceVector Server::getThermalSourceList(void)
+  {
+    stdr_msgs::ThermalSourceVector list;
+    list.thermal_sources.reserve(_thermalSourceMap.size());
+    for(ThermalSourceMapIt it = _thermalSourceMap.begin() 
+      ; it != _thermalSourceMap.end() ; it++)
+    {
+      list.thermal_sources.push_back(it->second);
+    }
+    return list;
+  }
+  
+  /**
+  @brief Sends the whole thermal source list to a new list subscriber
+  **/
+  void Server::sendThermalSourceList(const ros::SingleSubscriberPublisher& pub)
+  {
+    pub.publish(getThermalSourceList());
+  }
+  
+  /**
+  @brief Returns the whole sound source list
+  **/
+  stdr_msgs::SoundSourceVector Server::getSoundSourceList(void)
+  {
+    stdr_msgs::SoundSourceVector list;
+    list.sound_sources.reserve(_soundSourceMap.size());
+    for(SoundSourceMapIt it = _soundSourceMap.begin() 
+      ; it != _soundSourceMap.end() ; it++)
+    {
+      list.sound_sources.push_back(it->second);
+    }
+    return list;
+  }
+  
+  /**
+  @brief Sends the whole sound source list to a new list subscriber
+  **/
+  void Server::sendSoundSourceList(const ros::SingleSubscriberPublisher& pub)
+  {
+    pub.publish(getSoundSourceList());
+  }
+  
+  /**
+  @brief Republishes the changed source lists to their subscribers
+  **/
+  void Server::publishSourceLists(const ros::TimerEvent&)
+  {
+    if(_rfidTagListChanged && 
+      _rfidTagVectorPublisher.getNumSubscribers() > 0)
+    {
+      _rfidTagVectorPublisher.publish(getRfidTagList());
+    }
+    _rfidTagListChanged = false;
+    
+    if(_CO2SourceListChanged && 
+      _CO2SourceVectorPublisher.getNumSubscribers() > 0)
+    {
+      _CO2SourceVectorPublisher.publish(getCO2SourceList());
+    }
+    _CO2SourceListChanged = false;
+    
+    if(_thermalSourceListChanged && 
+      _thermalSourceVectorPublisher.getNumSubscribers() > 0)
+    {
+      _thermalSourceVectorPublisher.publish(getThermalSourceList());
+    }
+    _thermalSourceListChanged = false;
+    
+    if(_soundSourceListChanged && 
+      _soundSourceVectorPublisher.getNumSubscribers() > 0)
+    {
+      _soundSourceVectorPublisher.publish(getSoundSourceList());
+    }
+    _soundSourceListChanged = false;
+  }
+  
+  /**
+  @brief Sends all existing sources as markers to a new Rviz subscriber
+  **/
+  void Server::sendSourceMarkers(const ros::SingleSubscriberPublisher& pub)
   {
     visualization_msgs::MarkerArray ma;
-	for(SoundSourceMapIt it = _soundSourceMap.begin() 
+    for(SoundSourceMapIt it = _soundSourceMap.begin() 
       ; it != _soundSourceMap.end() ; it++)
     {
-        ma.markers.push_back(toMarker(it->second,true));
+      ma.markers.push_back(toMarker(it->second,true));
     }
     for(CO2SourceMapIt it = _CO2SourceMap.begin() 
       ; it != _CO2SourceMap.end() ; it++)
@@ -860,8 +1272,77 @@ namespace stdr_server {
     {
       ma.markers.push_back(toMarker(it->second,true)); 
     }
-    _sourceVectorPublisherRviz.publish(ma);  
-  }  
+    pub.publish(ma);
+  }
+  
+  /**
+  @brief Sends the rfid tag list as a snapshot to a new subscriber
+  **/
+  void Server::sendRfidTagSnapshot(const ros::SingleSubscriberPublisher& pub)
+  {
+    stdr_msgs::RfidTagDelta snapshot;
+    snapshot.sequence = _rfidTagSequence;
+    snapshot.snapshot = true;
+    snapshot.added.reserve(_rfidTagMap.size());
+    for(RfidTagMapIt it = _rfidTagMap.begin() ; it != _rfidTagMap.end() ; it++)
+    {
+      snapshot.added.push_back(it->second);
+    }
+    pub.publish(snapshot);
+  }
+  
+  /**
+  @brief Sends the CO2 source list as a snapshot to a new subscriber
+  **/
+  void Server::sendCO2SourceSnapshot(const ros::SingleSubscriberPublisher& pub)
+  {
+    stdr_msgs::CO2SourceDelta snapshot;
+    snapshot.sequence = _CO2SourceSequence;
+    snapshot.snapshot = true;
+    snapshot.added.reserve(_CO2SourceMap.size());
+    for(CO2SourceMapIt it = _CO2SourceMap.begin() 
+      ; it != _CO2SourceMap.end() ; it++)
+    {
+      snapshot.added.push_back(it->second);
+    }
+    pub.publish(snapshot);
+  }
+  
+  /**
+  @brief Sends the thermal source list as a snapshot to a new subscriber
+  **/
+  void Server::sendThermalSourceSnapshot(
+    const ros::SingleSubscriberPublisher& pub)
+  {
+    stdr_msgs::ThermalSourceDelta snapshot;
+    snapshot.sequence = _thermalSourceSequence;
+    snapshot.snapshot = true;
+    snapshot.added.reserve(_thermalSourceMap.size());
+    for(ThermalSourceMapIt it = _thermalSourceMap.begin() 
+      ; it != _thermalSourceMap.end() ; it++)
+    {
+      snapshot.added.push_back(it->second);
+    }
+    pub.publish(snapshot);
+  }
+  
+  /**
+  @brief Sends the sound source list as a snapshot to a new subscriber
+  **/
+  void Server::sendSoundSourceSnapshot(const ros::SingleSubscriberPublisher& pub)
+  {
+    stdr_msgs::SoundSourceDelta snapshot;
+    snapshot.sequence = _soundSourceSequence;
+    snapshot.snapshot = true;
+    snapshot.added.reserve(_soundSourceMap.size());
+    for(SoundSourceMapIt it = _soundSourceMap.begin() 
+      ; it != _soundSourceMap.end() ; it++)
+    {
+      snapshot.added.push_back(it->second);
+    }
+    pub.publish(snapshot);
+  }
+  
   /**
   @brief Creates a marker message corresponding to every element of msg that is 
   independent of the source's specific type 